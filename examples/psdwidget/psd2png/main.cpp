@@ -34,7 +34,7 @@ static void printLayerInfo(QPsdWidgetTreeItemModel *model, const QModelIndex &pa
                     .arg(fillOpacity).arg(fillOpacity * 100 / 255);
             }
             if (verbose) {
-                const auto keys = info.keys();
+                const auto keys = record->aliKeyOrder();
                 qInfo().noquote() << indent + QString("  Additional info keys: %1").arg(QString::fromLatin1(keys.join(", ")));
             }
         }
@@ -856,7 +856,7 @@ static void collectLayerRecords(const LayerModel *model, const QModelIndex &pare
                 record.setFlags(0x00);
                 record.setName("</Layer group>");
 
-                QHash<QByteArray, QVariant> ali;
+                QPsdFourCCMap ali;
                 ali.insert("luni", u"</Layer group>"_s);
                 QPsdSectionDividerSetting sds;
                 sds.setType(QPsdSectionDividerSetting::BoundingSectionDivider);
@@ -890,7 +890,7 @@ static void collectLayerRecords(const LayerModel *model, const QModelIndex &pare
                 record.setFlags(layer->visible ? 0x00 : 0x02);
                 record.setName(layer->name.toUtf8());
 
-                QHash<QByteArray, QVariant> ali;
+                QPsdFourCCMap ali;
                 ali.insert("luni", layer->name);
                 QPsdSectionDividerSetting sds;
                 sds.setType(QPsdSectionDividerSetting::OpenFolder);
@@ -971,7 +971,7 @@ static void collectLayerRecords(const LayerModel *model, const QModelIndex &pare
                             : (layer->visible ? 0x00 : 0x02));
             record.setName(layer->name.toUtf8());
 
-            QHash<QByteArray, QVariant> ali;
+            QPsdFourCCMap ali;
             ali.insert("luni", layer->name);
 
             if (layer->type == Layer::TextLayer) {
@@ -1036,7 +1036,7 @@ static void collectLayerRecords(const LayerModel *model, const QModelIndex &pare
                     QPsdDescriptor textDesc;
                     textDesc.setName(u""_s);
                     textDesc.setClassID("TxLr");
-                    QHash<QByteArray, QVariant> textData;
+                    QPsdDescriptorData textData;
                     textData.insert("Txt ", run.text);
                     textData.insert("EngineData", edBytes);
                     textDesc.setData(textData);
@@ -1044,7 +1044,7 @@ static void collectLayerRecords(const LayerModel *model, const QModelIndex &pare
                     QPsdDescriptor warpDesc;
                     warpDesc.setName(u""_s);
                     warpDesc.setClassID("warp");
-                    QHash<QByteArray, QVariant> warpData;
+                    QPsdDescriptorData warpData;
                     QPsdEnum warpStyleEnum;
                     warpStyleEnum.setType("warpStyle");
                     warpStyleEnum.setValue("warpNone");
@@ -1076,7 +1076,7 @@ static void collectLayerRecords(const LayerModel *model, const QModelIndex &pare
                     QPsdDescriptor colorDesc;
                     colorDesc.setName(u""_s);
                     colorDesc.setClassID("RGBC");
-                    QHash<QByteArray, QVariant> colorData;
+                    QPsdDescriptorData colorData;
                     colorData.insert("Rd  ", layer->shapeFillColor.redF() * 255.0);
                     colorData.insert("Grn ", layer->shapeFillColor.greenF() * 255.0);
                     colorData.insert("Bl  ", layer->shapeFillColor.blueF() * 255.0);
@@ -1085,7 +1085,7 @@ static void collectLayerRecords(const LayerModel *model, const QModelIndex &pare
                     QPsdDescriptor socoDesc;
                     socoDesc.setName(u""_s);
                     socoDesc.setClassID("SoCo");
-                    QHash<QByteArray, QVariant> socoData;
+                    QPsdDescriptorData socoData;
                     socoData.insert("Clr ", QVariant::fromValue(colorDesc));
                     socoDesc.setData(socoData);
                     ali.insert("SoCo", QVariant::fromValue(socoDesc));
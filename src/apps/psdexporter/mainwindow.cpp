@@ -492,21 +492,26 @@ void MainWindow::Private::openFile(const QString &fileName)
         }
     }
 
-    // open the file as a new tab
-    QApplication::setOverrideCursor(Qt::WaitCursor);
+    // open the file as a new tab once it has been loaded
     auto viewer = new PsdWidget(q);
-    viewer->load(fileName);
-    QApplication::restoreOverrideCursor();
-    if (viewer->errorMessage().isEmpty()) {
+    connect(viewer, &PsdWidget::loaded, q, [this, viewer, fileName]() {
+        if (!viewer->errorMessage().isEmpty()) {
+            viewer->deleteLater();
+            return;
+        }
         int index = tabWidget->addTab(viewer, viewer->windowIcon(), viewer->windowTitle());
         connectViewer(viewer);
         tabWidget->setTabToolTip(index, fileName);
         tabWidget->setCurrentIndex(index);
         updateRecentFiles(fileName);
         updateFileMenus();
-    } else {
-        delete viewer;
-    }
+    }, Qt::SingleShotConnection);
+    connect(viewer, &PsdWidget::loadCanceled, q, [this, viewer]() {
+        // a canceled reload keeps the document that is already open
+        if (tabWidget->indexOf(viewer) < 0)
+            viewer->deleteLater();
+    });
+    viewer->load(fileName);
 }
 
 void MainWindow::Private::openProjectFile(const QString &fileName)
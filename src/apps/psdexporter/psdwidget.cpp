@@ -26,6 +26,7 @@
 #include <QtWidgets/QButtonGroup>
 #include <QtWidgets/QHeaderView>
 #include <QtWidgets/QLineEdit>
+#include <QtWidgets/QProgressDialog>
 #include <QtWidgets/QPushButton>
 #include <QtWidgets/QFileDialog>
 #include <QtWidgets/QMessageBox>
@@ -92,6 +93,7 @@ class PsdWidget::Private : public Ui::PsdWidget
 public:
     Private(::PsdWidget *parent);
 
+    void restoreViewState();
     void updateAttributes();
     void applyAttributes();
     void populateTextSourceCombo();
@@ -105,6 +107,8 @@ public:
     QString windowTitle;
     QComboBox *textSourceCombo = nullptr;
     QComboBox *imageSourceCombo = nullptr;
+    QProgressDialog *loadProgress = nullptr;
+    QFuture<QPsdParser> loadFuture;
 
 private:
     ::PsdWidget *q;
@@ -208,6 +212,11 @@ PsdWidget::Private::Private(::PsdWidget *parent)
         q->setWindowTitle(windowTitle);
     });
 
+    connect(&model, &PsdTreeItemModel::loadFinished, q, [this]() {
+        restoreViewState();
+        emit q->loaded();
+    });
+
     connect(psdView, &QPsdView::scaleChanged, q, &::PsdWidget::viewScaleChanged);
 
     updateAttributes();
@@ -447,6 +456,42 @@ private:
     T invalidValue;
 };
 
+void PsdWidget::Private::restoreViewState()
+{
+    treeView->reset();
+
+    q->restoreState(settings.value("splitterState").toByteArray());
+    treeView->header()->restoreState(settings.value("treeState").toByteArray());
+
+    // Ensure Use and Visible columns stay fixed after restoring state
+    auto *header = treeView->header();
+    header->setStretchLastSection(false);
+    header->setSectionResizeMode(PsdTreeItemModel::Name, QHeaderView::Stretch);
+    header->setSectionResizeMode(PsdTreeItemModel::Use, QHeaderView::Fixed);
+    header->resizeSection(PsdTreeItemModel::Use, 30);
+    header->setSectionResizeMode(PsdTreeItemModel::Visible, QHeaderView::Fixed);
+    header->resizeSection(PsdTreeItemModel::Visible, 30);
+
+    std::function<void(const QModelIndex &index)> traverseTreeView;
+    traverseTreeView = [&](const QModelIndex &index) {
+        if (model.hasChildren(index)) {
+            const auto lyid = model.layerId(index);
+            treeView->setExpanded(index, settings.value(u"%1-x"_s.arg(lyid), false).toBool());
+
+            for (int row = 0; row < model.rowCount(index); row++) {
+                traverseTreeView(model.index(row, 0, index));
+            }
+        }
+    };
+    traverseTreeView(treeView->rootIndex());
+
+    psdView->setModel(model.widgetModel());
+
+    // Restore view scale (default to 1.0 = 100%)
+    qreal scale = settings.value("viewScale", 1.0).toDouble();
+    q->setViewScale(scale);
+}
+
 void PsdWidget::Private::updateAttributes()
 {
     const auto rows = treeView->selectionModel()->selectedRows();
@@ -1056,50 +1101,40 @@ PsdWidget::~PsdWidget()
 
 void PsdWidget::load(const QString &fileName)
 {
-    d->model.load(fileName);
-    d->treeView->reset();
-
     d->settings.beginGroup(QCryptographicHash::hash(fileName.toUtf8(), QCryptographicHash::Md5));
-    restoreState(d->settings.value("splitterState").toByteArray());
-    d->treeView->header()->restoreState(d->settings.value("treeState").toByteArray());
 
-    // Ensure Use and Visible columns stay fixed after restoring state
-    auto *header = d->treeView->header();
-    header->setStretchLastSection(false);
-    header->setSectionResizeMode(PsdTreeItemModel::Name, QHeaderView::Stretch);
-    header->setSectionResizeMode(PsdTreeItemModel::Use, QHeaderView::Fixed);
-    header->resizeSection(PsdTreeItemModel::Use, 30);
-    header->setSectionResizeMode(PsdTreeItemModel::Visible, QHeaderView::Fixed);
-    header->resizeSection(PsdTreeItemModel::Visible, 30);
-
-    std::function<void(const QModelIndex &index)> traverseTreeView;
-    traverseTreeView = [&](const QModelIndex &index) {
-        if (d->model.hasChildren(index)) {
-            const auto lyid = d->model.layerId(index);
-            d->treeView->setExpanded(index, d->settings.value(u"%1-x"_s.arg(lyid), false).toBool());
-
-            for (int row = 0; row < d->model.rowCount(index); row++) {
-                traverseTreeView(d->model.index(row, 0, index));
-            }
-        }
-    };
-    traverseTreeView(d->treeView->rootIndex());
-
-    d->psdView->setModel(d->model.widgetModel());
+    d->loadFuture = d->model.loadAsync(fileName);
+    if (!d->loadFuture.isValid()) {
+        emit loaded();
+        return;
+    }
 
-    // Restore view scale (default to 1.0 = 100%)
-    qreal scale = d->settings.value("viewScale", 1.0).toDouble();
-    setViewScale(scale);
+    // One dialog serves every load, so its connections are made only once
+    if (!d->loadProgress) {
+        d->loadProgress = new QProgressDialog(window());
+        d->loadProgress->setWindowModality(Qt::WindowModal);
+        d->loadProgress->setMinimumDuration(500);
+        d->loadProgress->setCancelButtonText(tr("Cancel"));
+        connect(&d->model, &PsdTreeItemModel::loadProgress, d->loadProgress, [this](int value, int maximum) {
+            d->loadProgress->setMaximum(maximum);
+            d->loadProgress->setValue(value);
+        });
+        connect(&d->model, &PsdTreeItemModel::loadFinished, d->loadProgress, &QProgressDialog::reset);
+        connect(d->loadProgress, &QProgressDialog::canceled, this, [this]() {
+            d->loadFuture.cancel();
+            emit loadCanceled();
+        });
+    }
+    d->loadProgress->setLabelText(tr("Loading %1...").arg(QFileInfo(fileName).fileName()));
+    d->loadProgress->setRange(0, 0);
+    d->loadProgress->setValue(0);
 }
 
 void PsdWidget::reload()
 {
-    QApplication::setOverrideCursor(Qt::WaitCursor);
     save();
     d->settings.endGroup();
     load(d->model.fileName());
-    d->treeView->reset();
-    QApplication::restoreOverrideCursor();
 }
 
 void PsdWidget::save()
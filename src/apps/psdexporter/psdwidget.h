@@ -55,6 +55,9 @@ private slots:
     void setErrorMessage(const QString &errorMessage);
 
 signals:
+    // load() has finished, check errorMessage() for the result
+    void loaded();
+    void loadCanceled();
     void errorOccurred(const QString &errorMessage);
     void selectionInfoChanged(const QString &info);
     void viewScaleChanged(qreal scale);
@@ -12,7 +12,8 @@ class QPsdAdditionalLayerInformationAnnoPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "anno.json")
 public:
     // Annotations (Photoshop 6.0)
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "Anno");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length <= 3);
         });
@@ -56,7 +57,7 @@ public:
                 if (dataLength > 2) {
                     const quint16 bom = (rawData[0] << 8) + rawData[1];
                     if (bom == 0xfeff) {
-                        static QStringDecoder decoder(QStringDecoder::Utf16BE);
+                        QStringDecoder decoder(QStringDecoder::Utf16BE);
                         const auto data = decoder.decode(rawData);
                         Q_UNUSED(data);
                     } else {
@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationBlncPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "blnc.json")
 public:
     // Color Balance
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "blnc");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length <= 3);
         });
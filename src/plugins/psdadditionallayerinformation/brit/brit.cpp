@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationBritPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "brit.json")
 public:
     // Brightness/Contrast
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "brit");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
@@ -11,7 +11,8 @@ class QPsdAdditionalLayerInformationBrstPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "brst.json")
 public:
     // Channel blending restrictions setting
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "brst");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
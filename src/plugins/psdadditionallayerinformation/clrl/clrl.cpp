@@ -12,7 +12,8 @@ class QPsdAdditionalLayerInformationClrlPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "clrl.json")
 public:
     // Color Lookup (Photoshop CS6)
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "clrL");
         auto cleanup = qScopeGuard([&] {
             // Q_ASSERT(length == 0);
         });
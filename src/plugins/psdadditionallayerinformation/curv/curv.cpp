@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationCurvPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "curv.json")
 public:
     // Curve
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "curv");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length <= 3);
         });
@@ -10,7 +10,8 @@ class QPsdAdditionalLayerInformationDataPlugin : public QPsdAdditionalLayerInfor
     Q_OBJECT
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "data.json")
 public:
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "Txt2");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
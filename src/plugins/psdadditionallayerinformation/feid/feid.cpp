@@ -11,7 +11,8 @@ class QPsdAdditionalLayerInformationFeidPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "feid.json")
 public:
     // Filter Effect
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_UNUSED(key);
         // Save raw bytes for lossless round-trip
         const QByteArray rawData = source->read(length);
         length = 0;
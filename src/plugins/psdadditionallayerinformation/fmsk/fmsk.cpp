@@ -15,7 +15,8 @@ class QPsdAdditionalLayerInformationFMskPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "fmsk.json")
 public:
     // Filter Mask (Photoshop CS3)
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "FMsk");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationGrdmPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "grdm.json")
 public:
     // Gradient Map
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "grdm");
         auto cleanup = qScopeGuard([&] {
             if (length > 0)
                 skip(source, length, &length);
@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationHue2Plugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "hue2.json")
 public:
     // New Hue/saturation, Photoshop 5.0
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "hue2");
         auto cleanup = qScopeGuard([&] {
             if (length > 3)
                 qWarning("hue2: %u bytes remaining after parse", length);
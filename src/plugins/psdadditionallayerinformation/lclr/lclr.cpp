@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationLclrPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "lclr.json")
 public:
     // Sheet Color setting
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "lclr");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationLevlPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "levl.json")
 public:
     // Levels
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "levl");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
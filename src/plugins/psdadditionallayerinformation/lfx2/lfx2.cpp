@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationLfx2Plugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "lfx2.json")
 public:
     // Object Based Effects Layer info
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_UNUSED(key);
         auto cleanup = qScopeGuard([&] {
             // Q_ASSERT(length == 0);
         });
@@ -11,7 +11,8 @@ class QPsdAdditionalLayerInformationLMskPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "lmsk.json")
 public:
     // User Mask
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "LMsk");
         // Save raw bytes for lossless round-trip
         const QByteArray rawData = source->read(length);
         length = 0;
@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationLnk_Plugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "lnk_.json")
 public:
     // Linked Layer
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_UNUSED(key);
         // Save raw bytes for lossless round-trip
         const qint64 startPos = source->pos();
         const quint32 totalLength = length;
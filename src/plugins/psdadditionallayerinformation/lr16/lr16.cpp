@@ -12,7 +12,12 @@ class QPsdAdditionalLayerInformationLr16Plugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "lr16.json")
 public:
     // Color Balance
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_UNUSED(key);
+        // Layer info of 16 and 32-bit documents, including the layers' pixels
+        if (readOptions(source).testFlag(SkipChannelData))
+            return {};
+
         // Preserve raw bytes for round-trip since full serialization is not implemented
         QByteArray rawData;
         if (length > 0)
@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationLrFXPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "lrfx.json")
 public:
     // Effects Layer info
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "lrFX");
         // Save raw bytes for lossless round-trip
         const qint64 startPos = source->pos();
         const quint32 totalLength = length;
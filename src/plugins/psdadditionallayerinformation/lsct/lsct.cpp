@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationLsctPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "lsct.json")
 public:
     // Section Divider setting
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "lsct");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationLsdkPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "lsdk.json")
 public:
     // Section Divider setting (nested layer structure)
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "lsdk");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
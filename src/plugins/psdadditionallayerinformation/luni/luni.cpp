@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationLuniPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "luni.json")
 public:
     // Unicode Layer name
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "luni");
         auto cleanup = qScopeGuard([&] {
             if (length == 2)
                 skip(source, 2, &length); // a two byte null for the end of the string.
@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationMixrPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "mixr.json")
 public:
     // Channel Mixer
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "mixr");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length <= 3);
         });
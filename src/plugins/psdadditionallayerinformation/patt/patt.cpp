@@ -16,20 +16,21 @@ class QPsdAdditionalLayerInformationPattPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "patt.json")
 public:
     // Patterns (Photoshop 6.0 and CS (8.0))
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_UNUSED(key);
         auto cleanup = qScopeGuard([&] {
             if (length > 3)
                 qWarning("patt: %u bytes remaining after parse", length);
         });
 
-        // Save raw bytes for lossless round-trip (must be done before any parsing)
+        // Keep the raw bytes for lossless round-trip (must be done before any
+        // parsing). For mapped documents this refers to the file, no copy.
         const qint64 startPos = source->pos();
-        const quint32 totalLength = length;
-        const QByteArray rawBytes = source->read(totalLength);
+        const QPsdByteSlice rawBytes = readByteSlice(source, length);
         source->seek(startPos);
 
         QVariantHash result;
-        result.insert(u"__rawData__"_s, rawBytes);
+        result.insert(u"__rawData__"_s, QVariant::fromValue(rawBytes));
 
         // The following is repeated for each pattern.
         while (length > 20) {
@@ -151,27 +152,7 @@ public:
                     if (compression == 1) {
                         // RLE (PackBits) decompression
                         // Format: height row byte counts (2 bytes each) + packed data
-                        QBuffer buffer(&compressedData);
-                        buffer.open(QIODevice::ReadOnly);
-                        const int h = channelRect.height();
-                        quint32 bufLen = compressedData.size();
-                        QList<qint16> byteCounts;
-                        for (int y = 0; y < h; y++) {
-                            byteCounts.append(readS16(&buffer, &bufLen));
-                        }
-                        for (qint16 byteCount : std::as_const(byteCounts)) {
-                            EnsureSeek es(&buffer, byteCount);
-                            while (es.bytesAvailable() > 0) {
-                                auto sz = readS8(&buffer, &bufLen);
-                                if (sz == -128) {
-                                    // ignore
-                                } else if (sz < 0) {
-                                    channelData.append(-sz + 1, readByteArray(&buffer, 1, &bufLen).at(0));
-                                } else {
-                                    channelData.append(readByteArray(&buffer, sz + 1, &bufLen));
-                                }
-                            }
-                        }
+                        channelData = decodePackBits(compressedData, channelRect.height());
                     } else if (compression == 0) {
                         // Raw uncompressed data
                         channelData = compressedData;
@@ -273,10 +254,11 @@ public:
     QByteArray serialize(const QVariant &data) const override {
         const auto hash = data.value<QVariantHash>();
 
-        // Use raw bytes for lossless round-trip if available
-        const auto rawData = hash.value(u"__rawData__"_s).toByteArray();
+        // Use raw bytes for lossless round-trip if available. QPsdWriter
+        // writes them straight from the slice and does not get here.
+        const auto rawData = hash.value(u"__rawData__"_s).value<QPsdByteSlice>();
         if (!rawData.isEmpty())
-            return rawData;
+            return rawData.toByteArray();
 
         QByteArray result;
         QBuffer output(&result);
@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationPhflPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "phfl.json")
 public:
     // Photo Filter
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "phfl");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length <= 3);
         });
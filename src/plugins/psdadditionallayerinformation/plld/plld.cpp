@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationPlLdPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "plld.json")
 public:
     // Placed Layer (replaced by SoLd in Photoshop CS3)
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "PlLd");
         // Save raw bytes for lossless round-trip
         const qint64 startPos = source->pos();
         const quint32 totalLength = length;
@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationQpointFPlugin : public QPsdAdditionalLayerIn
     Q_OBJECT
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "qpointf.json")
 public:
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "fxrp");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationSelcPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "selc.json")
 public:
     // Selective color
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "selc");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length <= 3);
         });
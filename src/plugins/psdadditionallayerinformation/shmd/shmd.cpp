@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationShmdPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "shmd.json")
 public:
     // Metadata setting
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "shmd");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
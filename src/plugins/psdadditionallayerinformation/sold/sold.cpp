@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationSoLdPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "sold.json")
 public:
     // Placed Layer (replaced by SoLd in Photoshop CS3)
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_UNUSED(key);
         // Save raw bytes for lossless round-trip
         const qint64 startPos = source->pos();
         const quint32 totalLength = length;
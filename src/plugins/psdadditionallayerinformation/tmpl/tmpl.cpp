@@ -7,7 +7,8 @@ class QPsdAdditionalLayerInformationTmplPlugin : public QPsdAdditionalLayerInfor
     Q_OBJECT
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "tmpl.json")
 public:
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "tmpl");
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
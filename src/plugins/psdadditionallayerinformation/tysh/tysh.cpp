@@ -14,7 +14,8 @@ class QPsdAdditionalLayerInformationTyShPlugin : public QPsdAdditionalLayerInfor
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "tysh.json")
 public:
     // Type tool object setting
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "TySh");
         auto cleanup = qScopeGuard([&] {
             // Q_ASSERT(length == 0);
         });
@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationU16Plugin : public QPsdAdditionalLayerInform
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "u16.json")
 public:
     // Layer ID
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_UNUSED(key);
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
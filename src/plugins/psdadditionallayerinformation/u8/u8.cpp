@@ -10,7 +10,8 @@ class QPsdAdditionalLayerInformationU8Plugin : public QPsdAdditionalLayerInforma
     Q_OBJECT
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "u8.json")
 public:
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_UNUSED(key);
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
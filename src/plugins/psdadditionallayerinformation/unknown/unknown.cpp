@@ -10,7 +10,8 @@ class QPsdAdditionalLayerInformationUnknownPlugin : public QPsdAdditionalLayerIn
     Q_OBJECT
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "unknown.json")
 public:
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_UNUSED(key);
         return readByteArray(source, length, &length);
     }
 };
@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationV16DescriptorPlugin : public QPsdAdditionalL
     Q_OBJECT
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "v16descriptor.json")
 public:
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_UNUSED(key);
         auto cleanup = qScopeGuard([&] {
             // Q_ASSERT(length == 0);
         });
@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationVogkPlugin : public QPsdAdditionalLayerInfor
     Q_OBJECT
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "vogk.json")
 public:
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "vogk");
         auto cleanup = qScopeGuard([&] {
             // Q_ASSERT(length == 0);
         });
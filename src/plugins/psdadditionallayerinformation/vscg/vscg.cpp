@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationVscgPlugin : public QPsdAdditionalLayerInfor
     Q_OBJECT
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "vscg.json")
 public:
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "vscg");
         return QVariant::fromValue(QPsdVectorStrokeContentSetting(source, length));
     }
 
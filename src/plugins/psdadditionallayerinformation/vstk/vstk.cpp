@@ -13,7 +13,8 @@ class QPsdAdditionalLayerInformationVstkPlugin : public QPsdAdditionalLayerInfor
     Q_OBJECT
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdAdditionalLayerInformationFactoryInterface" FILE "vstk.json")
 public:
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "vstk");
         return QVariant::fromValue(QPsdVectorStrokeData(source, length));
     }
 
@@ -9,7 +9,8 @@ class QPsdDescriptorLyidPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "lyid.json")
 public:
     // Layer ID
-    QVariant parse(QIODevice *source , quint32 length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 length) const override {
+        Q_ASSERT(key == "lyid");
         auto cleanup = qScopeGuard([&] {
             if (length == 2)
                 skip(source, 2, &length); // a two byte null for the end of the string.
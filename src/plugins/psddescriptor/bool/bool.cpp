@@ -11,7 +11,8 @@ class QPsdDescriptorBoolPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "bool.json")
 public:
     // Boolean
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "bool");
         return readU8(source, length) == 1;
     }
 };
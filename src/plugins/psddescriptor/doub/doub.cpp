@@ -11,7 +11,8 @@ class QPsdDescriptorDoubPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "doub.json")
 public:
         // Double
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "doub");
         return readDouble(source, length);
     }
 };
@@ -12,7 +12,8 @@ class QPsdDescriptorEnumPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "enum.json")
 public:
     // enum
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "enum");
         return QVariant::fromValue(QPsdEnum(source, length));
     }
 };
@@ -11,7 +11,8 @@ class QPsdDescriptorLongPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "long.json")
 public:
     // Integer
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "long");
         return readS32(source, length);
     }
 };
@@ -13,7 +13,8 @@ class QPsdDescriptorObArPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "obar.json")
 public:
     // Descriptor
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "ObAr");
         const auto version = readU32(source, length);
         Q_UNUSED(version);
         const auto name = readString(source, length);
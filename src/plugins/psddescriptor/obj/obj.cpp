@@ -12,7 +12,8 @@ class QPsdDescriptorObjPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "obj.json")
 public:
     // Descriptor
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "obj ");
         const auto count = readS32(source, length);
         QVariantList res;
         for (int i = 0; i < count; i++) {
@@ -12,7 +12,8 @@ class QPsdDescriptorObjcPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "objc.json")
 public:
     // Descriptor
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "Objc");
         return QVariant::fromValue(QPsdDescriptor(source, length));
     }
 };
@@ -13,7 +13,8 @@ class QPsdDescriptorPthPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "pth.json")
 public:
     // File Path
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "Pth ");
         const auto len = readU32(source, length);
         Q_UNUSED(len);
         const auto signature = readByteArray(source, 4, length);
@@ -13,7 +13,8 @@ class QPsdDescriptorTdtaPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "tdta.json")
 public:
     // Raw Data
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "tdta");
         auto size = readS32(source, length);
         qCDebug(lcQPsdDescriptorTdtaPlugin) << size;
         return readByteArray(source, size, length);
@@ -11,7 +11,8 @@ class QPsdDescriptorTextPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "text.json")
 public:
     // TEXT
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "TEXT");
         return readString(source, length);
     }
 };
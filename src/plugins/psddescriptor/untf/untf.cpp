@@ -12,7 +12,8 @@ class QPsdDescriptorUntFPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "untf.json")
 public:
     // Unit float
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "UntF");
         return QVariant::fromValue(QPsdUnitFloat(source, length));
     }
 };
@@ -11,7 +11,8 @@ class QPsdDescriptorVlLsPlugin : public QPsdDescriptorPlugin
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdDescriptorFactoryInterface" FILE "vlls.json")
 public:
     // List
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "VlLs");
         // Number of items in the list
         auto count = readS32(source, length);
         QVariantList ret;
@@ -20,7 +21,7 @@ public:
             QByteArray osType = readByteArray(source, 4, length);
             auto plugin = QPsdDescriptorPlugin::plugin(osType);
             if (plugin) {
-                auto value = plugin->parse(source, length);
+                auto value = plugin->parse(osType, source, length);
                 ret.append(value);
             } else {
                 qWarning() << osType << "not supported";
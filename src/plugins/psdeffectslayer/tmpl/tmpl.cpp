@@ -7,7 +7,8 @@ class QPsdEffectsLayerTmplPlugin : public QPsdEffectsLayerPlugin
     Q_OBJECT
     Q_PLUGIN_METADATA(IID "org.qt-project.Qt.QPsdEffectsLayerFactoryInterface" FILE "tmpl.json")
 public:
-    QVariant parse(QIODevice *source , quint32 *length) const override {
+    QVariant parse(QByteArrayView key, QIODevice *source , quint32 *length) const override {
+        Q_ASSERT(key == "tmpl");
         return QVariant();
     }
 };
@@ -141,7 +141,7 @@ bool QPsdExporterJsonPlugin::exportTo(const QPsdExporterTreeItemModel *model, co
             const auto tysh = additionalLayerInformation.value("TySh").value<QPsdTypeToolObjectSetting>();
             const auto textData = tysh.textData();
             const auto engineDataData = textData.data().value("EngineData").toByteArray();
-            const auto engineData = QPsdEngineDataParser::parseEngineData(engineDataData);
+            const auto engineData = QPsdEngineDataParser::parseEngineData(engineDataData, { "EngineDict"_ba });
 
             const auto engineDict = engineData.value("EngineDict"_L1).toMap();
 
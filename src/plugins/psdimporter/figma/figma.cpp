@@ -2398,7 +2398,7 @@ static void flattenFigmaTree(FigmaLayerTreeItemModel *figmaModel,
             QPsdLayerRecord closeRecord;
             closeRecord.setName(QByteArray("</Layer group>"));
             closeRecord.setFlags(0x00);
-            QHash<QByteArray, QVariant> closeALI;
+            QPsdFourCCMap closeALI;
             QPsdSectionDividerSetting closeSetting;
             closeSetting.setType(QPsdSectionDividerSetting::BoundingSectionDivider);
             closeALI["lsdk"] = QVariant::fromValue(closeSetting);
@@ -2415,7 +2415,7 @@ static void flattenFigmaTree(FigmaLayerTreeItemModel *figmaModel,
             folderRecord.setFlags(0x00);
             if (isClipped)
                 folderRecord.setClipping(QPsdLayerRecord::NonBase);
-            QHash<QByteArray, QVariant> folderALI;
+            QPsdFourCCMap folderALI;
             folderALI["lyid"] = layerId;
             folderALI["luni"] = name;
             QPsdSectionDividerSetting folderSetting;
@@ -2439,7 +2439,7 @@ static void flattenFigmaTree(FigmaLayerTreeItemModel *figmaModel,
             leafRecord.setFlags(isMask ? 0x02 : 0x00);
             if (isClipped)
                 leafRecord.setClipping(QPsdLayerRecord::NonBase);
-            QHash<QByteArray, QVariant> leafALI;
+            QPsdFourCCMap leafALI;
             leafALI["lyid"] = layerId;
             leafALI["luni"] = name;
             if (item->type() == QPsdAbstractLayerItem::Text)
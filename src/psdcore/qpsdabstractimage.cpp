@@ -2,10 +2,17 @@
 // SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qpsdabstractimage.h"
+#include "qpsdcolortransform.h"
 #include "qpsdfileheader.h"
+#include "qpsdparallel_p.h"
 
-#include <cmath>
+#include <limits>
 #include <QtEndian>
+#include <QtCore/private/qsimd_p.h>
+
+#ifdef QT_PSD_HAVE_ZLIB
+#include <zlib.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -86,42 +93,641 @@ void QPsdAbstractImage::setHeader(const QPsdFileHeader &header)
     d->header = header;
 }
 
-QByteArray QPsdAbstractImage::readRLE(QIODevice *source, int height, quint32 *length)
+QByteArray QPsdAbstractImage::readRLE(QIODevice *source, int height, int countSize, qint64 *length)
 {
-    QByteArray ret;
-    QList<qint16> byteCounts;
-    for (int y = 0; y < height; y++) {
-        byteCounts.append(readS16(source, length));
+    if (height <= 0)
+        return {};
+
+    // The byte count table and the scan lines are contiguous, so take them
+    // in one read and let decodePackBits() walk the buffer
+    // (**PSB** each count is stored as a four-byte value.)
+    const QByteArray counts = source->peek(qsizetype(height) * countSize);
+    quint64 size = counts.size();
+    for (qsizetype i = 0; i + countSize <= counts.size(); i += countSize) {
+        size += countSize == 4 ? qFromBigEndian<quint32>(counts.constData() + i)
+                               : qFromBigEndian<quint16>(counts.constData() + i);
+    }
+    size = qMin<quint64>(size, std::numeric_limits<qint64>::max());
+
+    const auto rleData = readByteSlice(source, qint64(size), length);
+    return decodePackBits(rleData.view(), height, countSize);
+}
+
+namespace {
+
+// Inflates a zlib stream straight into out and returns the number of bytes written
+qsizetype inflateInto(QByteArrayView data, uchar *out, qsizetype outSize)
+{
+#ifdef QT_PSD_HAVE_ZLIB
+    z_stream stream = {};
+    if (inflateInit(&stream) != Z_OK)
+        return 0;
+
+    // avail_in and avail_out are 32-bit, feed larger buffers in chunks
+    constexpr qsizetype maxChunk = std::numeric_limits<uInt>::max();
+    auto *in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+    qsizetype inLeft = data.size();
+    qsizetype outLeft = outSize;
+    stream.next_in = in;
+    stream.next_out = out;
+
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        if (stream.avail_in == 0) {
+            stream.avail_in = uInt(qMin(inLeft, maxChunk));
+            inLeft -= stream.avail_in;
+        }
+        if (stream.avail_out == 0) {
+            if (outLeft == 0)
+                break;
+            stream.avail_out = uInt(qMin(outLeft, maxChunk));
+            outLeft -= stream.avail_out;
+        }
+        ret = inflate(&stream, Z_NO_FLUSH);
+    }
+    if (ret != Z_STREAM_END && ret != Z_OK)
+        qWarning("inflate failed: %s", stream.msg ? stream.msg : "unknown error");
+    const qsizetype written = stream.next_out - out;
+    inflateEnd(&stream);
+    return written;
+#else
+    // qUncompress() wants the expected size in front of the stream
+    QByteArray zipData(sizeof(quint32) + data.size(), Qt::Uninitialized);
+    qToBigEndian<quint32>(quint32(outSize), zipData.data());
+    memcpy(zipData.data() + sizeof(quint32), data.data(), data.size());
+    const QByteArray inflated = qUncompress(zipData);
+    const qsizetype written = qMin(inflated.size(), outSize);
+    memcpy(out, inflated.constData(), written);
+    return written;
+#endif
+}
+
+// In-place prefix sum over n bytes, undoing byte-wise delta prediction
+void unpredict8(uchar *data, qsizetype n)
+{
+    qsizetype i = 0;
+#ifdef __SSE2__
+    __m128i carry = _mm_setzero_si128();
+    for (; i + 16 <= n; i += 16) {
+        auto *p = reinterpret_cast<__m128i *>(data + i);
+        __m128i v = _mm_loadu_si128(p);
+        v = _mm_add_epi8(v, _mm_slli_si128(v, 1));
+        v = _mm_add_epi8(v, _mm_slli_si128(v, 2));
+        v = _mm_add_epi8(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi8(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi8(v, carry);
+        _mm_storeu_si128(p, v);
+        carry = _mm_set1_epi8(char(data[i + 15]));
+    }
+#endif
+    for (i = qMax<qsizetype>(i, 1); i < n; ++i)
+        data[i] += data[i - 1];
+}
+
+// Same for n big-endian 16-bit samples; the result stays big-endian
+void unpredict16(uchar *data, qsizetype n)
+{
+    qsizetype i = 0;
+    quint16 previous = 0;
+#ifdef __SSE2__
+    const auto byteSwap = [](__m128i v) {
+        return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    };
+    __m128i carry = _mm_setzero_si128();
+    for (; i + 8 <= n; i += 8) {
+        auto *p = reinterpret_cast<__m128i *>(data + i * 2);
+        __m128i v = byteSwap(_mm_loadu_si128(p));
+        v = _mm_add_epi16(v, _mm_slli_si128(v, 2));
+        v = _mm_add_epi16(v, _mm_slli_si128(v, 4));
+        v = _mm_add_epi16(v, _mm_slli_si128(v, 8));
+        v = _mm_add_epi16(v, carry);
+        _mm_storeu_si128(p, byteSwap(v));
+        previous = quint16(_mm_extract_epi16(v, 7));
+        carry = _mm_set1_epi16(short(previous));
+    }
+#endif
+    for (; i < n; ++i) {
+        previous += qFromBigEndian<quint16>(data + i * 2);
+        qToBigEndian<quint16>(previous, data + i * 2);
+    }
+}
+
+// 32-bit rows are stored as four planes holding byte 0, 1, 2 and 3 of each
+// big-endian float, delta coded as one byte stream. Undo the delta, then
+// interleave the planes back into big-endian floats.
+void unpredict32(uchar *row, qsizetype width, uchar *scratch)
+{
+    unpredict8(row, width * 4);
+    memcpy(scratch, row, width * 4);
+    const uchar *p0 = scratch;
+    const uchar *p1 = p0 + width;
+    const uchar *p2 = p1 + width;
+    const uchar *p3 = p2 + width;
+    qsizetype x = 0;
+#ifdef __SSE2__
+    for (; x + 16 <= width; x += 16) {
+        const __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p0 + x));
+        const __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p1 + x));
+        const __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p2 + x));
+        const __m128i b3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p3 + x));
+        const __m128i lo01 = _mm_unpacklo_epi8(b0, b1);
+        const __m128i hi01 = _mm_unpackhi_epi8(b0, b1);
+        const __m128i lo23 = _mm_unpacklo_epi8(b2, b3);
+        const __m128i hi23 = _mm_unpackhi_epi8(b2, b3);
+        auto *out = reinterpret_cast<__m128i *>(row + x * 4);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(lo01, lo23));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo01, lo23));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi01, hi23));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi01, hi23));
+    }
+#endif
+    for (; x < width; ++x) {
+        row[x * 4 + 0] = p0[x];
+        row[x * 4 + 1] = p1[x];
+        row[x * 4 + 2] = p2[x];
+        row[x * 4 + 3] = p3[x];
     }
-    for (qint16 byteCount : byteCounts) {
-        EnsureSeek es(source, byteCount);
-        while (es.bytesAvailable() > 0) {
-            auto size = readS8(source, length);
-            if (size == -128) {
-                // ignore size == -128 for padding
-            } else if (size < 0) {
-                ret.append(-size + 1, readByteArray(source, 1, length).at(0));
-            } else if (size >= 0) {
-                ret.append(readByteArray(source, size + 1, length));
+}
+
+} // namespace
+
+QByteArray QPsdAbstractImage::decodeZip(QByteArrayView data, Compression compression, int width, int height, int depth)
+{
+    if (width <= 0 || height <= 0)
+        return {};
+    const qsizetype bytesPerRow = depth == 1 ? (qsizetype(width) + 7) / 8 : qsizetype(width) * (depth / 8);
+    QByteArray ret(bytesPerRow * height, Qt::Uninitialized);
+    auto *out = reinterpret_cast<uchar *>(ret.data());
+    const qsizetype written = inflateInto(data, out, ret.size());
+    if (written < ret.size()) {
+        qWarning("decodeZip: inflated %lld of %lld bytes", qlonglong(written), qlonglong(ret.size()));
+        memset(out + written, 0, ret.size() - written);
+    }
+
+    if (compression != ZipWithPrediction)
+        return ret;
+
+    // Every row is predicted separately, decode them in blocks of about 256 KiB
+    const qsizetype grainSize = qMax<qsizetype>(1, 256 * 1024 / qMax<qsizetype>(bytesPerRow, 1));
+    switch (depth) {
+    case 8:
+        psdParallelForBlocks(height, grainSize, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype y = begin; y < end; ++y)
+                unpredict8(out + y * bytesPerRow, bytesPerRow);
+        });
+        break;
+    case 16:
+        psdParallelForBlocks(height, grainSize, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype y = begin; y < end; ++y)
+                unpredict16(out + y * bytesPerRow, width);
+        });
+        break;
+    case 32:
+        psdParallelForBlocks(height, grainSize, [&](qsizetype begin, qsizetype end) {
+            QByteArray scratch(bytesPerRow, Qt::Uninitialized);
+            for (qsizetype y = begin; y < end; ++y)
+                unpredict32(out + y * bytesPerRow, width, reinterpret_cast<uchar *>(scratch.data()));
+        });
+        break;
+    default:
+        qWarning("decodeZip: prediction is not defined for depth %d", depth);
+        break;
+    }
+    return ret;
+}
+
+QByteArray QPsdAbstractImage::readZip(QIODevice *source, Compression compression, int width, int height, int depth, qint64 *length)
+{
+    const auto zipData = readByteSlice(source, *length, length);
+    return decodeZip(zipData.view(), compression, width, height, depth);
+}
+
+// Extracts rect out of planes stacked planes of width x height samples, stored
+// with the given compression. Only the scan lines inside rect are read, and RLE
+// lines are expanded from the first byte that is kept. ZIP streams have to be
+// inflated as a whole before they can be cropped.
+QByteArray QPsdAbstractImage::decodeRegion(QByteArrayView data, Compression compression, int width, int height,
+                                           int planes, int depth, int countSize, const QRect &rect)
+{
+    const QRect bounds = rect & QRect(0, 0, width, height);
+    if (bounds.isEmpty() || planes <= 0)
+        return {};
+
+    const auto bytesPerRow = [depth](qsizetype samples) {
+        return depth == 1 ? (samples + 7) / 8 : samples * (depth / 8);
+    };
+    const qsizetype rowBytes = bytesPerRow(width);
+    const qsizetype outRowBytes = bytesPerRow(bounds.width());
+    // 1-bit rows are cropped on whole bytes and shifted into place
+    const int bitShift = depth == 1 ? bounds.x() % 8 : 0;
+    const qsizetype skip = depth == 1 ? bounds.x() / 8 : bytesPerRow(bounds.x());
+    const qsizetype span = qMin(rowBytes - skip, outRowBytes + (bitShift ? 1 : 0));
+
+    QByteArray ret(outRowBytes * bounds.height() * planes, '\0');
+    auto *out = reinterpret_cast<uchar *>(ret.data());
+    const auto *in = reinterpret_cast<const uchar *>(data.data());
+
+    const auto emitRow = [&](const uchar *row, qsizetype available, uchar *dst) {
+        available = qMin(available, span);
+        if (!bitShift) {
+            memcpy(dst, row, qMin(available, outRowBytes));
+            return;
+        }
+        for (qsizetype i = 0; i < outRowBytes && i < available; ++i) {
+            const uchar next = i + 1 < available ? row[i + 1] : 0;
+            dst[i] = uchar(row[i] << bitShift) | uchar(next >> (8 - bitShift));
+        }
+    };
+
+    // Output line n is line bounds.top() + n % bounds.height() of plane n / bounds.height()
+    const qsizetype lines = qsizetype(bounds.height()) * planes;
+    const auto sourceLine = [&](qsizetype n) {
+        return (n / bounds.height()) * height + bounds.top() + n % bounds.height();
+    };
+
+    switch (compression) {
+    case RawData:
+        psdParallelForBlocks(lines, 64, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype n = begin; n < end; ++n) {
+                const qsizetype offset = sourceLine(n) * rowBytes + skip;
+                if (offset < data.size())
+                    emitRow(in + offset, data.size() - offset, out + n * outRowBytes);
             }
+        });
+        break;
+    case RLE: {
+        // The byte count table gives the input offset of every line
+        const qsizetype totalLines = qsizetype(height) * planes;
+        const qsizetype tableSize = totalLines * countSize;
+        if (data.size() < tableSize)
+            break;
+        QList<qsizetype> offsets(totalLines + 1);
+        offsets[0] = tableSize;
+        for (qsizetype i = 0; i < totalLines; ++i) {
+            const qsizetype count = countSize == 4 ? qsizetype(qFromBigEndian<quint32>(in + i * 4))
+                                                   : qsizetype(qFromBigEndian<quint16>(in + i * 2));
+            offsets[i + 1] = qMin(offsets.at(i) + count, data.size());
         }
+        psdParallelForBlocks(lines, 64, [&](qsizetype begin, qsizetype end) {
+            QByteArray scratch(span, Qt::Uninitialized);
+            auto *buffer = reinterpret_cast<uchar *>(scratch.data());
+            for (qsizetype n = begin; n < end; ++n) {
+                const qsizetype line = sourceLine(n);
+                const uchar *src = in + offsets.at(line);
+                const qsizetype size = offsets.at(line + 1) - offsets.at(line);
+                uchar *dst = out + n * outRowBytes;
+                if (!bitShift) {
+                    decodePackBits(src, size, skip, dst, outRowBytes);
+                } else {
+                    const qsizetype decoded = decodePackBits(src, size, skip, buffer, span);
+                    emitRow(buffer, decoded, dst);
+                }
+            }
+        });
+        break; }
+    case ZipWithPrediction:
+    case ZipWithoutPrediction: {
+        const QByteArray inflated = decodeZip(data, compression, width, height * planes, depth);
+        return decodeRegion(inflated, RawData, width, height, planes, depth, countSize, rect);
+    }
     }
     return ret;
 }
 
-QByteArray QPsdAbstractImage::readZip(QIODevice *source, quint32 *length)
+namespace {
+
+// Row kernels for toImage(). The planes hold width() samples per row in
+// channel order, 16 and 32-bit samples big-endian as stored in the file.
+
+// x / 255 rounded down, exact for x <= 0xff * 0xff
+inline uint div255(uint x)
+{
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+// Same for x <= 0xffff * 0xff
+inline uint div255Wide(uint x)
+{
+    return (x + 1 + ((x + 1 + (x >> 8)) >> 8)) >> 8;
+}
+
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+QT_FUNCTION_TARGET(AVX2)
+qsizetype interleave8x4_avx2(const uchar *p0, const uchar *p1, const uchar *p2, const uchar *p3,
+                             uchar *dst, qsizetype n, uint opacity, bool invert)
+{
+    // No lambdas here, they would not inherit the target of the function
+    const __m256i mask = _mm256_set1_epi8(invert ? char(0xff) : 0);
+    const __m256i o = _mm256_set1_epi16(short(opacity));
+    const __m256i one = _mm256_set1_epi16(1);
+    const __m256i zero = _mm256_setzero_si256();
+    qsizetype x = 0;
+    for (; x + 32 <= n; x += 32) {
+        const __m256i v0 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p0 + x)), mask);
+        const __m256i v1 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p1 + x)), mask);
+        const __m256i v2 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p2 + x)), mask);
+        __m256i v3 = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(p3 + x)), mask);
+        if (opacity < 0xff) {
+            __m256i lo = _mm256_mullo_epi16(_mm256_unpacklo_epi8(v3, zero), o);
+            __m256i hi = _mm256_mullo_epi16(_mm256_unpackhi_epi8(v3, zero), o);
+            lo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(lo, one), _mm256_srli_epi16(lo, 8)), 8);
+            hi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_add_epi16(hi, one), _mm256_srli_epi16(hi, 8)), 8);
+            // packus works per 128-bit lane, like the unpacks, so the
+            // bytes end up where they were
+            v3 = _mm256_packus_epi16(lo, hi);
+        }
+        const __m256i lo01 = _mm256_unpacklo_epi8(v0, v1);
+        const __m256i hi01 = _mm256_unpackhi_epi8(v0, v1);
+        const __m256i lo23 = _mm256_unpacklo_epi8(v2, v3);
+        const __m256i hi23 = _mm256_unpackhi_epi8(v2, v3);
+        // Pixels 0-3 | 16-19, 4-7 | 20-23, 8-11 | 24-27 and 12-15 | 28-31
+        const __m256i q0 = _mm256_unpacklo_epi16(lo01, lo23);
+        const __m256i q1 = _mm256_unpackhi_epi16(lo01, lo23);
+        const __m256i q2 = _mm256_unpacklo_epi16(hi01, hi23);
+        const __m256i q3 = _mm256_unpackhi_epi16(hi01, hi23);
+        auto *out = reinterpret_cast<__m256i *>(dst + x * 4);
+        _mm256_storeu_si256(out + 0, _mm256_permute2x128_si256(q0, q1, 0x20));
+        _mm256_storeu_si256(out + 1, _mm256_permute2x128_si256(q2, q3, 0x20));
+        _mm256_storeu_si256(out + 2, _mm256_permute2x128_si256(q0, q1, 0x31));
+        _mm256_storeu_si256(out + 3, _mm256_permute2x128_si256(q2, q3, 0x31));
+    }
+    return x;
+}
+#endif
+
+// Interleaves four 8-bit planes into 4-byte pixels, optionally inverting
+// every sample, and scales the last one by opacity / 255
+void interleave8x4(const uchar *p0, const uchar *p1, const uchar *p2, const uchar *p3,
+                   uchar *dst, qsizetype n, uint opacity, bool invert)
+{
+    qsizetype x = 0;
+#if QT_COMPILER_SUPPORTS_HERE(AVX2)
+    if (qCpuHasFeature(AVX2))
+        x = interleave8x4_avx2(p0, p1, p2, p3, dst, n, opacity, invert);
+#endif
+#ifdef __SSE2__
+    const __m128i mask = _mm_set1_epi8(invert ? char(0xff) : 0);
+    const __m128i o = _mm_set1_epi16(short(opacity));
+    const __m128i one = _mm_set1_epi16(1);
+    const __m128i zero = _mm_setzero_si128();
+    const auto scale = [&](__m128i v) {
+        v = _mm_mullo_epi16(v, o);
+        v = _mm_add_epi16(_mm_add_epi16(v, one), _mm_srli_epi16(v, 8));
+        return _mm_srli_epi16(v, 8);
+    };
+    const auto load = [](const uchar *p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    };
+    for (; x + 16 <= n; x += 16) {
+        const __m128i v0 = _mm_xor_si128(load(p0 + x), mask);
+        const __m128i v1 = _mm_xor_si128(load(p1 + x), mask);
+        const __m128i v2 = _mm_xor_si128(load(p2 + x), mask);
+        __m128i v3 = _mm_xor_si128(load(p3 + x), mask);
+        if (opacity < 0xff)
+            v3 = _mm_packus_epi16(scale(_mm_unpacklo_epi8(v3, zero)), scale(_mm_unpackhi_epi8(v3, zero)));
+        const __m128i lo01 = _mm_unpacklo_epi8(v0, v1);
+        const __m128i hi01 = _mm_unpackhi_epi8(v0, v1);
+        const __m128i lo23 = _mm_unpacklo_epi8(v2, v3);
+        const __m128i hi23 = _mm_unpackhi_epi8(v2, v3);
+        auto *out = reinterpret_cast<__m128i *>(dst + x * 4);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(lo01, lo23));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo01, lo23));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(hi01, hi23));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(hi01, hi23));
+    }
+#elif defined(__ARM_NEON__)
+    const uint8x16_t mask = vdupq_n_u8(invert ? 0xff : 0);
+    const uint8x8_t o = vdup_n_u8(uchar(opacity));
+    const auto scale = [](uint16x8_t v) {
+        v = vaddq_u16(vaddq_u16(v, vdupq_n_u16(1)), vshrq_n_u16(v, 8));
+        return vshrn_n_u16(v, 8);
+    };
+    for (; x + 16 <= n; x += 16) {
+        uint8x16x4_t v;
+        v.val[0] = veorq_u8(vld1q_u8(p0 + x), mask);
+        v.val[1] = veorq_u8(vld1q_u8(p1 + x), mask);
+        v.val[2] = veorq_u8(vld1q_u8(p2 + x), mask);
+        v.val[3] = veorq_u8(vld1q_u8(p3 + x), mask);
+        if (opacity < 0xff) {
+            v.val[3] = vcombine_u8(scale(vmull_u8(vget_low_u8(v.val[3]), o)),
+                                   scale(vmull_u8(vget_high_u8(v.val[3]), o)));
+        }
+        vst4q_u8(dst + x * 4, v);
+    }
+#endif
+    const uchar m = invert ? 0xff : 0;
+    for (; x < n; ++x) {
+        dst[x * 4 + 0] = p0[x] ^ m;
+        dst[x * 4 + 1] = p1[x] ^ m;
+        dst[x * 4 + 2] = p2[x] ^ m;
+        const uchar v3 = p3[x] ^ m;
+        dst[x * 4 + 3] = opacity < 0xff ? uchar(div255(v3 * opacity)) : v3;
+    }
+}
+
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3)
+QT_FUNCTION_TARGET(SSSE3)
+qsizetype interleave8x3_ssse3(const uchar *p0, const uchar *p1, const uchar *p2, uchar *dst, qsizetype n)
+{
+    // Each 16-byte output block takes its bytes from the three planes with
+    // one shuffle per plane; -1 leaves a byte to the other planes
+    const __m128i s00 = _mm_setr_epi8(0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1, 5);
+    const __m128i s01 = _mm_setr_epi8(-1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1, -1);
+    const __m128i s02 = _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1);
+    const __m128i s10 = _mm_setr_epi8(-1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10, -1);
+    const __m128i s11 = _mm_setr_epi8(5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1, 10);
+    const __m128i s12 = _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, 8, -1, -1, 9, -1, -1);
+    const __m128i s20 = _mm_setr_epi8(-1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1, -1);
+    const __m128i s21 = _mm_setr_epi8(-1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15, -1);
+    const __m128i s22 = _mm_setr_epi8(10, -1, -1, 11, -1, -1, 12, -1, -1, 13, -1, -1, 14, -1, -1, 15);
+    qsizetype x = 0;
+    for (; x + 16 <= n; x += 16) {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p0 + x));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p1 + x));
+        const __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p2 + x));
+        auto *out = reinterpret_cast<__m128i *>(dst + x * 3);
+        _mm_storeu_si128(out + 0, _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, s00), _mm_shuffle_epi8(v1, s01)),
+                                               _mm_shuffle_epi8(v2, s02)));
+        _mm_storeu_si128(out + 1, _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, s10), _mm_shuffle_epi8(v1, s11)),
+                                               _mm_shuffle_epi8(v2, s12)));
+        _mm_storeu_si128(out + 2, _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(v0, s20), _mm_shuffle_epi8(v1, s21)),
+                                               _mm_shuffle_epi8(v2, s22)));
+    }
+    return x;
+}
+#endif
+
+// Interleaves three 8-bit planes into 3-byte pixels
+void interleave8x3(const uchar *p0, const uchar *p1, const uchar *p2, uchar *dst, qsizetype n)
+{
+    qsizetype x = 0;
+#if QT_COMPILER_SUPPORTS_HERE(SSSE3)
+    if (qCpuHasFeature(SSSE3))
+        x = interleave8x3_ssse3(p0, p1, p2, dst, n);
+#elif defined(__ARM_NEON__)
+    for (; x + 16 <= n; x += 16) {
+        uint8x16x3_t v;
+        v.val[0] = vld1q_u8(p0 + x);
+        v.val[1] = vld1q_u8(p1 + x);
+        v.val[2] = vld1q_u8(p2 + x);
+        vst3q_u8(dst + x * 3, v);
+    }
+#endif
+    for (; x < n; ++x) {
+        dst[x * 3 + 0] = p0[x];
+        dst[x * 3 + 1] = p1[x];
+        dst[x * 3 + 2] = p2[x];
+    }
+}
+
+// Keeps the high byte of n big-endian 16-bit samples
+void narrow16(const uchar *src, uchar *dst, qsizetype n)
+{
+    qsizetype x = 0;
+#ifdef __SSE2__
+    const __m128i high = _mm_set1_epi16(0xff);
+    for (; x + 16 <= n; x += 16) {
+        const __m128i v0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 2));
+        const __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + x * 2 + 16));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + x),
+                         _mm_packus_epi16(_mm_and_si128(v0, high), _mm_and_si128(v1, high)));
+    }
+#elif defined(__ARM_NEON__)
+    for (; x + 16 <= n; x += 16)
+        vst1q_u8(dst + x, vld2q_u8(src + x * 2).val[0]);
+#endif
+    for (; x < n; ++x)
+        dst[x] = src[x * 2];
+}
+
+// Interleaves three or four big-endian 16-bit planes into native 16-bit
+// pixels. The fourth sample is scaled by opacity / 255, or 0xffff if p3 is null.
+void interleave16x4(const uchar *p0, const uchar *p1, const uchar *p2, const uchar *p3,
+                    quint16 *dst, qsizetype n, uint opacity)
 {
-    quint32 beLength = qToBigEndian(*length);
-    QByteArray zipData = readByteArray(source, *length, length);
-    zipData.prepend(reinterpret_cast<char *>(&beLength), sizeof(quint32));
+    qsizetype x = 0;
+#ifdef __SSE2__
+    const auto load = [](const uchar *p) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+    };
+    const __m128i o = _mm_set1_epi16(short(opacity));
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i bias = _mm_set1_epi32(0x8000);
+    const auto scale = [&](__m128i v) {
+        const __m128i t = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(v, one), _mm_srli_epi32(v, 8)), 8);
+        v = _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(v, one), t), 8);
+        // packs saturates signed, move the range down and back up around it
+        return _mm_sub_epi32(v, bias);
+    };
+    for (; x + 8 <= n; x += 8) {
+        const __m128i v0 = load(p0 + x * 2);
+        const __m128i v1 = load(p1 + x * 2);
+        const __m128i v2 = load(p2 + x * 2);
+        __m128i v3 = p3 ? load(p3 + x * 2) : _mm_set1_epi16(-1);
+        if (p3 && opacity < 0xff) {
+            const __m128i lo = _mm_mullo_epi16(v3, o);
+            const __m128i hi = _mm_mulhi_epu16(v3, o);
+            v3 = _mm_packs_epi32(scale(_mm_unpacklo_epi16(lo, hi)), scale(_mm_unpackhi_epi16(lo, hi)));
+            v3 = _mm_xor_si128(v3, _mm_set1_epi16(short(0x8000)));
+        }
+        const __m128i lo01 = _mm_unpacklo_epi16(v0, v1);
+        const __m128i hi01 = _mm_unpackhi_epi16(v0, v1);
+        const __m128i lo23 = _mm_unpacklo_epi16(v2, v3);
+        const __m128i hi23 = _mm_unpackhi_epi16(v2, v3);
+        auto *out = reinterpret_cast<__m128i *>(dst + x * 4);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi32(lo01, lo23));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi32(lo01, lo23));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi32(hi01, hi23));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi32(hi01, hi23));
+    }
+#elif defined(__ARM_NEON__)
+    if (!p3 || opacity == 0xff) {
+        const auto load = [](const uchar *p) {
+            return vreinterpretq_u16_u8(vrev16q_u8(vld1q_u8(p)));
+        };
+        for (; x + 8 <= n; x += 8) {
+            uint16x8x4_t v;
+            v.val[0] = load(p0 + x * 2);
+            v.val[1] = load(p1 + x * 2);
+            v.val[2] = load(p2 + x * 2);
+            v.val[3] = p3 ? load(p3 + x * 2) : vdupq_n_u16(0xffff);
+            vst4q_u16(dst + x * 4, v);
+        }
+    }
+#endif
+    for (; x < n; ++x) {
+        dst[x * 4 + 0] = qFromBigEndian<quint16>(p0 + x * 2);
+        dst[x * 4 + 1] = qFromBigEndian<quint16>(p1 + x * 2);
+        dst[x * 4 + 2] = qFromBigEndian<quint16>(p2 + x * 2);
+        if (!p3)
+            dst[x * 4 + 3] = 0xffff;
+        else if (opacity < 0xff)
+            dst[x * 4 + 3] = quint16(div255Wide(qFromBigEndian<quint16>(p3 + x * 2) * opacity));
+        else
+            dst[x * 4 + 3] = qFromBigEndian<quint16>(p3 + x * 2);
+    }
+}
 
-    return qUncompress(zipData);
+// Converts three or four planes of big-endian floats to native 16-bit
+// pixels, clamped to [0, 1]. The fourth sample is multiplied by alphaScale
+// first, or 0xffff if p3 is null.
+void interleaveFloat(const uchar *p0, const uchar *p1, const uchar *p2, const uchar *p3,
+                     quint16 *dst, qsizetype n, float alphaScale)
+{
+    qsizetype x = 0;
+#ifdef __SSE2__
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 max = _mm_set1_ps(65535.0f);
+    const __m128i bias = _mm_set1_epi32(0x8000);
+    // Swaps the bytes, then clamps like qBound(), which also turns NaN into 1
+    const auto load = [&](const uchar *p, __m128 factor) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_or_si128(_mm_slli_epi32(v, 16), _mm_srli_epi32(v, 16));
+        const __m128 f = _mm_max_ps(_mm_min_ps(_mm_mul_ps(_mm_castsi128_ps(v), factor), one), zero);
+        return _mm_sub_epi32(_mm_cvttps_epi32(_mm_mul_ps(f, max)), bias);
+    };
+    const __m128 a = _mm_set1_ps(alphaScale);
+    for (; x + 4 <= n; x += 4) {
+        const __m128i v0 = load(p0 + x * 4, one);
+        const __m128i v1 = load(p1 + x * 4, one);
+        const __m128i v2 = load(p2 + x * 4, one);
+        const __m128i v3 = p3 ? load(p3 + x * 4, a) : _mm_set1_epi32(0x7fff);
+        const __m128i flip = _mm_set1_epi16(short(0x8000));
+        // r0-3 g0-3 and b0-3 a0-3
+        const __m128i v01 = _mm_xor_si128(_mm_packs_epi32(v0, v1), flip);
+        const __m128i v23 = _mm_xor_si128(_mm_packs_epi32(v2, v3), flip);
+        // r0 b0 r1 b1 r2 b2 r3 b3 and g0 a0 g1 a1 g2 a2 g3 a3
+        const __m128i lo = _mm_unpacklo_epi16(v01, v23);
+        const __m128i hi = _mm_unpackhi_epi16(v01, v23);
+        auto *out = reinterpret_cast<__m128i *>(dst + x * 4);
+        _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(lo, hi));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(lo, hi));
+    }
+#endif
+    const auto sample = [](const uchar *p, float factor) {
+        const quint32 bits = qFromBigEndian<quint32>(p);
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        return quint16(qBound(0.0f, value * factor, 1.0f) * 65535.0f);
+    };
+    for (; x < n; ++x) {
+        dst[x * 4 + 0] = sample(p0 + x * 4, 1.0f);
+        dst[x * 4 + 1] = sample(p1 + x * 4, 1.0f);
+        dst[x * 4 + 2] = sample(p2 + x * 4, 1.0f);
+        dst[x * 4 + 3] = p3 ? sample(p3 + x * 4, alphaScale) : 0xffff;
+    }
 }
 
+} // namespace
+
 QByteArray QPsdAbstractImage::toImage(QPsdFileHeader::ColorMode colorMode) const
 {
+    decodeChannels();
+
     QByteArray ret;
-    const auto size = width() * height();
     const auto bytesPerChannel = depth() / 8;
     switch (colorMode) {
     case QPsdFileHeader::Bitmap:
@@ -132,259 +738,20 @@ QByteArray QPsdAbstractImage::toImage(QPsdFileHeader::ColorMode colorMode) const
         // but we should verify it matches the expected size
         ret = imageData();
         break;
-    case QPsdFileHeader::RGB: {
-        auto pr = r();
-        auto pg = g();
-        auto pb = b();
-        auto pa = a();
-        double o = opacity();
-
-        if (bytesPerChannel == 0 || bytesPerChannel == 1) {
-            // 8-bit per channel
-            for (quint32 i = 0; i < size; i++) {
-                ret.append(*pb++);
-                ret.append(*pg++);
-                ret.append(*pr++);
-                if (pa) {
-                    ret.append(*pa++ * o / 0xff);
-                }
-            }
-        } else if (bytesPerChannel == 2) {
-            // 16-bit per channel
-            for (quint32 i = 0; i < size; i++) {
-                // Append 2 bytes for each channel
-                ret.append(reinterpret_cast<const char*>(pb), 2);
-                pb += 2;
-                ret.append(reinterpret_cast<const char*>(pg), 2);
-                pg += 2;
-                ret.append(reinterpret_cast<const char*>(pr), 2);
-                pr += 2;
-                if (pa) {
-                    // For 16-bit, we need to scale opacity differently
-                    quint16 alpha = *reinterpret_cast<const quint16*>(pa);
-                    alpha = static_cast<quint16>(alpha * o / 0xff);
-                    ret.append(reinterpret_cast<const char*>(&alpha), 2);
-                    pa += 2;
-                }
-            }
-        } else if (bytesPerChannel == 4) {
-            // 32-bit per channel (float) - PSD stores floats in big-endian
-            for (quint32 i = 0; i < size; i++) {
-                // Convert from big-endian to native endianness
-                quint32 bVal = qFromBigEndian<quint32>(pb);
-                quint32 gVal = qFromBigEndian<quint32>(pg);
-                quint32 rVal = qFromBigEndian<quint32>(pr);
-                ret.append(reinterpret_cast<const char*>(&bVal), 4);
-                pb += 4;
-                ret.append(reinterpret_cast<const char*>(&gVal), 4);
-                pg += 4;
-                ret.append(reinterpret_cast<const char*>(&rVal), 4);
-                pr += 4;
-                if (pa) {
-                    quint32 aVal = qFromBigEndian<quint32>(pa);
-                    float alpha;
-                    memcpy(&alpha, &aVal, 4);
-                    alpha = alpha * static_cast<float>(o / 0xff);
-                    ret.append(reinterpret_cast<const char*>(&alpha), 4);
-                    pa += 4;
-                }
-            }
-        } else {
-            qWarning() << "bytesPerChannel" << bytesPerChannel << "not supported";
-        }
-        break; }
-    case QPsdFileHeader::CMYK: {
-        if (bytesPerChannel == 1) {
-            auto pc = c();  // Channel 0 = Cyan
-            if (pc) {
-                auto pm = m();  // Channel 1 = Magenta
-                auto py = y();  // Channel 2 = Yellow
-                auto pk = k();  // Channel 3 = Black (K)
-
-                const auto size = width() * height();
-                for (quint32 i = 0; i < size; i++) {
-                    // CMYK order for QImage::Format_CMYK8888
-                    ret.append(255 - *pc++);  // C
-                    ret.append(255 - *pm++);  // M
-                    ret.append(255 - *py++);  // Y
-                    ret.append(255 - *pk++);  // K
-                }
-            } else {
-                // Fallback: single-channel data treated as grayscale CMYK
-                const auto data = imageData();
-                for (quint32 i = 0; i < size; i++) {
-                    quint8 value = static_cast<quint8>(data[i]);
-                    quint8 cmykValue = value ? 0 : 255;
-                    ret.append(cmykValue);  // C
-                    ret.append(cmykValue);  // M
-                    ret.append(cmykValue);  // Y
-                    ret.append(cmykValue);  // K
-                }
-            }
-        } else if (bytesPerChannel == 2) {
-            // 16-bit CMYK - convert to 8-bit
-            auto pc = c();  // Channel 0 = Cyan
-            auto pm = m();  // Channel 1 = Magenta
-            auto py = y();  // Channel 2 = Yellow
-            auto pk = k();  // Channel 3 = Black (K)
-
-            const auto size = width() * height();
-            for (quint32 i = 0; i < size; i++) {
-                // Read 16-bit values and convert to 8-bit
-                quint16 c16 = *reinterpret_cast<const quint16*>(pc);
-                quint16 m16 = *reinterpret_cast<const quint16*>(pm);
-                quint16 y16 = *reinterpret_cast<const quint16*>(py);
-                quint16 k16 = *reinterpret_cast<const quint16*>(pk);
-
-                // Convert 16-bit to 8-bit by taking high byte
-                // PSD stores CMYK inverted, so we need to invert back
-                ret.append(255 - (c16 >> 8));  // C
-                ret.append(255 - (m16 >> 8));  // M
-                ret.append(255 - (y16 >> 8));  // Y
-                ret.append(255 - (k16 >> 8));  // K
-
-                pc += 2;
-                pm += 2;
-                py += 2;
-                pk += 2;
-            }
-        } else {
-            qWarning() << "bytesPerChannel" << bytesPerChannel << "not supported";
-        }
-        break; }
+    case QPsdFileHeader::RGB:
+    case QPsdFileHeader::CMYK:
     case QPsdFileHeader::Lab: {
-        if (bytesPerChannel == 1) {
-            // 8-bit Lab
-            auto pL = b();  // Lightness channel
-            auto pa = r();     // a channel (green-red)
-            auto pb = g();     // b channel (blue-yellow)
-
-            const auto size = width() * height();
-            for (quint32 i = 0; i < size; i++) {
-                // Convert Lab to RGB
-                // L: 0-255 maps to 0-100
-                // a,b: 0-255 maps to -128 to +127 (128 is neutral)
-                float L = (*pL++) * 100.0f / 255.0f;
-                float a = (*pa++) - 128.0f;
-                float b = (*pb++) - 128.0f;
-
-                // Lab to XYZ conversion
-                float fy = (L + 16.0f) / 116.0f;
-                float fx = a / 500.0f + fy;
-                float fz = fy - b / 200.0f;
-
-                // Helper function for f^-1
-                auto finv = [](float t) -> float {
-                    const float delta = 6.0f / 29.0f;
-                    if (t > delta) {
-                        return t * t * t;
-                    } else {
-                        return 3.0f * delta * delta * (t - 4.0f / 29.0f);
-                    }
-                };
-
-                // D65 illuminant
-                const float Xn = 0.95047f;
-                const float Yn = 1.00000f;
-                const float Zn = 1.08883f;
-
-                float X = Xn * finv(fx);
-                float Y = Yn * finv(fy);
-                float Z = Zn * finv(fz);
-
-                // XYZ to RGB (sRGB matrix)
-                float R = 3.2404542f * X - 1.5371385f * Y - 0.4985314f * Z;
-                float G = -0.9692660f * X + 1.8760108f * Y + 0.0415560f * Z;
-                float B = 0.0556434f * X - 0.2040259f * Y + 1.0572252f * Z;
-
-                // Apply gamma correction and clamp
-                auto gammaCorrect = [](float c) -> quint8 {
-                    if (c <= 0.0031308f) {
-                        c = 12.92f * c;
-                    } else {
-                        c = 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
-                    }
-                    c = qBound(0.0f, c, 1.0f);
-                    return static_cast<quint8>(c * 255.0f);
-                };
-
-                ret.append(gammaCorrect(R));
-                ret.append(gammaCorrect(G));
-                ret.append(gammaCorrect(B));
-            }
-        } else if (bytesPerChannel == 2) {
-            // 16-bit Lab
-            auto pL = gray();  // Lightness channel
-            auto pa = r();     // a channel
-            auto pb = g();     // b channel
-
-            const auto size = width() * height();
-            for (quint32 i = 0; i < size; i++) {
-                // Read 16-bit values
-                quint16 L16 = *reinterpret_cast<const quint16*>(pL);
-                quint16 a16 = *reinterpret_cast<const quint16*>(pa);
-                quint16 b16 = *reinterpret_cast<const quint16*>(pb);
-
-                // Convert to 8-bit for now (can be improved later)
-                quint8 L8 = L16 >> 8;
-                quint8 a8 = a16 >> 8;
-                quint8 b8 = b16 >> 8;
-
-                // Convert Lab to RGB using same logic as 8-bit
-                float L = L8 * 100.0f / 255.0f;
-                float a = a8 - 128.0f;
-                float b = b8 - 128.0f;
-
-                // Lab to XYZ conversion
-                float fy = (L + 16.0f) / 116.0f;
-                float fx = a / 500.0f + fy;
-                float fz = fy - b / 200.0f;
-
-                // Helper function for f^-1
-                auto finv = [](float t) -> float {
-                    const float delta = 6.0f / 29.0f;
-                    if (t > delta) {
-                        return t * t * t;
-                    } else {
-                        return 3.0f * delta * delta * (t - 4.0f / 29.0f);
-                    }
-                };
-
-                // D65 illuminant
-                const float Xn = 0.95047f;
-                const float Yn = 1.00000f;
-                const float Zn = 1.08883f;
-
-                float X = Xn * finv(fx);
-                float Y = Yn * finv(fy);
-                float Z = Zn * finv(fz);
-
-                // XYZ to RGB (sRGB matrix)
-                float R = 3.2404542f * X - 1.5371385f * Y - 0.4985314f * Z;
-                float G = -0.9692660f * X + 1.8760108f * Y + 0.0415560f * Z;
-                float B = 0.0556434f * X - 0.2040259f * Y + 1.0572252f * Z;
-
-                // Apply gamma correction and clamp
-                auto gammaCorrect = [](float c) -> quint8 {
-                    if (c <= 0.0031308f) {
-                        c = 12.92f * c;
-                    } else {
-                        c = 1.055f * std::pow(c, 1.0f / 2.4f) - 0.055f;
-                    }
-                    c = qBound(0.0f, c, 1.0f);
-                    return static_cast<quint8>(c * 255.0f);
-                };
-
-                ret.append(gammaCorrect(R));
-                ret.append(gammaCorrect(G));
-                ret.append(gammaCorrect(B));
-
-                pL += 2;
-                pa += 2;
-                pb += 2;
-            }
-        } else {
-            qWarning() << "bytesPerChannel" << bytesPerChannel << "not supported for Lab color mode";
+        // The scan lines of the overload below, without padding
+        qsizetype bytesPerPixel = 4;
+        if (colorMode == QPsdFileHeader::RGB)
+            bytesPerPixel = bytesPerChannel > 1 ? 8 : hasAlpha() ? 4 : 3;
+        else if (colorMode == QPsdFileHeader::Lab)
+            bytesPerPixel = 3;
+        const qsizetype bytesPerLine = qsizetype(width()) * bytesPerPixel;
+        ret = QByteArray(bytesPerLine * height(), Qt::Uninitialized);
+        if (!toImage(colorMode, reinterpret_cast<uchar *>(ret.data()), bytesPerLine)) {
+            qWarning() << "bytesPerChannel" << bytesPerChannel << "not supported";
+            ret.clear();
         }
         break; }
     case QPsdFileHeader::Multichannel: {
@@ -439,4 +806,142 @@ QByteArray QPsdAbstractImage::toImage(QPsdFileHeader::ColorMode colorMode) const
     return ret;
 }
 
+bool QPsdAbstractImage::toImage(QPsdFileHeader::ColorMode colorMode, uchar *bits, qsizetype bytesPerLine,
+                                const QPsdColorTransform &transform) const
+{
+    const int bytesPerChannel = depth() / 8;
+    switch (colorMode) {
+    case QPsdFileHeader::RGB:
+        if (bytesPerChannel == 3 || bytesPerChannel > 4)
+            return false;
+        break;
+    case QPsdFileHeader::CMYK:
+    case QPsdFileHeader::Lab:
+        if (bytesPerChannel != 1 && bytesPerChannel != 2)
+            return false;
+        break;
+    default:
+        return false;
+    }
+
+    const qsizetype w = width();
+    const qsizetype h = height();
+    if (w == 0 || h == 0)
+        return true;
+    decodeChannels();
+
+    const qsizetype planeBytesPerLine = w * qMax(bytesPerChannel, 1);
+    const auto line = [planeBytesPerLine](const uchar *plane, qsizetype y) -> const uchar * {
+        return plane ? plane + y * planeBytesPerLine : nullptr;
+    };
+    // Rows are independent, convert them in blocks of about 256 KiB
+    const qsizetype grainSize = qMax<qsizetype>(1, 256 * 1024 / qMax<qsizetype>(bytesPerLine, 1));
+    const uint o = opacity();
+
+    if (colorMode == QPsdFileHeader::RGB) {
+        const auto pr = r();
+        const auto pg = g();
+        const auto pb = b();
+        const auto pa = hasAlpha() ? a() : nullptr;
+        switch (bytesPerChannel) {
+        case 0:
+        case 1:
+            if (!hasAlpha()) {
+                psdParallelForBlocks(h, grainSize, [&](qsizetype begin, qsizetype end) {
+                    for (qsizetype y = begin; y < end; ++y)
+                        interleave8x3(line(pb, y), line(pg, y), line(pr, y), bits + y * bytesPerLine, w);
+                });
+            } else {
+                // The pixels have room for alpha even if there are no samples for it
+                const QByteArray opaque = pa ? QByteArray() : QByteArray(w, char(0xff));
+                psdParallelForBlocks(h, grainSize, [&](qsizetype begin, qsizetype end) {
+                    for (qsizetype y = begin; y < end; ++y) {
+                        const auto alpha = pa ? line(pa, y) : reinterpret_cast<const uchar *>(opaque.constData());
+                        interleave8x4(line(pb, y), line(pg, y), line(pr, y), alpha,
+                                      bits + y * bytesPerLine, w, o, false);
+                    }
+                });
+            }
+            break;
+        case 2:
+            psdParallelForBlocks(h, grainSize, [&](qsizetype begin, qsizetype end) {
+                for (qsizetype y = begin; y < end; ++y) {
+                    interleave16x4(line(pr, y), line(pg, y), line(pb, y), line(pa, y),
+                                   reinterpret_cast<quint16 *>(bits + y * bytesPerLine), w, o);
+                }
+            });
+            break;
+        case 4: {
+            const float alphaScale = static_cast<float>(o / 255.0);
+            psdParallelForBlocks(h, grainSize, [&](qsizetype begin, qsizetype end) {
+                for (qsizetype y = begin; y < end; ++y) {
+                    interleaveFloat(line(pr, y), line(pg, y), line(pb, y), line(pa, y),
+                                    reinterpret_cast<quint16 *>(bits + y * bytesPerLine), w, alphaScale);
+                }
+            });
+            break; }
+        }
+        return true;
+    }
+
+    if (colorMode == QPsdFileHeader::Lab) {
+        // Channels 0, 1 and 2 hold L, a and b
+        const QPsdColorTransform lab = transform.inputs() == 3 ? transform : QPsdColorTransform::labToSRgb();
+        const uchar *const planes[3] = { r(), g(), b() };
+        psdParallelForBlocks(h, grainSize, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype y = begin; y < end; ++y) {
+                const uchar *const row[3] = { line(planes[0], y), line(planes[1], y), line(planes[2], y) };
+                lab.mapPlanes(row, depth(), false, bits + y * bytesPerLine, 3, w);
+            }
+        });
+        return true;
+    }
+
+    // PSD stores CMYK inverted, the channels are inverted back. Alpha is
+    // not part of the pixels.
+    const auto pc = c();
+    const auto pm = m();
+    const auto py = y();
+    const auto pk = k();
+    if (pc && transform.inputs() == 4) {
+        psdParallelForBlocks(h, grainSize, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype y = begin; y < end; ++y) {
+                const uchar *const row[4] = { line(pc, y), line(pm, y), line(py, y), line(pk, y) };
+                transform.mapPlanes(row, depth(), true, bits + y * bytesPerLine, 4, w);
+            }
+        });
+    } else if (bytesPerChannel == 1 && !pc) {
+        // Fallback: single-channel data treated as grayscale CMYK
+        const QByteArray data = imageData();
+        const auto *src = reinterpret_cast<const uchar *>(data.constData());
+        for (qsizetype y = 0; y < h; ++y) {
+            uchar *dst = bits + y * bytesPerLine;
+            for (qsizetype x = 0; x < w; ++x)
+                memset(dst + x * 4, src[y * w + x] ? 0 : 0xff, 4);
+        }
+    } else if (bytesPerChannel == 1) {
+        psdParallelForBlocks(h, grainSize, [&](qsizetype begin, qsizetype end) {
+            for (qsizetype y = begin; y < end; ++y) {
+                interleave8x4(line(pc, y), line(pm, y), line(py, y), line(pk, y),
+                              bits + y * bytesPerLine, w, 0xff, true);
+            }
+        });
+    } else {
+        // 16-bit CMYK is converted to 8-bit by keeping the high bytes
+        psdParallelForBlocks(h, grainSize, [&](qsizetype begin, qsizetype end) {
+            QByteArray scratch(w * 4, Qt::Uninitialized);
+            auto *planes = reinterpret_cast<uchar *>(scratch.data());
+            for (qsizetype y = begin; y < end; ++y) {
+                narrow16(line(pc, y), planes, w);
+                narrow16(line(pm, y), planes + w, w);
+                narrow16(line(py, y), planes + w * 2, w);
+                narrow16(line(pk, y), planes + w * 3, w);
+                interleave8x4(planes, planes + w, planes + w * 2, planes + w * 3,
+                              bits + y * bytesPerLine, w, 0xff, true);
+            }
+        });
+    }
+    return true;
+}
+
 QT_END_NAMESPACE
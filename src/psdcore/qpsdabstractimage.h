@@ -5,6 +5,7 @@
 #define QPSDABSTRACTIMAGE_H
 
 #include <QtPsdCore/qpsdsection.h>
+#include <QtPsdCore/qpsdcolortransform.h>
 #include <QtPsdCore/qpsdfileheader.h>
 
 QT_BEGIN_NAMESPACE
@@ -34,7 +35,16 @@ public:
 
     virtual QByteArray imageData() const = 0;
     virtual bool hasAlpha() const { return false; }
+    // RGB is returned as B, G, R (and A) bytes at 8 bits, and as native
+    // 16-bit R, G, B, A at 16 and 32 bits. CMYK is returned as C, M, Y, K
+    // bytes and Lab as sRGB R, G, B bytes.
     QByteArray toImage(QPsdFileHeader::ColorMode colorMode) const;
+    // Writes the RGB, CMYK or Lab pixels above straight into height() scan
+    // lines of bytesPerLine bytes at bits, such as those of a QImage. CMYK is
+    // written as 0xffRRGGBB pixels instead if a 4 input transform is given.
+    // Returns false for other color modes and unsupported depths.
+    bool toImage(QPsdFileHeader::ColorMode colorMode, uchar *bits, qsizetype bytesPerLine,
+                 const QPsdColorTransform &transform = QPsdColorTransform()) const;
 
     enum Compression {
         RawData = 0,
@@ -44,6 +54,9 @@ public:
     };
 
 protected:
+    // Called before toImage() reads the channels, so that implementations
+    // can decode all of them at once instead of one by one on access
+    virtual void decodeChannels() const {}
 
     virtual const unsigned char *gray() const = 0;
     virtual const unsigned char *r() const = 0;
@@ -55,8 +68,11 @@ protected:
     virtual const unsigned char *y() const { return nullptr; }
     virtual const unsigned char *k() const { return nullptr; }
 
-    static QByteArray readRLE(QIODevice *source, int height, quint32 *length);
-    static QByteArray readZip(QIODevice *source, quint32 *length);
+    static QByteArray readRLE(QIODevice *source, int height, int countSize, qint64 *length);
+    static QByteArray readZip(QIODevice *source, Compression compression, int width, int height, int depth, qint64 *length);
+    static QByteArray decodeZip(QByteArrayView data, Compression compression, int width, int height, int depth);
+    static QByteArray decodeRegion(QByteArrayView data, Compression compression, int width, int height,
+                                   int planes, int depth, int countSize, const QRect &rect);
 
 private:
     class Private;
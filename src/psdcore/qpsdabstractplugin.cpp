@@ -2,6 +2,19 @@
 // SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qpsdabstractplugin.h"
+#ifdef QT_PSD_BUILTIN_PLUGINS
+#include "qpsdbuiltinplugins_p.h"
+#endif
+
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QJsonDocument>
+#include <QtCore/QJsonObject>
+#include <QtCore/QReadWriteLock>
+#include <QtCore/QSaveFile>
+#include <QtCore/QTimeZone>
+
+#include <algorithm>
 
 class QPsdAbstractPlugin::Private
 {
@@ -27,3 +40,299 @@ void QPsdAbstractPlugin::setKey(const QByteArray &key)
     d->key = key;
     emit keyChanged(key);
 }
+
+class QPsdAbstractPluginLoader
+{
+public:
+    static void setKey(QObject *object, const QByteArray &key)
+    {
+        if (auto plugin = qobject_cast<QPsdAbstractPlugin *>(object))
+            plugin->setKey(key);
+    }
+};
+
+#ifndef Q_OS_WASM
+namespace {
+// Where the keys of one plugin directory live, built from the libraries'
+// metadata without loading them
+struct PluginIndex
+{
+    QByteArrayList keys;
+    QHash<QByteArray, QString> libraries;
+    QHash<QString, QObject *> instances;
+    // Keys whose library has been loaded, for lookups under the read lock
+    QHash<QByteArray, QObject *> plugins;
+};
+
+struct LibraryInfo
+{
+    QString fileName;
+    qint64 size = 0;
+    qint64 lastModified = 0;
+    QByteArrayList keys;
+};
+
+QStringList pluginNameFilters()
+{
+#if defined(Q_OS_LINUX)
+    return { u"*.so"_s };
+#elif defined(Q_OS_WIN)
+    return { u"*.dll"_s };
+#else
+    return {};
+#endif
+}
+
+// Setting QTPSD_PLUGIN_CACHE to a directory keeps the key index of every
+// plugin directory there, so that later runs do not have to open each
+// library for its metadata. An entry is used while the size and the
+// modification time of all libraries in the directory are unchanged.
+QString pluginCacheFile(const QDir &pluginsDir, const char *subdir)
+{
+    const auto cacheDir = qEnvironmentVariable("QTPSD_PLUGIN_CACHE");
+    if (cacheDir.isEmpty())
+        return {};
+    const auto hash = QCryptographicHash::hash(pluginsDir.absolutePath().toUtf8(), QCryptographicHash::Md5);
+    return QDir(cacheDir).filePath(u"%1-%2.json"_s.arg(QLatin1StringView(subdir), QLatin1StringView(hash.toHex().left(8))));
+}
+
+bool readPluginCache(const QString &cacheFile, const char *iid, QList<LibraryInfo> *libraries)
+{
+    QFile file(cacheFile);
+    if (cacheFile.isEmpty() || !file.open(QFile::ReadOnly))
+        return false;
+    const auto root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("IID"_L1).toString() != QLatin1StringView(iid))
+        return false;
+    const auto entries = root.value("libraries"_L1).toArray();
+    if (entries.size() != libraries->size())
+        return false;
+
+    for (qsizetype i = 0; i < libraries->size(); i++) {
+        const auto entry = entries.at(i).toObject();
+        auto &library = (*libraries)[i];
+        if (entry.value("file"_L1).toString() != library.fileName
+            || entry.value("size"_L1).toInteger() != library.size
+            || entry.value("lastModified"_L1).toInteger() != library.lastModified)
+            return false;
+        for (const QJsonValue &key : entry.value("keys"_L1).toArray())
+            library.keys.append(key.toString().toUtf8());
+    }
+    return true;
+}
+
+void writePluginCache(const QString &cacheFile, const char *iid, const QList<LibraryInfo> &libraries)
+{
+    if (cacheFile.isEmpty())
+        return;
+    QJsonArray entries;
+    for (const auto &library : libraries) {
+        QJsonArray keys;
+        for (const auto &key : library.keys)
+            keys.append(QString::fromUtf8(key));
+        entries.append(QJsonObject {
+            { "file"_L1, library.fileName },
+            { "size"_L1, library.size },
+            { "lastModified"_L1, library.lastModified },
+            { "keys"_L1, keys },
+        });
+    }
+    const QJsonObject root {
+        { "IID"_L1, QLatin1StringView(iid) },
+        { "libraries"_L1, entries },
+    };
+
+    QDir().mkpath(QFileInfo(cacheFile).absolutePath());
+    QSaveFile file(cacheFile);
+    if (!file.open(QFile::WriteOnly))
+        return;
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    file.commit();
+}
+
+} // namespace
+
+static QReadWriteLock &pluginIndexLock()
+{
+    static QReadWriteLock ret;
+    return ret;
+}
+
+static QHash<QByteArray, PluginIndex> &pluginIndexes()
+{
+    static QHash<QByteArray, PluginIndex> ret;
+    return ret;
+}
+
+// Returns the index of subdir, building it on first use. The caller holds
+// pluginIndexLock() for writing.
+static PluginIndex &pluginIndex(const char *iid, const char *subdir, QDir (*pluginDir)(const QString &))
+{
+    auto &indexes = pluginIndexes();
+    const QByteArray name(subdir);
+    auto it = indexes.find(name);
+    if (it != indexes.end())
+        return it.value();
+
+    PluginIndex index;
+#ifdef QT_PSD_BUILTIN_PLUGINS
+    const QPsdBuiltinPluginType *builtins = qpsdBuiltinPluginType(subdir);
+    if (builtins) {
+        for (qsizetype i = 0; i < builtins->count; i++)
+            index.keys.append(builtins->plugins[i].key.toByteArray());
+        // Nothing of this type is left in the plugin directory, so it is
+        // neither located nor listed
+        if (builtins->complete)
+            return indexes.insert(name, index).value();
+    }
+#endif
+
+    const QDir pluginsDir = pluginDir(QLatin1StringView(subdir));
+    const auto fileInfos = pluginsDir.entryInfoList(pluginNameFilters(), QDir::Files, QDir::Name);
+    QList<LibraryInfo> libraries;
+    for (const QFileInfo &fileInfo : fileInfos) {
+        LibraryInfo library;
+        library.fileName = fileInfo.fileName();
+        library.size = fileInfo.size();
+        library.lastModified = fileInfo.lastModified(QTimeZone::UTC).toMSecsSinceEpoch();
+        libraries.append(library);
+    }
+
+    const auto cacheFile = pluginCacheFile(pluginsDir, subdir);
+    if (!readPluginCache(cacheFile, iid, &libraries)) {
+        for (auto &library : libraries) {
+            library.keys.clear();
+            QPluginLoader loader(pluginsDir.absoluteFilePath(library.fileName));
+            const auto json = loader.metaData();
+            if (json.value("IID"_L1).toString() != QLatin1StringView(iid))
+                continue;
+            const auto metaData = json.value("MetaData"_L1).toObject();
+            const auto jsonKeys = metaData.value("Keys"_L1).toArray();
+            for (const QJsonValue &jsonKey : jsonKeys)
+                library.keys.append(jsonKey.toString().toUtf8());
+        }
+        writePluginCache(cacheFile, iid, libraries);
+    }
+
+    for (const auto &library : libraries) {
+        const auto path = pluginsDir.absoluteFilePath(library.fileName);
+        for (const auto &key : library.keys) {
+#ifdef QT_PSD_BUILTIN_PLUGINS
+            if (qpsdBuiltinPlugin(builtins, key))
+                continue;
+#endif
+            index.keys.append(key);
+            index.libraries.insert(key, path);
+        }
+    }
+    return indexes.insert(name, index).value();
+}
+
+QByteArrayList QPsdAbstractPlugin::pluginKeys(const char *iid, const char *subdir)
+{
+    QWriteLocker locker(&pluginIndexLock());
+    return pluginIndex(iid, subdir, &qpsdPluginDir).keys;
+}
+
+// The key is set once here rather than on every lookup, so that plugins
+// shared between threads are never written to while parsing
+static QObject *initPlugin(QObject *object, const QJsonObject &json)
+{
+    const auto keys = json.value("MetaData"_L1).toObject().value("Keys"_L1).toArray();
+    if (!keys.isEmpty())
+        QPsdAbstractPluginLoader::setKey(object, keys.first().toString().toLatin1());
+    return object;
+}
+
+#ifdef QT_PSD_BUILTIN_PLUGINS
+const QPsdBuiltinPluginType *qpsdBuiltinPluginType(const char *type)
+{
+    for (qsizetype i = 0; i < qpsdBuiltinPluginTypeCount; i++) {
+        if (qstrcmp(qpsdBuiltinPluginTypes[i].name, type) == 0)
+            return &qpsdBuiltinPluginTypes[i];
+    }
+    return nullptr;
+}
+
+const QPsdBuiltinPlugin *qpsdBuiltinPlugin(const QPsdBuiltinPluginType *type, QByteArrayView key)
+{
+    if (!type || key.size() != 4)
+        return nullptr;
+    const QPsdFourCC fourCC(key);
+    const auto end = type->plugins + type->count;
+    const auto it = std::lower_bound(type->plugins, end, fourCC, [](const QPsdBuiltinPlugin &plugin, QPsdFourCC value) {
+        return plugin.key < value;
+    });
+    return it != end && it->key == fourCC ? it : nullptr;
+}
+
+// Instances by entry point, as plugins with several keys have one entry each
+static QHash<quintptr, QObject *> &builtinInstances()
+{
+    static QHash<quintptr, QObject *> ret;
+    return ret;
+}
+
+// Built-in parsers are instantiated straight from the table, without
+// looking at the plugin directory or the plugin's metadata
+static QObject *builtinInstance(const QPsdBuiltinPlugin &builtin)
+{
+    {
+        QReadLocker locker(&pluginIndexLock());
+        if (QObject *object = builtinInstances().value(reinterpret_cast<quintptr>(builtin.plugin)))
+            return object;
+    }
+
+    QWriteLocker locker(&pluginIndexLock());
+    QObject *&object = builtinInstances()[reinterpret_cast<quintptr>(builtin.plugin)];
+    if (!object) {
+        object = builtin.plugin().instance();
+        QPsdAbstractPluginLoader::setKey(object, builtin.pluginKey.toByteArray());
+    }
+    return object;
+}
+#endif
+
+QObject *QPsdAbstractPlugin::pluginInstance(const char *iid, const char *subdir, const QByteArray &key)
+{
+#ifdef QT_PSD_BUILTIN_PLUGINS
+    const QPsdBuiltinPluginType *builtins = qpsdBuiltinPluginType(subdir);
+    if (const QPsdBuiltinPlugin *builtin = qpsdBuiltinPlugin(builtins, key))
+        return builtinInstance(*builtin);
+    if (builtins && builtins->complete)
+        return nullptr;
+#endif
+
+    // Layers are parsed concurrently, so the common case of a plugin that is
+    // loaded already only takes the read lock
+    {
+        QReadLocker locker(&pluginIndexLock());
+        const auto &indexes = pluginIndexes();
+        const auto it = indexes.constFind(QByteArray::fromRawData(subdir, qstrlen(subdir)));
+        if (it != indexes.constEnd()) {
+            if (QObject *object = it->plugins.value(key))
+                return object;
+            if (!it->libraries.contains(key))
+                return nullptr;
+        }
+    }
+
+    QWriteLocker locker(&pluginIndexLock());
+    auto &index = pluginIndex(iid, subdir, &qpsdPluginDir);
+    const auto path = index.libraries.value(key);
+    if (path.isEmpty())
+        return nullptr;
+
+    QObject *object = index.instances.value(path);
+    if (!object) {
+        QPluginLoader loader(path);
+        object = loader.instance();
+        if (!object) {
+            qFatal() << loader.errorString();
+        }
+        index.instances.insert(path, initPlugin(object, loader.metaData()));
+    }
+    index.plugins.insert(key, object);
+    return object;
+}
+#endif
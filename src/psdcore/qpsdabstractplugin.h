@@ -15,19 +15,25 @@
 
 QT_BEGIN_NAMESPACE
 
+// One instance of each plugin serves every document in the process. The
+// parse() functions of the format plugins are therefore reentrant: they may
+// run on several threads at once and must not keep per-parse state in the
+// plugin.
 class Q_PSDCORE_EXPORT QPsdAbstractPlugin : public QObject, protected QPsdSection
 {
     Q_OBJECT
-    Q_PROPERTY(QByteArray key READ key WRITE setKey NOTIFY keyChanged)
+    Q_PROPERTY(QByteArray key READ key NOTIFY keyChanged)
 public:
     explicit QPsdAbstractPlugin(QObject *parent = nullptr);
     ~QPsdAbstractPlugin() override;
 
+    /*!
+     * Returns the first key listed in the plugin's metadata. It is set once
+     * when the plugin is instantiated; format plugins that handle several
+     * keys receive the key being parsed as an argument of parse() instead.
+     */
     QByteArray key() const;
 
-public Q_SLOTS:
-    void setKey(const QByteArray &key);
-
 Q_SIGNALS:
     void keyChanged(const QByteArray &key);
 
@@ -71,6 +77,8 @@ protected:
                 auto plugin = qobject_cast<T *>(object);
                 if (!plugin)
                     continue;
+                if (!jsonKeys.isEmpty())
+                    plugin->setKey(jsonKeys.first().toString().toLatin1());
                 for (const QJsonValue &jsonKey : jsonKeys) {
                     ret.insert(jsonKey.toString().toLatin1(), plugin);
                 }
@@ -78,81 +86,32 @@ protected:
             return ret;
         }();
 
-        auto ret = plugins.value(key);
-        if (ret)
-            ret->setKey(key);
-        return qobject_cast<T *>(ret);
+        return plugins.value(key);
     }
 #else
-    // Dynamic plugin support for desktop platforms
+    // Dynamic plugin support for desktop platforms. The keys come from the
+    // libraries' metadata, and a library is only loaded when one of its keys
+    // is requested for the first time.
     template <typename T>
     static QByteArrayList keys(const char *iid, const char *subdir) {
-        static QByteArrayList ret = [&]() {
-            QByteArrayList keys;
-            QDir pluginsDir = qpsdPluginDir(QLatin1StringView(subdir));
-            for (const QString &fileName : pluginsDir.entryList(
-#ifdef Q_OS_LINUX
-                     QStringList() << "*.so"_L1,
-#endif
-#ifdef Q_OS_WIN
-                     QStringList() << "*.dll"_L1,
-#endif
-                     QDir::Files)) {
-                QPluginLoader loader(pluginsDir.absoluteFilePath(fileName));
-                const auto json = loader.metaData();
-                Q_ASSERT(json.value("IID"_L1).toString() == QLatin1StringView(iid));
-                const auto metaData = json.value("MetaData"_L1).toObject();
-                const auto jsonKeys = metaData.value("Keys"_L1).toArray();
-                for (const QJsonValue &jsonKey : jsonKeys) {
-                    keys.append(jsonKey.toString().toUtf8());
-                }
-            }
-            return keys;
-        }();
-        return ret;
+        return pluginKeys(iid, subdir);
     }
 
     template <typename T>
     static T *plugin(const char *iid, const char *subdir, const QByteArray &key) {
-        static QHash<QByteArray, T *> plugins = [&]() {
-            QHash<QByteArray, T *> ret;
-            QDir pluginsDir = qpsdPluginDir(QLatin1StringView(subdir));
-            for (const QString &fileName : pluginsDir.entryList(
-#ifdef Q_OS_LINUX
-                     QStringList() << "*.so"_L1,
-#endif
-#ifdef Q_OS_WIN
-                     QStringList() << "*.dll"_L1,
-#endif
-                     QDir::Files)) {
-                QPluginLoader loader(pluginsDir.absoluteFilePath(fileName));
-                const auto json = loader.metaData();
-                Q_ASSERT(json.value("IID"_L1).toString() == QLatin1StringView(iid));
-                const auto metaData = json.value("MetaData"_L1).toObject();
-                const auto jsonKeys = metaData.value("Keys"_L1).toArray();
-                QObject *object = loader.instance();
-                if (!object) {
-                    qFatal() << loader.errorString();
-                }
-                auto plugin = qobject_cast<T *>(object);
-                Q_ASSERT(plugin);
-                for (const QJsonValue &jsonKey : jsonKeys) {
-                    ret.insert(jsonKey.toString().toLatin1(), plugin);
-                }
-            }
-            return ret;
-        }();
-
-        auto ret = plugins.value(key);
-        if (ret)
-            ret->setKey(key);
-        return qobject_cast<T *>(ret);
+        return qobject_cast<T *>(pluginInstance(iid, subdir, key));
     }
 #endif
 
 private:
+    // Only the loader sets the key, when it instantiates the plugin
+    friend class QPsdAbstractPluginLoader;
+    void setKey(const QByteArray &key);
+
 #ifndef Q_OS_WASM
     static QDir qpsdPluginDir(const QString &type);
+    static QByteArrayList pluginKeys(const char *iid, const char *subdir);
+    static QObject *pluginInstance(const char *iid, const char *subdir, const QByteArray &key);
 #endif
     class Private;
     QScopedPointer<Private> d;
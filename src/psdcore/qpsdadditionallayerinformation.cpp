@@ -4,10 +4,22 @@
 #include "qpsdadditionallayerinformation.h"
 #include "qpsdadditionallayerinformationplugin.h"
 
+#include <algorithm>
+#include <limits>
+
 QT_BEGIN_NAMESPACE
 
 Q_LOGGING_CATEGORY(lcQPsdAdditionalLayerInformation, "qt.psdcore.additionalinformation")
 
+static bool hasLargeLength(QByteArrayView key)
+{
+    static constexpr QByteArrayView keys[] = {
+        "LMsk", "Lr16", "Lr32", "Layr", "Mt16", "Mt32", "Mtrn",
+        "Alph", "FMsk", "lnk2", "FEid", "FXid", "PxSD",
+    };
+    return std::find(std::begin(keys), std::end(keys), key) != std::end(keys);
+}
+
 class QPsdAdditionalLayerInformation::Private : public QSharedData
 {
 public:
@@ -21,6 +33,10 @@ QPsdAdditionalLayerInformation::QPsdAdditionalLayerInformation()
 {}
 
 QPsdAdditionalLayerInformation::QPsdAdditionalLayerInformation(QIODevice *source, int padding)
+    : QPsdAdditionalLayerInformation(source, readOptions(source), padding)
+{}
+
+QPsdAdditionalLayerInformation::QPsdAdditionalLayerInformation(QIODevice *source, ReadOptions options, int padding)
     : QPsdAdditionalLayerInformation()
 {
     // Additional Layer Information
@@ -43,13 +59,19 @@ QPsdAdditionalLayerInformation::QPsdAdditionalLayerInformation(QIODevice *source
 
     // Length data below, rounded up to an even byte count.
     // (**PSB**, the following keys have a length count of 8 bytes: LMsk, Lr16, Lr32, Layr, Mt16, Mt32, Mtrn, Alph, FMsk, lnk2, FEid, FXid, PxSD.
-    auto length = readU32(source);
-    EnsureSeek es(source, length, padding);
+    const quint64 blockLength = options.testFlag(LargeDocument) && hasLargeLength(d->key)
+        ? readU64(source) : readU32(source);
+    EnsureSeek es(source, blockLength, padding);
+    if (blockLength > std::numeric_limits<quint32>::max()) {
+        qWarning() << d->key << blockLength << "bytes is too large, skipping";
+        return;
+    }
+    const auto length = quint32(blockLength);
 
     auto plugin = QPsdAdditionalLayerInformationPlugin::plugin(d->key);
     if (plugin) {
         qCDebug(lcQPsdAdditionalLayerInformation) << (void *)source->pos() << d->key << length;
-        d->data = plugin->parse(source, length);
+        d->data = plugin->parse(d->key, source, length);
         qCDebug(lcQPsdAdditionalLayerInformation) << (void *)source->pos() << d->key << d->data;
     } else {
         QByteArray data;
@@ -16,6 +16,7 @@ class Q_PSDCORE_EXPORT QPsdAdditionalLayerInformation : public QPsdSection
 public:
     QPsdAdditionalLayerInformation();
     QPsdAdditionalLayerInformation(QIODevice *source, int padding = 0);
+    QPsdAdditionalLayerInformation(QIODevice *source, ReadOptions options, int padding = 0);
     QPsdAdditionalLayerInformation(const QPsdAdditionalLayerInformation &other);
     QPsdAdditionalLayerInformation &operator=(const QPsdAdditionalLayerInformation &other);
     ~QPsdAdditionalLayerInformation() override;
@@ -16,7 +16,10 @@ class Q_PSDCORE_EXPORT QPsdAdditionalLayerInformationPlugin : public QPsdAbstrac
 public:
     explicit QPsdAdditionalLayerInformationPlugin(QObject *parent = nullptr);
 
-    virtual QVariant parse(QIODevice *source , quint32 length) const = 0;
+    /*!
+     * Parses the block stored under \a key from \a source.
+     */
+    virtual QVariant parse(QByteArrayView key, QIODevice *source, quint32 length) const = 0;
     virtual QByteArray serialize(const QVariant &data) const { Q_UNUSED(data); return {}; }
 
     static QByteArrayList keys() {
@@ -0,0 +1,58 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qpsdarena_p.h"
+#include "qpsdbytecursor_p.h"
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+// Layer channels of typical documents are a few kilobytes to a few hundred
+// kilobytes each once compressed
+constexpr qint64 BlockSize = 1024 * 1024;
+// Payloads start on this boundary so that decoders can load them in words
+constexpr qint64 Alignment = 16;
+
+thread_local QPsdArena *currentArena = nullptr;
+} // namespace
+
+QPsdByteSlice QPsdArena::read(QIODevice *source, qint64 size)
+{
+    const qint64 offset = source->pos();
+    if (size > BlockSize / 4)
+        return QPsdByteSlice(source->read(size), offset);
+    if (size <= 0)
+        return QPsdByteSlice(QByteArray(), offset);
+
+    if (block.isNull() || BlockSize - used < size) {
+        block = QPsdByteSlice(QByteArray(BlockSize, Qt::Uninitialized));
+        used = 0;
+    }
+    // Earlier slices only look at the bytes before used, so the rest of the
+    // block can be written while they are alive
+    char *data = block.d->bytes.data() + used;
+    const qint64 length = qMax<qint64>(source->read(data, size), 0);
+
+    QPsdByteSlice ret = block.mid(used, length);
+    ret.off = offset;
+    used += (length + Alignment - 1) & ~(Alignment - 1);
+    return ret;
+}
+
+QPsdArena *QPsdArena::current()
+{
+    return currentArena;
+}
+
+QPsdArena::Scope::Scope(QPsdArena *arena)
+    : previous(currentArena)
+{
+    currentArena = arena;
+}
+
+QPsdArena::Scope::~Scope()
+{
+    currentArena = previous;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,51 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPSDARENA_P_H
+#define QPSDARENA_P_H
+
+#include <QtPsdCore/qpsdcoreglobal.h>
+#include <QtPsdCore/qpsdbytecursor.h>
+
+QT_BEGIN_NAMESPACE
+
+// Storage for the encoded channel and composite data of a document read
+// from a device that is not memory mapped. Small payloads are read back to
+// back into shared blocks instead of a heap buffer each, and a block is
+// released when the last slice into it is destroyed. Payloads larger than a
+// quarter of a block get a buffer of their own.
+//
+// An arena is used by the thread that reads the document only; layers
+// parsed in parallel take views of one buffer read up front.
+class Q_PSDCORE_EXPORT QPsdArena
+{
+public:
+    QPsdArena() = default;
+    Q_DISABLE_COPY_MOVE(QPsdArena)
+
+    // Reads up to size bytes at the current position of source
+    QPsdByteSlice read(QIODevice *source, qint64 size);
+
+    // The arena that QPsdSection::readByteSlice() reads into on this
+    // thread, or nullptr
+    static QPsdArena *current();
+
+    class Q_PSDCORE_EXPORT Scope
+    {
+    public:
+        explicit Scope(QPsdArena *arena);
+        ~Scope();
+        Q_DISABLE_COPY_MOVE(Scope)
+
+    private:
+        QPsdArena *previous;
+    };
+
+private:
+    QPsdByteSlice block;
+    qint64 used = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPSDARENA_P_H
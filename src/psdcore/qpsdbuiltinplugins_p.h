@@ -0,0 +1,46 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPSDBUILTINPLUGINS_P_H
+#define QPSDBUILTINPLUGINS_P_H
+
+#include <QtPsdCore/qpsdcoreglobal.h>
+#include <QtPsdCore/qpsdfourccmap.h>
+
+#include <QtCore/qplugin.h>
+
+QT_BEGIN_NAMESPACE
+
+// One key of a format plugin linked into PsdCore. pluginKey is the first key
+// in the plugin's metadata, which QPsdAbstractPlugin::key() returns.
+struct QPsdBuiltinPlugin
+{
+    QPsdFourCC key;
+    QPsdFourCC pluginKey;
+    const QStaticPlugin (*plugin)();
+};
+
+// The built-in plugins of one plugin type, sorted by key. A complete type
+// has no plugins left in the plugin directory.
+struct QPsdBuiltinPluginType
+{
+    const char *name;
+    const QPsdBuiltinPlugin *plugins;
+    qsizetype count;
+    bool complete;
+};
+
+// Generated by src/plugins/CMakeLists.txt from the plugin targets when
+// QT_PSD_BUILTIN_FORMAT_PLUGINS is enabled, see qpsdbuiltinplugins.cpp in
+// the build directory
+extern Q_PSDCORE_EXPORT const QPsdBuiltinPluginType qpsdBuiltinPluginTypes[];
+extern Q_PSDCORE_EXPORT const qsizetype qpsdBuiltinPluginTypeCount;
+
+// Returns the built-in plugins of type, or nullptr if there are none
+Q_PSDCORE_EXPORT const QPsdBuiltinPluginType *qpsdBuiltinPluginType(const char *type);
+// Returns the entry of key in type by binary search, or nullptr
+Q_PSDCORE_EXPORT const QPsdBuiltinPlugin *qpsdBuiltinPlugin(const QPsdBuiltinPluginType *type, QByteArrayView key);
+
+QT_END_NAMESPACE
+
+#endif // QPSDBUILTINPLUGINS_P_H
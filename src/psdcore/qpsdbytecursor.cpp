@@ -0,0 +1,209 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qpsdbytecursor.h"
+#include "qpsdbytecursor_p.h"
+
+#if defined(Q_OS_UNIX)
+#include <sys/stat.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+
+QPsdByteSlice::QPsdByteSlice() = default;
+
+QPsdByteSlice::QPsdByteSlice(const QByteArray &data, qint64 offset)
+    : d(new Storage)
+    , len(data.size())
+    , off(offset)
+{
+    d->bytes = data;
+    d->data = reinterpret_cast<const uchar *>(d->bytes.constData());
+    d->size = data.size();
+}
+
+QPsdByteSlice::QPsdByteSlice(const QPsdByteSlice &other) = default;
+
+QPsdByteSlice &QPsdByteSlice::operator=(const QPsdByteSlice &other) = default;
+
+QPsdByteSlice::~QPsdByteSlice() = default;
+
+qint64 QPsdByteSlice::offset() const
+{
+    return d ? off : 0;
+}
+
+int QPsdByteSlice::fileHandle() const
+{
+    return d && d->mapped ? d->file.handle() : -1;
+}
+
+bool QPsdByteSlice::isTruncated() const
+{
+#if defined(Q_OS_UNIX)
+    // Windows does not let a mapped file be truncated
+    if (!d || !d->mapped || len == 0)
+        return false;
+    struct stat status;
+    return ::fstat(d->file.handle(), &status) == 0 && status.st_size < off + len;
+#else
+    return false;
+#endif
+}
+
+const uchar *QPsdByteSlice::constData() const
+{
+    return d ? d->data + pos : nullptr;
+}
+
+QByteArrayView QPsdByteSlice::view() const
+{
+    return QByteArrayView(constData(), len);
+}
+
+QByteArray QPsdByteSlice::toByteArray() const
+{
+    if (!d)
+        return {};
+    // Slices covering a whole in-memory buffer can share it instead of copying
+    if (pos == 0 && len == d->bytes.size() && !d->bytes.isEmpty())
+        return d->bytes;
+    return QByteArray(reinterpret_cast<const char *>(constData()), len);
+}
+
+QPsdByteSlice QPsdByteSlice::mid(qint64 position, qint64 length) const
+{
+    QPsdByteSlice ret;
+    if (!d)
+        return ret;
+    position = qBound<qint64>(0, position, len);
+    if (length < 0 || length > len - position)
+        length = len - position;
+    ret.d = d;
+    ret.pos = pos + position;
+    ret.len = length;
+    ret.off = off + position;
+    return ret;
+}
+
+class QPsdByteCursor::Private
+{
+public:
+    QPsdByteSlice data;
+    bool mapped = false;
+};
+
+QPsdByteCursor::QPsdByteCursor(QObject *parent)
+    : QIODevice(parent)
+    , d(new Private)
+{}
+
+QPsdByteCursor::QPsdByteCursor(const QByteArray &data, QObject *parent)
+    : QPsdByteCursor(parent)
+{
+    d->data = QPsdByteSlice(data);
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+QPsdByteCursor::QPsdByteCursor(const QPsdByteSlice &data, QObject *parent)
+    : QPsdByteCursor(parent)
+{
+    d->data = data;
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+QPsdByteCursor::~QPsdByteCursor() = default;
+
+bool QPsdByteCursor::map(const QString &fileName)
+{
+    if (isOpen())
+        close();
+
+    QExplicitlySharedDataPointer<QPsdByteSlice::Storage> storage(new QPsdByteSlice::Storage);
+    storage->file.setFileName(fileName);
+    if (!storage->file.open(QFile::ReadOnly)) {
+        setErrorString(storage->file.errorString());
+        return false;
+    }
+    const qint64 fileSize = storage->file.size();
+    if (fileSize > 0) {
+        storage->mapped = storage->file.map(0, fileSize);
+        if (!storage->mapped) {
+            setErrorString(storage->file.errorString());
+            return false;
+        }
+    }
+    storage->data = storage->mapped;
+    storage->size = fileSize;
+
+    d->data = QPsdByteSlice();
+    d->data.d = storage;
+    d->data.len = fileSize;
+    d->mapped = true;
+    return open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+}
+
+bool QPsdByteCursor::isMapped() const
+{
+    return d->mapped;
+}
+
+qint64 QPsdByteCursor::size() const
+{
+    return d->data.size();
+}
+
+bool QPsdByteCursor::seek(qint64 pos)
+{
+    // Positions past the end are clamped so that a corrupt length field
+    // behaves like reading past the end of a file instead of rewinding
+    if (pos > size()) {
+        QIODevice::seek(size());
+        return false;
+    }
+    return QIODevice::seek(pos);
+}
+
+const uchar *QPsdByteCursor::constData() const
+{
+    return d->data.constData();
+}
+
+const uchar *QPsdByteCursor::peekData(qint64 size) const
+{
+    const qint64 position = pos();
+    if (size < 0 || position + size > d->data.size())
+        return nullptr;
+    return d->data.constData() + position;
+}
+
+QPsdByteSlice QPsdByteCursor::slice(qint64 offset, qint64 size) const
+{
+    return d->data.mid(offset, size);
+}
+
+QPsdByteSlice QPsdByteCursor::readSlice(qint64 size)
+{
+    const qint64 position = pos();
+    const auto ret = d->data.mid(position, size);
+    seek(position + ret.size());
+    return ret;
+}
+
+qint64 QPsdByteCursor::readData(char *data, qint64 maxSize)
+{
+    const qint64 length = qMin(maxSize, d->data.size() - pos());
+    if (length <= 0)
+        return 0;
+    memcpy(data, d->data.constData() + pos(), length);
+    return length;
+}
+
+qint64 QPsdByteCursor::writeData(const char *data, qint64 maxSize)
+{
+    Q_UNUSED(data);
+    Q_UNUSED(maxSize);
+    return -1;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,136 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPSDBYTECURSOR_H
+#define QPSDBYTECURSOR_H
+
+#include <QtPsdCore/qpsdcoreglobal.h>
+
+#include <QtCore/QByteArrayView>
+#include <QtCore/QIODevice>
+#include <QtCore/QSharedData>
+
+QT_BEGIN_NAMESPACE
+
+class Q_PSDCORE_EXPORT QPsdByteSlice
+{
+public:
+    QPsdByteSlice();
+    explicit QPsdByteSlice(const QByteArray &data, qint64 offset = 0);
+    QPsdByteSlice(const QPsdByteSlice &other);
+    QPsdByteSlice &operator=(const QPsdByteSlice &other);
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QPsdByteSlice)
+    void swap(QPsdByteSlice &other) noexcept
+    {
+        d.swap(other.d);
+        std::swap(pos, other.pos);
+        std::swap(len, other.len);
+        std::swap(off, other.off);
+    }
+    ~QPsdByteSlice();
+
+    /*!
+     * Returns true if the slice does not refer to any backing storage.
+     */
+    bool isNull() const { return !d; }
+    bool isEmpty() const { return len == 0; }
+
+    /*!
+     * Returns the position of the first byte of the slice in the source
+     * it was taken from (the file offset for mapped documents).
+     */
+    qint64 offset() const;
+    qint64 size() const { return len; }
+
+    /*!
+     * Returns the native handle of the file the slice is mapped from, or -1
+     * if it refers to memory. offset() is the position of the slice in that
+     * file, so the bytes can be copied file to file without touching them.
+     */
+    int fileHandle() const;
+
+    /*!
+     * Returns true if the slice is mapped from a file that has been truncated
+     * since, so that the file no longer covers the slice. Touching the bytes
+     * of such a slice raises SIGBUS, which is why lazy decoding checks this
+     * first. A file truncated after the check can still fault.
+     */
+    bool isTruncated() const;
+
+    const uchar *constData() const;
+    QByteArrayView view() const;
+
+    /*!
+     * Returns the bytes of the slice. A slice covering a whole in-memory
+     * buffer returns that buffer implicitly shared, so writing to the result
+     * detaches it; any other slice, including mapped ones, is copied.
+     */
+    QByteArray toByteArray() const;
+
+    /*!
+     * Returns a sub-slice sharing the same backing storage. The range is
+     * clamped to the bounds of this slice.
+     */
+    QPsdByteSlice mid(qint64 position, qint64 length = -1) const;
+
+private:
+    friend class QPsdByteCursor;
+    friend class QPsdArena;
+    class Storage;
+    QExplicitlySharedDataPointer<Storage> d;
+    qint64 pos = 0;
+    qint64 len = 0;
+    qint64 off = 0;
+};
+
+Q_DECLARE_SHARED(QPsdByteSlice)
+
+class Q_PSDCORE_EXPORT QPsdByteCursor : public QIODevice
+{
+    Q_OBJECT
+public:
+    explicit QPsdByteCursor(QObject *parent = nullptr);
+    explicit QPsdByteCursor(const QByteArray &data, QObject *parent = nullptr);
+    explicit QPsdByteCursor(const QPsdByteSlice &data, QObject *parent = nullptr);
+    ~QPsdByteCursor() override;
+
+    /*!
+     * Maps \a fileName read-only into memory and opens the cursor on it.
+     * Slices taken from the cursor keep the mapping alive after the cursor
+     * itself is destroyed. The file must not be truncated while the mapping
+     * is in use; see QPsdByteSlice::isTruncated().
+     */
+    bool map(const QString &fileName);
+    bool isMapped() const;
+
+    qint64 size() const override;
+    bool seek(qint64 pos) override;
+
+    const uchar *constData() const;
+
+    /*!
+     * Returns a pointer to the next \a size bytes at the current position
+     * without consuming them, or nullptr if fewer bytes are available.
+     */
+    const uchar *peekData(qint64 size) const;
+
+    QPsdByteSlice slice(qint64 offset, qint64 size) const;
+
+    /*!
+     * Returns the next \a size bytes as a slice of the underlying storage
+     * and advances the position past them.
+     */
+    QPsdByteSlice readSlice(qint64 size);
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *data, qint64 maxSize) override;
+
+private:
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPSDBYTECURSOR_H
@@ -0,0 +1,31 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPSDBYTECURSOR_P_H
+#define QPSDBYTECURSOR_P_H
+
+#include "qpsdbytecursor.h"
+
+#include <QtCore/QFile>
+
+QT_BEGIN_NAMESPACE
+
+class QPsdByteSlice::Storage : public QSharedData
+{
+public:
+    ~Storage()
+    {
+        if (mapped)
+            file.unmap(mapped);
+    }
+
+    QFile file;
+    uchar *mapped = nullptr;
+    QByteArray bytes;
+    const uchar *data = nullptr;
+    qint64 size = 0;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPSDBYTECURSOR_P_H
@@ -3,6 +3,9 @@
 
 #include "qpsdchannelimagedata.h"
 #include "qpsdlayerrecord.h"
+#include "qpsdparallel_p.h"
+
+#include <QtCore/QMutex>
 
 QT_BEGIN_NAMESPACE
 
@@ -10,23 +13,110 @@ class QPsdChannelImageData::Private : public QSharedData
 {
 public:
     Private();
-    QHash<QPsdChannelInfo::ChannelID, QByteArray> imageData;
+    Private(const Private &other);
+
+    // Parsing only records where each channel's encoded bytes are;
+    // they are decoded the first time the channel is accessed
+    struct Channel {
+        QPsdAbstractImage::Compression compression = QPsdAbstractImage::RawData;
+        QPsdByteSlice payload;
+        int columns = 0;
+        int rows = 0;
+        int countSize = 2;
+        mutable QPsdByteSlice decoded;
+        mutable bool isDecoded = false;
+    };
+
+    QHash<QPsdChannelInfo::ChannelID, Channel> channels;
     QHash<QPsdChannelInfo::ChannelID, QPsdAbstractImage::Compression> channelCompression;
 #ifdef QT_PSD_RAW_ROUND_TRIP
-    QHash<QPsdChannelInfo::ChannelID, QByteArray> rawChannelBytes;
+    QHash<QPsdChannelInfo::ChannelID, QPsdByteSlice> rawChannelBytes;
 #endif
+    mutable QMutex mutex;
 
-    const unsigned char *data(QPsdChannelInfo::ChannelID channelID) const {
-        if (!imageData.contains(channelID))
-            return nullptr;
-        return reinterpret_cast<const unsigned char *>(imageData.value(channelID).constData());
+    static QPsdByteSlice decode(const Channel &channel, int depth);
+    QPsdByteSlice decodedData(QPsdChannelInfo::ChannelID channelID, int depth) const;
+    void decodeAll(int depth) const;
+    const unsigned char *data(QPsdChannelInfo::ChannelID channelID, int depth) const {
+        return decodedData(channelID, depth).constData();
     }
-
 };
 
 QPsdChannelImageData::Private::Private()
 {}
 
+QPsdChannelImageData::Private::Private(const Private &other)
+    : QSharedData(other)
+    , channelCompression(other.channelCompression)
+#ifdef QT_PSD_RAW_ROUND_TRIP
+    , rawChannelBytes(other.rawChannelBytes)
+#endif
+{
+    QMutexLocker locker(&other.mutex);
+    channels = other.channels;
+}
+
+QPsdByteSlice QPsdChannelImageData::Private::decode(const Channel &channel, int depth)
+{
+    // The mapped document may have been truncated since it was parsed
+    if (channel.payload.isTruncated()) {
+        qWarning("QPsdChannelImageData: the memory-mapped document has been truncated");
+        return {};
+    }
+    switch (channel.compression) {
+    case RawData:
+        return channel.payload;
+    case RLE:
+        return QPsdByteSlice(decodePackBits(channel.payload.view(), channel.rows, channel.countSize));
+    case ZipWithPrediction:
+    case ZipWithoutPrediction:
+        return QPsdByteSlice(decodeZip(channel.payload.view(), channel.compression,
+                                       channel.columns, channel.rows, depth));
+    }
+    return {};
+}
+
+QPsdByteSlice QPsdChannelImageData::Private::decodedData(QPsdChannelInfo::ChannelID channelID, int depth) const
+{
+    Channel pending;
+    {
+        QMutexLocker locker(&mutex);
+        const auto it = channels.constFind(channelID);
+        if (it == channels.constEnd())
+            return {};
+        if (it->isDecoded)
+            return it->decoded;
+        pending = it.value();
+    }
+
+    // Decode without holding the lock so that other channels can be decoded
+    // at the same time; if two threads race on one channel the first wins
+    const auto decoded = decode(pending, depth);
+
+    QMutexLocker locker(&mutex);
+    const auto it = channels.constFind(channelID);
+    if (!it->isDecoded) {
+        it->decoded = decoded;
+        it->isDecoded = true;
+    }
+    return it->decoded;
+}
+
+void QPsdChannelImageData::Private::decodeAll(int depth) const
+{
+    QList<QPsdChannelInfo::ChannelID> pending;
+    {
+        QMutexLocker locker(&mutex);
+        for (auto it = channels.constBegin(); it != channels.constEnd(); ++it) {
+            if (!it->isDecoded)
+                pending.append(it.key());
+        }
+    }
+    psdParallelFor(pending.size(), [&](qsizetype i) {
+        decodedData(pending.at(i), depth);
+    });
+}
+
 QPsdChannelImageData::QPsdChannelImageData()
     : QPsdAbstractImage()
     , d(new Private)
@@ -42,10 +132,19 @@ QPsdChannelImageData::QPsdChannelImageData(const QPsdLayerRecord &record, QIODev
     // Channel image data
     // https://www.adobe.com/devnet-apps/photoshop/fileformatashtml/#50577409_26431
 
+    // (**PSB** RLE byte counts are four-byte values.)
+    const int countSize = isLargeDocument(source) ? 4 : 2;
+
     for (const auto &channelInfo : record.channelInfo()) {
+        if (isCanceled(source))
+            break;
+        const auto progress = qScopeGuard([&] {
+            advance(source, channelInfo.length());
+        });
         auto id = channelInfo.id();
-        auto length = channelInfo.length();
-        EnsureSeek es(source, length);
+        EnsureSeek es(source, channelInfo.length());
+        // PSB channels can be larger than 4 GiB
+        qint64 length = channelInfo.length();
         auto cleanup = qScopeGuard([&] {
             Q_ASSERT(length == 0);
         });
@@ -58,27 +157,42 @@ QPsdChannelImageData::QPsdChannelImageData(const QPsdLayerRecord &record, QIODev
         // Save raw compressed bytes (compression u16 + compressed data) for lossless round-trip
         {
             const qint64 channelStart = source->pos();
-            d->rawChannelBytes.insert(id, source->read(channelInfo.length()));
+            qint64 rawLength = length;
+            d->rawChannelBytes.insert(id, readByteSlice(source, rawLength, &rawLength));
             source->seek(channelStart);
         }
 #endif
 
         // Compression. 0 = Raw Data, 1 = RLE compressed, 2 = ZIP without prediction, 3 = ZIP with prediction.
-        Compression compression = static_cast<Compression>(readU16(source, &length));
+        Compression compression = static_cast<Compression>(readU16(source));
+        length -= sizeof(quint16);
         d->channelCompression.insert(id, compression);
 
         if (es.bytesAvailable() <= 0)
             continue;
 
+        Private::Channel channel;
+        channel.compression = compression;
+        channel.columns = record.rect().width();
+        channel.rows = record.rect().height();
+        channel.countSize = countSize;
+        // Masks have their own rectangle.
+        if (id == QPsdChannelInfo::UserSuppliedLayerMask) {
+            channel.columns = record.layerMaskAdjustmentLayerData().rect().width();
+            channel.rows = record.layerMaskAdjustmentLayerData().rect().height();
+        } else if (id == QPsdChannelInfo::RealUserSuppliedLayerMask) {
+            channel.columns = record.layerMaskAdjustmentLayerData().realUserMaskRect().width();
+            channel.rows = record.layerMaskAdjustmentLayerData().realUserMaskRect().height();
+        }
+
         // Image data.
         switch (compression) {
         case RawData:
             // If the compression code is 0, the image data is just the raw image data,
             // whose size is calculated as (LayerBottom-LayerTop)* (LayerRight-LayerLeft)
             // (from the first field in See Layer records).
-            d->imageData.insert(id, readByteArray(source, length, &length));
             break;
-        case RLE: {
+        case RLE:
             // If the compression code is 1,
             // the image data starts with the byte counts for all the scan lines in the channel
             // (LayerBottom-LayerTop) , with each count stored as a two-byte value.
@@ -86,22 +200,22 @@ QPsdChannelImageData::QPsdChannelImageData(const QPsdLayerRecord &record, QIODev
             // The RLE compressed data follows, with each scan line compressed separately.
             // The RLE compression is the same compression algorithm used by the Macintosh
             // ROM routine PackBits, and the TIFF standard.
-            auto height = record.rect().height();
-            if (id == QPsdChannelInfo::UserSuppliedLayerMask) {
-                height = record.layerMaskAdjustmentLayerData().rect().height();
-            } else if (id == QPsdChannelInfo::RealUserSuppliedLayerMask) {
-                height = record.layerMaskAdjustmentLayerData().realUserMaskRect().height();
-            }
-
-            d->imageData.insert(id, readRLE(source, height, &length));
-            break; }
+            break;
         case ZipWithPrediction:
         case ZipWithoutPrediction:
-            d->imageData.insert(id, readZip(source, &length));
+            // A zlib stream of the whole channel; with prediction every row is delta coded.
             break;
         default:
             qFatal("Compression %d not supported", compression);
         }
+        // Only the location of the encoded bytes is kept here, decoding is deferred
+#ifdef QT_PSD_RAW_ROUND_TRIP
+        channel.payload = d->rawChannelBytes.value(id).mid(sizeof(quint16), length);
+        skip(source, length, &length);
+#else
+        channel.payload = readByteSlice(source, length, &length);
+#endif
+        d->channels.insert(id, channel);
         // If the layer's size, and therefore the data, is odd, a pad byte will be inserted at the end of the row.
         // If the layer is an adjustment layer, the channel data is undefined (probably all white.)
     }
@@ -125,27 +239,93 @@ QPsdChannelImageData::~QPsdChannelImageData() = default;
 
 QByteArray QPsdChannelImageData::imageData() const
 {
-    return d->imageData.value(QPsdChannelInfo::Red);
+    return d->decodedData(QPsdChannelInfo::Red, depth()).toByteArray();
 }
 
 QByteArray QPsdChannelImageData::transparencyMaskData() const
 {
-    return d->imageData.contains(QPsdChannelInfo::TransparencyMask) ? d->imageData.value(QPsdChannelInfo::TransparencyMask) : QByteArray();
+    return d->decodedData(QPsdChannelInfo::TransparencyMask, depth()).toByteArray();
 }
 
 QByteArray QPsdChannelImageData::userSuppliedLayerMask() const
 {
-    return d->imageData.contains(QPsdChannelInfo::UserSuppliedLayerMask) ? d->imageData.value(QPsdChannelInfo::UserSuppliedLayerMask) : QByteArray();
+    return d->decodedData(QPsdChannelInfo::UserSuppliedLayerMask, depth()).toByteArray();
 }
 
 QByteArray QPsdChannelImageData::channelData(QPsdChannelInfo::ChannelID channelId) const
 {
-    return d->imageData.value(channelId);
+    return d->decodedData(channelId, depth()).toByteArray();
 }
 
 void QPsdChannelImageData::setChannelData(QPsdChannelInfo::ChannelID channelId, const QByteArray &data)
 {
-    d->imageData.insert(channelId, data);
+    Private::Channel channel;
+    channel.compression = d->channelCompression.value(channelId, RawData);
+    channel.decoded = QPsdByteSlice(data);
+    channel.isDecoded = true;
+    d->channels.insert(channelId, channel);
+}
+
+void QPsdChannelImageData::decodeChannels() const
+{
+    d->decodeAll(depth());
+}
+
+QPsdChannelImageData QPsdChannelImageData::region(const QRect &rect) const
+{
+    const QRect bounds = rect & QRect(0, 0, width(), height());
+
+    QPsdChannelImageData ret;
+    ret.setHeader(header());
+    ret.setOpacity(opacity());
+    ret.setWidth(bounds.width());
+    ret.setHeight(bounds.height());
+    // The channels of the region hold decoded pixels, RawData by default
+    if (bounds.isEmpty())
+        return ret;
+
+    QHash<QPsdChannelInfo::ChannelID, Private::Channel> channels;
+    {
+        QMutexLocker locker(&d->mutex);
+        channels = d->channels;
+    }
+    for (auto it = channels.constBegin(); it != channels.constEnd(); ++it) {
+        if (it.key() < QPsdChannelInfo::TransparencyMask)
+            continue;
+        const auto &channel = it.value();
+        if (!channel.isDecoded && channel.payload.isTruncated()) {
+            qWarning("QPsdChannelImageData: the memory-mapped document has been truncated");
+            continue;
+        }
+        // Channels set with setChannelData() cover the whole layer
+        const int columns = channel.payload.isNull() ? int(width()) : channel.columns;
+        const int rows = channel.payload.isNull() ? int(height()) : channel.rows;
+        const QByteArray data = channel.isDecoded
+            ? decodeRegion(channel.decoded.view(), RawData, columns, rows, 1, depth(), 0, bounds)
+            : decodeRegion(channel.payload.view(), channel.compression, columns, rows, 1, depth(), channel.countSize, bounds);
+        ret.setChannelData(it.key(), data);
+    }
+    return ret;
+}
+
+bool QPsdChannelImageData::isChannelDecoded(QPsdChannelInfo::ChannelID channelId) const
+{
+    QMutexLocker locker(&d->mutex);
+    const auto it = d->channels.constFind(channelId);
+    return it != d->channels.constEnd() && it->isDecoded;
+}
+
+void QPsdChannelImageData::releaseDecodedData()
+{
+    // Other threads may be decoding channels of the same data lazily
+    QMutexLocker locker(&d->mutex);
+    for (auto &channel : d->channels) {
+        // Channels set with setChannelData() have nothing to decode them from
+        if (channel.payload.isNull())
+            continue;
+        channel.decoded = QPsdByteSlice();
+        channel.isDecoded = false;
+    }
 }
 
 QPsdChannelImageData::Compression QPsdChannelImageData::channelCompression(QPsdChannelInfo::ChannelID channelId) const
@@ -160,13 +340,18 @@ void QPsdChannelImageData::setChannelCompression(QPsdChannelInfo::ChannelID chan
 
 #ifdef QT_PSD_RAW_ROUND_TRIP
 QByteArray QPsdChannelImageData::rawChannelBytes(QPsdChannelInfo::ChannelID channelId) const
+{
+    return d->rawChannelBytes.value(channelId).toByteArray();
+}
+
+QPsdByteSlice QPsdChannelImageData::rawChannelSlice(QPsdChannelInfo::ChannelID channelId) const
 {
     return d->rawChannelBytes.value(channelId);
 }
 
 void QPsdChannelImageData::setRawChannelBytes(QPsdChannelInfo::ChannelID channelId, const QByteArray &data)
 {
-    d->rawChannelBytes.insert(channelId, data);
+    d->rawChannelBytes.insert(channelId, QPsdByteSlice(data));
 }
 #endif
 
@@ -177,47 +362,47 @@ const unsigned char *QPsdChannelImageData::gray() const
 
 const unsigned char *QPsdChannelImageData::r() const
 {
-    return d->data(QPsdChannelInfo::Red);
+    return d->data(QPsdChannelInfo::Red, depth());
 }
 
 const unsigned char *QPsdChannelImageData::g() const
 {
-    return d->data(QPsdChannelInfo::Green);
+    return d->data(QPsdChannelInfo::Green, depth());
 }
 
 const unsigned char *QPsdChannelImageData::b() const
 {
-    return d->data(QPsdChannelInfo::Blue);
+    return d->data(QPsdChannelInfo::Blue, depth());
 }
 
 const unsigned char *QPsdChannelImageData::a() const
 {
     // Check for transparency mask first (channel -1), then alpha channel (channel 3)
-    const unsigned char *alpha = d->data(QPsdChannelInfo::TransparencyMask);
+    const unsigned char *alpha = d->data(QPsdChannelInfo::TransparencyMask, depth());
     if (!alpha) {
-        alpha = d->data(QPsdChannelInfo::Alpha);
+        alpha = d->data(QPsdChannelInfo::Alpha, depth());
     }
     return alpha;
 }
 
 const unsigned char *QPsdChannelImageData::c() const
 {
-    return d->data(QPsdChannelInfo::Red);    // Channel 0 = Cyan in CMYK
+    return d->data(QPsdChannelInfo::Red, depth());    // Channel 0 = Cyan in CMYK
 }
 
 const unsigned char *QPsdChannelImageData::m() const
 {
-    return d->data(QPsdChannelInfo::Green);  // Channel 1 = Magenta in CMYK
+    return d->data(QPsdChannelInfo::Green, depth());  // Channel 1 = Magenta in CMYK
 }
 
 const unsigned char *QPsdChannelImageData::y() const
 {
-    return d->data(QPsdChannelInfo::Blue);   // Channel 2 = Yellow in CMYK
+    return d->data(QPsdChannelInfo::Blue, depth());   // Channel 2 = Yellow in CMYK
 }
 
 const unsigned char *QPsdChannelImageData::k() const
 {
-    return d->data(QPsdChannelInfo::Alpha);  // Channel 3 = Key (Black) in CMYK
+    return d->data(QPsdChannelInfo::Alpha, depth());  // Channel 3 = Key (Black) in CMYK
 }
 
 QT_END_NAMESPACE
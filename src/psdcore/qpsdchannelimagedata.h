@@ -30,14 +30,40 @@ public:
     QByteArray channelData(QPsdChannelInfo::ChannelID channelId) const;
     void setChannelData(QPsdChannelInfo::ChannelID channelId, const QByteArray &data);
 
+    /*!
+     * Returns true if the channel has been decompressed already. Channels are
+     * decoded on first access, so parsing a document only costs the reads.
+     */
+    bool isChannelDecoded(QPsdChannelInfo::ChannelID channelId) const;
+
+    /*!
+     * Drops decoded pixels of this copy. They are decoded again on the next access.
+     */
+    void releaseDecodedData();
+
+    /*!
+     * Returns the pixels of \a rect, in layer coordinates, as a new image of
+     * the size of \a rect clipped to the layer. Only the scan lines covering
+     * \a rect are decoded. Mask channels have their own rectangle and are not
+     * part of the result.
+     */
+    QPsdChannelImageData region(const QRect &rect) const;
+
     Compression channelCompression(QPsdChannelInfo::ChannelID channelId) const;
     void setChannelCompression(QPsdChannelInfo::ChannelID channelId, Compression compression);
 
 #ifdef QT_PSD_RAW_ROUND_TRIP
     QByteArray rawChannelBytes(QPsdChannelInfo::ChannelID channelId) const;
+    // Same bytes as rawChannelBytes() without copying them out of a mapped file
+    QPsdByteSlice rawChannelSlice(QPsdChannelInfo::ChannelID channelId) const;
     void setRawChannelBytes(QPsdChannelInfo::ChannelID channelId, const QByteArray &data);
 #endif
 
+    /*!
+     * Decodes all channels that have not been decoded yet, concurrently.
+     */
+    void decodeChannels() const override;
+
 protected:
     const unsigned char *gray() const override;
     const unsigned char *r() const override;
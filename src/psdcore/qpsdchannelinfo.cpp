@@ -10,7 +10,7 @@ class QPsdChannelInfo::Private : public QSharedData
 public:
     Private();
     ChannelID id;
-    quint32 length;
+    quint64 length;
 };
 
 QPsdChannelInfo::Private::Private()
@@ -24,6 +24,10 @@ QPsdChannelInfo::QPsdChannelInfo()
 {}
 
 QPsdChannelInfo::QPsdChannelInfo(QIODevice *source)
+    : QPsdChannelInfo(source, readOptions(source))
+{}
+
+QPsdChannelInfo::QPsdChannelInfo(QIODevice *source, ReadOptions options)
     : QPsdChannelInfo()
 {
     // Channel information
@@ -34,7 +38,7 @@ QPsdChannelInfo::QPsdChannelInfo(QIODevice *source)
     d->id = static_cast<ChannelID>(readU16(source));
 
     // 4 bytes for length of corresponding channel data. (**PSB** 8 bytes for length of corresponding channel data.) See See Channel image data for structure of channel data.
-    d->length = readU32(source);
+    d->length = readLength(source, options);
 }
 
 QPsdChannelInfo::QPsdChannelInfo(const QPsdChannelInfo &other)
@@ -58,7 +62,7 @@ QPsdChannelInfo::ChannelID QPsdChannelInfo::id() const
     return d->id;
 }
 
-quint32 QPsdChannelInfo::length() const
+quint64 QPsdChannelInfo::length() const
 {
     return d->length;
 }
@@ -68,7 +72,7 @@ void QPsdChannelInfo::setId(ChannelID id)
     d->id = id;
 }
 
-void QPsdChannelInfo::setLength(quint32 length)
+void QPsdChannelInfo::setLength(quint64 length)
 {
     d->length = length;
 }
@@ -22,15 +22,16 @@ public:
     };
     QPsdChannelInfo();
     QPsdChannelInfo(QIODevice *source);
+    QPsdChannelInfo(QIODevice *source, ReadOptions options);
     QPsdChannelInfo(const QPsdChannelInfo &other);
     QPsdChannelInfo &operator=(const QPsdChannelInfo &other);
     ~QPsdChannelInfo() override;
 
     ChannelID id() const;
-    quint32 length() const;
+    quint64 length() const;
 
     void setId(ChannelID id);
-    void setLength(quint32 length);
+    void setLength(quint64 length);
 
 private:
     class Private;
@@ -0,0 +1,310 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qpsdcolortransform.h"
+#include "qpsdparallel_p.h"
+
+#include <QtCore/QtEndian>
+
+#include <array>
+#include <cmath>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// Grid node of a sample and the position between it and the next node,
+// 0 to 0x10000
+struct Step
+{
+    quint32 node;
+    quint32 fraction;
+};
+
+Step step(quint32 sample, quint32 maxSample, int gridSize)
+{
+    const quint32 t = sample * quint32(gridSize - 1);
+    Step ret { t / maxSample, quint32((quint64(t % maxSample) << 16) / maxSample) };
+    // The last node has no neighbour, interpolate towards it from the one before
+    if (ret.node == quint32(gridSize - 1)) {
+        --ret.node;
+        ret.fraction = 0x10000;
+    }
+    return ret;
+}
+
+// Blends the corners of the tetrahedron of the grid cell at base that holds
+// the point (fx, fy, fz). The weights add up to 0x10000, so the sums of the
+// 8.8 fixed point nodes stay within 32 bits.
+inline void tetrahedral(const quint16 *base, qsizetype sx, qsizetype sy, qsizetype sz,
+                        quint32 fx, quint32 fy, quint32 fz, quint32 *rgb)
+{
+    const quint16 *c1;
+    const quint16 *c2;
+    quint32 f0, f1, f2;
+    if (fx >= fy) {
+        if (fy >= fz) {
+            c1 = base + sx; c2 = base + sx + sy; f0 = fx; f1 = fy; f2 = fz;
+        } else if (fx >= fz) {
+            c1 = base + sx; c2 = base + sx + sz; f0 = fx; f1 = fz; f2 = fy;
+        } else {
+            c1 = base + sz; c2 = base + sx + sz; f0 = fz; f1 = fx; f2 = fy;
+        }
+    } else {
+        if (fz >= fy) {
+            c1 = base + sz; c2 = base + sy + sz; f0 = fz; f1 = fy; f2 = fx;
+        } else if (fz >= fx) {
+            c1 = base + sy; c2 = base + sy + sz; f0 = fy; f1 = fz; f2 = fx;
+        } else {
+            c1 = base + sy; c2 = base + sx + sy; f0 = fy; f1 = fx; f2 = fz;
+        }
+    }
+    const quint16 *c3 = base + sx + sy + sz;
+    const quint32 w0 = 0x10000 - f0;
+    const quint32 w1 = f0 - f1;
+    const quint32 w2 = f1 - f2;
+    const quint32 w3 = f2;
+    for (int i = 0; i < 3; ++i)
+        rgb[i] = base[i] * w0 + c1[i] * w1 + c2[i] * w2 + c3[i] * w3;
+}
+
+// Linear light is stored in the Lab grid from -0.5 to 1.5, so that cells on
+// the edge of the sRGB gamut interpolate towards the real colors outside of
+// it instead of towards clipped ones
+constexpr double linearMin = -0.5;
+constexpr double linearRange = 2.0;
+
+// PSD Lab is relative to D50, see also QPsdColorSpace::toString(). Returns
+// linear sRGB, the sRGB curve is applied after interpolation where it is
+// steep near black.
+void labToLinearSRgb(double L, double a, double b, double *rgb)
+{
+    const double fy = (L + 16.0) / 116.0;
+    const double fx = fy + a / 500.0;
+    const double fz = fy - b / 200.0;
+    const double e = 216.0 / 24389.0;
+    const double k = 24389.0 / 27.0;
+    const auto finv = [&](double f) {
+        const double f3 = f * f * f;
+        return f3 > e ? f3 : (116.0 * f - 16.0) / k;
+    };
+    const double X = finv(fx) * 0.96422;
+    const double Y = finv(fy);
+    const double Z = finv(fz) * 0.82521;
+
+    // Bradford chromatic adaptation D50 -> D65
+    const double X2 = 0.9555766 * X - 0.0230393 * Y + 0.0631636 * Z;
+    const double Y2 = -0.0282895 * X + 1.0099416 * Y + 0.0210077 * Z;
+    const double Z2 = 0.0122982 * X - 0.0204830 * Y + 1.3299098 * Z;
+
+    rgb[0] = 3.2404542 * X2 - 1.5371385 * Y2 - 0.4985314 * Z2;
+    rgb[1] = -0.9692660 * X2 + 1.8760108 * Y2 + 0.0415560 * Z2;
+    rgb[2] = 0.0556434 * X2 - 0.2040259 * Y2 + 1.0572252 * Z2;
+}
+
+double sRgbCurve(double linear)
+{
+    const double c = qBound(0.0, linear, 1.0);
+    return c <= 0.0031308 ? 12.92 * c : 1.055 * std::pow(c, 1.0 / 2.4) - 0.055;
+}
+
+} // namespace
+
+class QPsdColorTransform::Private : public QSharedData
+{
+public:
+    int inputs = 0;
+    int gridSize = 0;
+    // R, G and B of every node in 8.8 fixed point, so that one more 8-bit
+    // fraction is kept through the interpolation
+    QList<quint16> nodes;
+    // Distance between neighbouring nodes along each input, in quint16s
+    std::array<qsizetype, 4> strides = {};
+    // The 1D part of the lookup: grid step of every 8-bit sample
+    std::array<Step, 256> steps8 = {};
+    // Output byte of every interpolated 8.8 value >> 2, if the nodes are not
+    // the output bytes themselves
+    QList<uchar> curve;
+
+    uchar output(quint32 sum) const
+    {
+        // sum is an 8.8 node value times the 16-bit weights
+        return curve.isEmpty() ? uchar((sum + (1 << 23)) >> 24) : curve.at((sum + (1 << 17)) >> 18);
+    }
+
+    template <typename Sample>
+    void mapPixel(Sample sample, uchar *rgb) const;
+};
+
+// Interpolates the color of the pixel whose grid steps sample(i) returns
+template <typename Sample>
+inline void QPsdColorTransform::Private::mapPixel(Sample sample, uchar *rgb) const
+{
+    const Step s0 = sample(0);
+    const Step s1 = sample(1);
+    const Step s2 = sample(2);
+    const quint16 *base = nodes.constData()
+        + s0.node * strides[0] + s1.node * strides[1] + s2.node * strides[2];
+    quint32 sum[3];
+    if (inputs == 3) {
+        tetrahedral(base, strides[0], strides[1], strides[2], s0.fraction, s1.fraction, s2.fraction, sum);
+        for (int i = 0; i < 3; ++i)
+            rgb[i] = output(sum[i]);
+        return;
+    }
+
+    // Tetrahedral in the first three inputs, linear between the two
+    // cubes along the fourth
+    const Step s3 = sample(3);
+    base += s3.node * strides[3];
+    quint32 next[3];
+    tetrahedral(base, strides[0], strides[1], strides[2], s0.fraction, s1.fraction, s2.fraction, sum);
+    tetrahedral(base + strides[3], strides[0], strides[1], strides[2], s0.fraction, s1.fraction, s2.fraction, next);
+    for (int i = 0; i < 3; ++i) {
+        const quint32 c0 = (sum[i] + 0x8000) >> 16;
+        const quint32 c1 = (next[i] + 0x8000) >> 16;
+        rgb[i] = output(c0 * (0x10000 - s3.fraction) + c1 * s3.fraction);
+    }
+}
+
+QPsdColorTransform::QPsdColorTransform()
+{}
+
+QPsdColorTransform::QPsdColorTransform(int inputs, int gridSize, const QList<quint16> &nodes)
+{
+    if (inputs < 3 || inputs > 4 || gridSize < 2)
+        return;
+    qsizetype count = 3;
+    for (int i = 0; i < inputs; ++i)
+        count *= gridSize;
+    if (nodes.size() != count) {
+        qWarning("QPsdColorTransform: expected %lld nodes, got %lld", qlonglong(count), qlonglong(nodes.size()));
+        return;
+    }
+
+    d = new Private;
+    d->inputs = inputs;
+    d->gridSize = gridSize;
+    d->nodes.resize(count);
+    for (qsizetype i = 0; i < count; ++i)
+        d->nodes[i] = quint16((quint32(nodes.at(i)) * 0xff00 + 0x7fff) / 0xffff);
+    qsizetype stride = 3;
+    for (int i = inputs - 1; i >= 0; --i) {
+        d->strides[i] = stride;
+        stride *= gridSize;
+    }
+    for (quint32 v = 0; v < 256; ++v)
+        d->steps8[v] = step(v, 0xff, gridSize);
+}
+
+QPsdColorTransform::QPsdColorTransform(const QPsdColorTransform &other)
+    : d(other.d)
+{}
+
+QPsdColorTransform &QPsdColorTransform::operator=(const QPsdColorTransform &other)
+{
+    d = other.d;
+    return *this;
+}
+
+QPsdColorTransform::~QPsdColorTransform() = default;
+
+bool QPsdColorTransform::isValid() const
+{
+    return d.data() != nullptr;
+}
+
+int QPsdColorTransform::inputs() const
+{
+    return d ? d->inputs : 0;
+}
+
+int QPsdColorTransform::gridSize() const
+{
+    return d ? d->gridSize : 0;
+}
+
+QPsdColorTransform QPsdColorTransform::labToSRgb()
+{
+    static const QPsdColorTransform transform = [] {
+        // Linear light is smooth enough in Lab for a coarse grid, with nodes
+        // about eight 8-bit sample values apart
+        constexpr int gridSize = 33;
+        QList<quint16> nodes;
+        nodes.reserve(gridSize * gridSize * gridSize * 3);
+        for (int l = 0; l < gridSize; ++l) {
+            for (int a = 0; a < gridSize; ++a) {
+                for (int b = 0; b < gridSize; ++b) {
+                    const auto position = [](int node) { return double(node) / (gridSize - 1); };
+                    double rgb[3];
+                    labToLinearSRgb(position(l) * 100.0, position(a) * 255.0 - 128.0,
+                                    position(b) * 255.0 - 128.0, rgb);
+                    for (double c : rgb)
+                        nodes.append(quint16(qRound(qBound(0.0, (c - linearMin) / linearRange, 1.0) * 0xffff)));
+                }
+            }
+        }
+        QPsdColorTransform ret(3, gridSize, nodes);
+        ret.d->curve.resize((0xff00 >> 2) + 1);
+        for (qsizetype i = 0; i < ret.d->curve.size(); ++i) {
+            const double linear = double(i << 2) / 0xff00 * linearRange + linearMin;
+            ret.d->curve[i] = uchar(qRound(sRgbCurve(linear) * 255));
+        }
+        return ret;
+    }();
+    return transform;
+}
+
+void QPsdColorTransform::map(const uchar *src, qsizetype srcBytesPerLine, uchar *dst, qsizetype dstBytesPerLine,
+                             int width, int height) const
+{
+    if (!d)
+        return;
+    const int inputs = d->inputs;
+    psdParallelForBlocks(height, 16, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype y = begin; y < end; ++y) {
+            const uchar *in = src + y * srcBytesPerLine;
+            auto *out = reinterpret_cast<quint32 *>(dst + y * dstBytesPerLine);
+            for (int x = 0; x < width; ++x) {
+                // Read all of the pixel before it is overwritten
+                uchar rgb[3];
+                d->mapPixel([&](int i) { return d->steps8[in[x * inputs + i]]; }, rgb);
+                out[x] = 0xff000000u | quint32(rgb[0]) << 16 | quint32(rgb[1]) << 8 | rgb[2];
+            }
+        }
+    });
+}
+
+void QPsdColorTransform::mapPlanes(const uchar *const *planes, int depth, bool invert,
+                                   uchar *dst, int dstBytesPerPixel, qsizetype count) const
+{
+    const auto store = [&](qsizetype x, const uchar *rgb) {
+        if (dstBytesPerPixel == 3) {
+            dst[x * 3 + 0] = rgb[0];
+            dst[x * 3 + 1] = rgb[1];
+            dst[x * 3 + 2] = rgb[2];
+        } else {
+            reinterpret_cast<quint32 *>(dst)[x] = 0xff000000u | quint32(rgb[0]) << 16 | quint32(rgb[1]) << 8 | rgb[2];
+        }
+    };
+    uchar rgb[3];
+    if (depth == 16) {
+        // 16-bit samples are interpolated at full precision
+        const quint16 mask = invert ? 0xffff : 0;
+        const int gridSize = d->gridSize;
+        for (qsizetype x = 0; x < count; ++x) {
+            d->mapPixel([&](int i) {
+                return step(qFromBigEndian<quint16>(planes[i] + x * 2) ^ mask, 0xffff, gridSize);
+            }, rgb);
+            store(x, rgb);
+        }
+    } else {
+        const uchar mask = invert ? 0xff : 0;
+        for (qsizetype x = 0; x < count; ++x) {
+            d->mapPixel([&](int i) { return d->steps8[planes[i][x] ^ mask]; }, rgb);
+            store(x, rgb);
+        }
+    }
+}
+
+QT_END_NAMESPACE
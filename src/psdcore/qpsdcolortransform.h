@@ -0,0 +1,67 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPSDCOLORTRANSFORM_H
+#define QPSDCOLORTRANSFORM_H
+
+#include <QtPsdCore/qpsdcoreglobal.h>
+
+#include <QtCore/QList>
+#include <QtCore/QSharedData>
+
+QT_BEGIN_NAMESPACE
+
+class QPsdAbstractImage;
+
+class Q_PSDCORE_EXPORT QPsdColorTransform
+{
+public:
+    QPsdColorTransform();
+    /*!
+     * Creates a transform from 3 (Lab) or 4 (CMYK) inputs to sRGB. \a nodes
+     * holds the 16-bit R, G and B of each of the gridSize^inputs points of
+     * an evenly spaced grid over the inputs, the last input varying fastest.
+     * Colors between the grid points are interpolated tetrahedrally.
+     */
+    QPsdColorTransform(int inputs, int gridSize, const QList<quint16> &nodes);
+    QPsdColorTransform(const QPsdColorTransform &other);
+    QPsdColorTransform &operator=(const QPsdColorTransform &other);
+    QT_MOVE_ASSIGNMENT_OPERATOR_IMPL_VIA_PURE_SWAP(QPsdColorTransform)
+    void swap(QPsdColorTransform &other) noexcept { d.swap(other.d); }
+    ~QPsdColorTransform();
+
+    bool isValid() const;
+    int inputs() const;
+    int gridSize() const;
+
+    /*!
+     * Returns the transform from Lab as stored in documents (D50, L scaled
+     * to the full sample range, a and b offset by half of it) to sRGB. It is
+     * built on first use and shared afterwards.
+     */
+    static QPsdColorTransform labToSRgb();
+
+    /*!
+     * Converts \a width x \a height pixels of inputs() interleaved 8-bit
+     * samples (0 = no ink for CMYK) into 0xffRRGGBB pixels. \a src and
+     * \a dst may be the same buffer when there are 4 inputs.
+     */
+    void map(const uchar *src, qsizetype srcBytesPerLine, uchar *dst, qsizetype dstBytesPerLine,
+             int width, int height) const;
+
+private:
+    friend class QPsdAbstractImage;
+    // Converts one row of planar 8 or 16-bit big-endian samples into R, G, B
+    // bytes or 0xffRRGGBB pixels, inverting the samples first if asked to
+    void mapPlanes(const uchar *const *planes, int depth, bool invert,
+                   uchar *dst, int dstBytesPerPixel, qsizetype count) const;
+
+    class Private;
+    QExplicitlySharedDataPointer<Private> d;
+};
+
+Q_DECLARE_SHARED(QPsdColorTransform)
+
+QT_END_NAMESPACE
+
+#endif // QPSDCOLORTRANSFORM_H
@@ -18,8 +18,7 @@ class QPsdDescriptor::Private : public QSharedData
 public:
     QString name;
     QByteArray classID;
-    QHash<QByteArray, QVariant> data;
-    QList<QByteArray> keyOrder;
+    QPsdDescriptorData data;
     QByteArray rawData;
     void parse(QIODevice *source, quint32 *length);
 };
@@ -47,9 +46,8 @@ void QPsdDescriptor::Private::parse(QIODevice *source, quint32 *length)
         // load plugin for osType
         auto plugin = QPsdDescriptorPlugin::plugin(osType);
         if (plugin) {
-            auto value = plugin->parse(source, length);
+            auto value = plugin->parse(osType, source, length);
             data.insert(key, value);
-            keyOrder.append(key);
             if (value.typeId() == QMetaType::QByteArray) {
                 value = value.toByteArray().left(20);
             }
@@ -126,24 +124,33 @@ void QPsdDescriptor::setClassID(const QByteArray &classID)
     d->classID = classID;
 }
 
-QHash<QByteArray, QVariant> QPsdDescriptor::data() const
+QPsdDescriptorData QPsdDescriptor::data() const
 {
     return d->data;
 }
 
-void QPsdDescriptor::setData(const QHash<QByteArray, QVariant> &data)
+void QPsdDescriptor::setData(const QPsdDescriptorData &data)
 {
     d->data = data;
 }
 
 QList<QByteArray> QPsdDescriptor::keyOrder() const
 {
-    return d->keyOrder;
+    return d->data.keys();
 }
 
 void QPsdDescriptor::setKeyOrder(const QList<QByteArray> &keyOrder)
 {
-    d->keyOrder = keyOrder;
+    QPsdDescriptorData data;
+    for (const auto &key : keyOrder) {
+        if (d->data.contains(key) && !data.contains(key))
+            data.insert(key, d->data.value(key));
+    }
+    for (auto it = d->data.cbegin(); it != d->data.cend(); ++it) {
+        if (!data.contains(it.key()))
+            data.insert(it.key(), it.value());
+    }
+    d->data = data;
 }
 
 QByteArray QPsdDescriptor::rawData() const
@@ -295,14 +302,10 @@ void QPsdDescriptor::write(QIODevice *dest) const
     // Item count
     writeS32(dest, d->data.size());
 
-    // Items — use keyOrder for deterministic output matching original parse order
-    const auto &keys = d->keyOrder.isEmpty()
-        ? d->data.keys()
-        : d->keyOrder;
-    for (const auto &key : keys) {
-        if (!d->data.contains(key))
-            continue;
-        const auto &value = d->data.value(key);
+    // Items, in the order they were parsed or inserted
+    for (auto it = d->data.cbegin(); it != d->data.cend(); ++it) {
+        const auto &key = it.key();
+        const auto &value = it.value();
         // Key: S32(size) + bytes. Size 0 means exactly 4 bytes.
         writeS32(dest, key.size() == 4 ? 0 : key.size());
         writeByteArray(dest, key);
@@ -5,9 +5,14 @@
 #define QPSDDESCRIPTOR_H
 
 #include <QtPsdCore/qpsdsection.h>
+#include <QtPsdCore/qpsdfourccmap.h>
 
 QT_BEGIN_NAMESPACE
 
+// Descriptor keys are usually four characters but may be of any length, so
+// they stay byte arrays; lookups by literal still build no temporary key
+using QPsdDescriptorData = QPsdFlatMap<QByteArray, QVariant, QByteArrayView>;
+
 class Q_PSDCORE_EXPORT QPsdDescriptor : public QPsdSection
 {
 public:
@@ -23,9 +28,12 @@ public:
     void setName(const QString &name);
     QByteArray classID() const;
     void setClassID(const QByteArray &classID);
-    QHash<QByteArray, QVariant> data() const;
-    void setData(const QHash<QByteArray, QVariant> &data);
+    QPsdDescriptorData data() const;
+    void setData(const QPsdDescriptorData &data);
     QList<QByteArray> keyOrder() const;
+    // data() keeps the order the items were inserted in. This moves the
+    // listed keys to the front, for code written against the old key list.
+    Q_DECL_DEPRECATED_X("Insert the items of data() in the order to write them")
     void setKeyOrder(const QList<QByteArray> &keyOrder);
     QByteArray rawData() const;
     void setRawData(const QByteArray &rawData);
@@ -17,7 +17,10 @@ class Q_PSDCORE_EXPORT QPsdDescriptorPlugin : public QPsdAbstractPlugin
 public:
     explicit QPsdDescriptorPlugin(QObject *parent = nullptr);
 
-    virtual QVariant parse(QIODevice *source, quint32 *length) const = 0;
+    /*!
+     * Parses the item stored under \a key from \a source.
+     */
+    virtual QVariant parse(QByteArrayView key, QIODevice *source, quint32 *length) const = 0;
 
     static QByteArrayList keys() {
         return QPsdAbstractPlugin::keys<QPsdDescriptorPlugin>(QPsdDescriptorFactoryInterface_iid, "psddescriptor");
@@ -17,6 +17,9 @@ class Q_PSDCORE_EXPORT QPsdEffectsLayerPlugin : public QPsdAbstractPlugin
 public:
     explicit QPsdEffectsLayerPlugin(QObject *parent = nullptr);
 
+    /*!
+     * Parses the effect stored under \a key from \a source.
+     */
     virtual QVariant parse(QByteArrayView key, QIODevice *source, quint32 *length) const = 0;
 
     static QByteArrayList keys() {
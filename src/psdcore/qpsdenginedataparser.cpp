@@ -7,11 +7,96 @@
 #include <QtCore/qcbormap.h>
 #include <QtCore/qcborarray.h>
 #include <QtCore/QStringEncoder>
+#include <QtCore/QVarLengthArray>
+#include <QtCore/qendian.h>
+#include <QtCore/qnumeric.h>
+#include <QtCore/private/qsimd_p.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
 
 QT_BEGIN_NAMESPACE
 
+namespace {
+// EngineData は PDF に似たテキスト形式で、インデント用の空白やタブが大半を
+// 占めます。空白の読み飛ばしと区切り文字の検索は 16 バイト単位で行います。
+
+inline bool isSpace(uchar ch)
+{
+    // QChar::fromLatin1(ch).isSpace() と同じ集合
+    return ch == ' ' || (ch >= '\t' && ch <= '\r') || ch == 0x85 || ch == 0xa0;
+}
+
+inline bool isNameChar(uchar ch)
+{
+    if (ch < 0x80)
+        return (ch >= '0' && ch <= '9') || ((ch | 0x20) >= 'a' && (ch | 0x20) <= 'z');
+    return QChar::fromLatin1(char(ch)).isLetterOrNumber();
+}
+
+const char *skipSpaces(const char *p, const char *end)
+{
+#ifdef __SSE2__
+    const __m128i tab = _mm_set1_epi8('\t');
+    const __m128i four = _mm_set1_epi8(4);
+    const __m128i space = _mm_set1_epi8(' ');
+    while (end - p >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        // '\t'..'\r' は v - '\t' が符号なしで 4 以下
+        const __m128i control = _mm_sub_epi8(v, tab);
+        const __m128i isControl = _mm_cmpeq_epi8(_mm_min_epu8(control, four), control);
+        const __m128i isBlank = _mm_or_si128(isControl, _mm_cmpeq_epi8(v, space));
+        const uint mask = uint(_mm_movemask_epi8(isBlank));
+        if (mask != 0xffff) {
+            p += qCountTrailingZeroBits(~mask);
+            break;
+        }
+        p += 16;
+    }
+#endif
+    while (p < end && isSpace(uchar(*p)))
+        ++p;
+    return p;
+}
+
+// [p, end) の中で Chars のいずれかに最初に一致する位置、なければ end
+template <char... Chars>
+const char *findFirstOf(const char *p, const char *end)
+{
+#ifdef __SSE2__
+    while (end - p >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        __m128i hit = _mm_setzero_si128();
+        ((hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8(Chars)))), ...);
+        const uint mask = uint(_mm_movemask_epi8(hit));
+        if (mask)
+            return p + qCountTrailingZeroBits(mask);
+        p += 16;
+    }
+#endif
+    while (p < end && ((*p != Chars) && ...))
+        ++p;
+    return p;
+}
+
+QString fromUtf16BE(QByteArrayView data)
+{
+    QString ret(data.size() / 2, Qt::Uninitialized);
+    qFromBigEndian<char16_t>(data.data(), ret.size(), ret.data());
+    // QStringDecoder と同様に先頭の BOM は取り除く
+    if (ret.startsWith(QChar::ByteOrderMark))
+        ret.remove(0, 1);
+    return ret;
+}
+} // namespace
+
 /**
  * @brief QPsdEngineDataParser::Private クラスは、EngineData のパース処理を担当します。
+ *
+ * 入力バッファをポインタで走査し、プロパティ名や文字列は入力上の範囲のまま扱います。
+ * subtrees が指定された場合、その経路上の辞書と指定されたサブツリーだけを構築し、
+ * それ以外の値は元のテキストのまま RawValueTag でタグ付けして保持します。
  */
 class QPsdEngineDataParser::Private
 {
@@ -19,9 +104,20 @@ public:
     /**
      * @brief コンストラクタ
      * @param data パース対象のデータ
+     * @param subtrees 構築するサブツリーの経路（'/' 区切り）。空の場合はすべて構築します。
      */
-    Private(const QByteArray &data)
-        : m_data(data), m_pos(0), m_length(data.length()) {}
+    Private(const QByteArray &data, const QByteArrayList &subtrees = {})
+        : m_begin(data.constData())
+        , m_end(data.constData() + data.size())
+        , m_pos(m_begin)
+    {
+        m_subtrees.reserve(subtrees.size());
+        for (const auto &subtree : subtrees) {
+            const auto components = subtree.split('/');
+            if (!subtree.isEmpty())
+                m_subtrees.append(components);
+        }
+    }
 
     /**
      * @brief パース処理の開始
@@ -36,15 +132,15 @@ public:
             return error("EngineData must start with '<<'"_L1);
 
         // 辞書のパース
-        ParseError dictError = parseDictionary(map);
+        ParseError dictError = parseDictionary(map, m_subtrees.isEmpty() ? Build : Partial);
         if (dictError)
             return dictError;
 
         skipWhitespace();
 
         // データの終端確認
-        if (m_pos != m_length) {
-            qDebug() << m_pos << m_length;
+        if (m_pos != m_end) {
+            qDebug() << m_pos - m_begin << m_end - m_begin;
             return error(u"辞書の終了後に予期せぬデータが存在します。"_s);
         }
 
@@ -53,38 +149,34 @@ public:
     }
 
 private:
-    const QByteArray &m_data;    ///< 入力データ
-    int m_pos;                ///< 現在のパース位置
-    int m_length;             ///< データの長さ
-
     /**
-     * @brief 次の文字を取得します。
-     * @return 取得した char。エラーの場合は 0 を返します。
+     * @brief 値をどこまで構築するか
      */
-    char getNextChar() {
-        if (m_pos >= m_length)
-            return 0;
-
-        return m_data.at(m_pos++);
-    }
+    enum Selection {
+        Skip,    ///< 元のテキストのまま保持する
+        Partial, ///< 辞書のうち指定されたサブツリーに至るキーだけを構築する
+        Build,   ///< すべて構築する
+    };
+
+    const char *const m_begin;  ///< 入力データの先頭
+    const char *const m_end;    ///< 入力データの終端
+    const char *m_pos;          ///< 現在のパース位置
+    QList<QByteArrayList> m_subtrees;           ///< 構築するサブツリーの経路
+    QVarLengthArray<QByteArrayView, 8> m_path;  ///< Partial な辞書の現在の経路
 
     /**
      * @brief 次の文字を先読みします。
      * @return 先読みした char。エラーの場合は 0 を返します。
      */
     char peekNextChar() const {
-        if (m_pos >= m_length)
-            return 0;
-
-        return m_data.at(m_pos);
+        return m_pos < m_end ? *m_pos : 0;
     }
 
     /**
      * @brief ホワイトスペースをスキップします。
      */
     void skipWhitespace() {
-        while (m_pos < m_length && QChar::fromLatin1(m_data.at(m_pos)).isSpace())
-            ++m_pos;
+        m_pos = skipSpaces(m_pos, m_end);
     }
 
     /**
@@ -92,32 +184,48 @@ private:
      * @param str 照合する文字列。
      * @return 一致した場合は true、そうでない場合は false。
      */
-    bool matchString(const QByteArray &str) {
-        if (m_pos + str.length() > m_length)
+    bool matchString(QByteArrayView str) {
+        if (m_end - m_pos < str.size() || memcmp(m_pos, str.data(), str.size()) != 0)
             return false;
+        m_pos += str.size();
+        return true;
+    }
 
-        const auto substring = m_data.mid(m_pos, str.length());
-        if (substring == str) {
-            m_pos += str.length();
-            return true;
+    /**
+     * @brief 現在の経路の下にあるキー name をどこまで構築するかを決めます。
+     * @param name キー名
+     * @return name の値の Selection
+     */
+    Selection select(QByteArrayView name) const {
+        Selection ret = Skip;
+        const qsizetype depth = m_path.size();
+        for (const auto &subtree : m_subtrees) {
+            if (subtree.size() <= depth || subtree.at(depth) != name)
+                continue;
+            if (!std::equal(m_path.cbegin(), m_path.cend(), subtree.cbegin()))
+                continue;
+            if (subtree.size() == depth + 1)
+                return Build;
+            ret = Partial;
         }
-        return false;
+        return ret;
     }
 
     /**
      * @brief 辞書をパースします（'<<' と '>>' で囲まれた部分）。
      * @param map パース結果を格納する QCborMap のポインタ。
+     * @param selection 辞書の中身をどこまで構築するか。
      * @return パースに失敗した場合はエラーメッセージを持つ ParseError を返します。成功した場合は空の ParseError を返します。
      */
-    ParseError parseDictionary(QCborMap* map) {
-        while (m_pos < m_length) {
+    ParseError parseDictionary(QCborMap* map, Selection selection) {
+        while (m_pos < m_end) {
             skipWhitespace();
 
             char ch = peekNextChar();
-            if (QChar::fromLatin1(ch).isNull())
+            if (ch == 0)
                 return error("Unexpected end of data while parsing dictionary"_L1);
 
-            if (ch == '>'_L1) {
+            if (ch == '>') {
                 // '>>' の確認
                 if (!matchString(">>"))
                     return error("Invalid dictionary end '>>'"_L1);
@@ -125,19 +233,36 @@ private:
             }
 
             // プロパティ名のパース
-            QString key;
-            ParseError keyError = parsePropertyName(&key);
+            QByteArrayView name;
+            ParseError keyError = parsePropertyName(&name);
             if (keyError)
                 return keyError;
 
             // 値のパース
             QCborValue value;
-            ParseError valueError = parseValue(&value);
-            if (valueError)
-                return valueError;
+            const Selection valueSelection = selection == Build ? Build : select(name);
+            if (valueSelection == Skip) {
+                ParseError rawError = parseRawValue(&value);
+                if (rawError)
+                    return rawError;
+            } else {
+                if (selection == Partial)
+                    m_path.append(name);
+                ParseError valueError = parseValue(&value, valueSelection);
+                if (selection == Partial)
+                    m_path.removeLast();
+                if (valueError)
+                    return valueError;
+            }
 
             // マップに挿入
-            map->insert(key, value);
+            bool isAscii = true;
+            for (const char c : name)
+                isAscii = isAscii && uchar(c) < 0x80;
+            if (isAscii)
+                map->insert(QLatin1StringView(name), value);
+            else
+                map->insert(QString::fromUtf8(name), value);
         }
 
         // 到達しないはず
@@ -146,73 +271,118 @@ private:
 
     /**
      * @brief プロパティ名をパースします（'/' で始まる）。
-     * @param key パースしたプロパティ名を格納する QString のポインタ。
+     * @param name プロパティ名の入力データ上の範囲を格納する QByteArrayView のポインタ。
      * @return パースに失敗した場合はエラーメッセージを持つ ParseError を返します。成功した場合は空の ParseError を返します。
      */
-    ParseError parsePropertyName(QString* key) {
-        char ch = getNextChar();
-        if (ch != '/')
+    ParseError parsePropertyName(QByteArrayView* name) {
+        if (peekNextChar() != '/')
             return error("Property name must start with '/'"_L1);
+        const char *start = ++m_pos;
+        while (m_pos < m_end && isNameChar(uchar(*m_pos)))
+            ++m_pos;
 
-        QByteArray keyStr;
-        while (m_pos < m_length) {
-            ch = peekNextChar();
-            if (QChar::fromLatin1(ch).isNull() || !QChar::fromLatin1(ch).isLetterOrNumber())
-                break;
-            keyStr += getNextChar();
-        }
-
-        if (keyStr.isEmpty())
+        if (m_pos == start)
             return error("Property name is empty"_L1);
 
-        *key = QString::fromUtf8(keyStr);
+        *name = QByteArrayView(start, m_pos);
+        return success(); // 成功
+    }
+
+    /**
+     * @brief 値を構築せずに読み飛ばし、元のテキストを RawValueTag 付きで返します。
+     * @param value 結果を格納する QCborValue のポインタ。
+     * @return パースに失敗した場合はエラーメッセージを持つ ParseError を返します。成功した場合は空の ParseError を返します。
+     */
+    ParseError parseRawValue(QCborValue* value) {
+        skipWhitespace();
+        const char *start = m_pos;
+
+        const char ch = peekNextChar();
+        if (ch == 0)
+            return error("Unexpected end of data while parsing value"_L1);
+
+        if (ch == '(') {
+            skipString();
+        } else if (ch == '<' || ch == '[') {
+            // 文字列の外では括弧の対応だけを数える。'<<' と '>>' は 2 つずつ数えても釣り合う
+            qsizetype depth = 0;
+            do {
+                m_pos = findFirstOf<'(', '<', '>', '[', ']'>(m_pos, m_end);
+                if (m_pos == m_end)
+                    return error("Unexpected end of data while parsing value"_L1);
+                switch (*m_pos) {
+                case '(':
+                    skipString();
+                    break;
+                case '<':
+                case '[':
+                    ++depth;
+                    ++m_pos;
+                    break;
+                default:
+                    --depth;
+                    ++m_pos;
+                    break;
+                }
+            } while (depth > 0);
+        } else {
+            // 数値またはブール値
+            while (m_pos < m_end && !isSpace(uchar(*m_pos)) && !strchr("()<>[]/", *m_pos))
+                ++m_pos;
+            if (m_pos == start)
+                return error("Invalid value type"_L1);
+        }
+
+        *value = QCborValue(RawValueTag, QByteArray(start, m_pos - start));
         return success(); // 成功
     }
 
     /**
      * @brief 値をパースします。
      * @param value パースした値を格納する QCborValue のポインタ。
+     * @param selection 辞書の値をどこまで構築するか。
      * @return パースに失敗した場合はエラーメッセージを持つ ParseError を返します。成功した場合は空の ParseError を返します。
      */
-    ParseError parseValue(QCborValue* value) {
+    ParseError parseValue(QCborValue* value, Selection selection) {
         skipWhitespace();
 
         char ch = peekNextChar();
-        if (QChar::fromLatin1(ch).isNull())
+        if (ch == 0)
             return error("Unexpected end of data while parsing value"_L1);
 
-        if (ch == '<'_L1) { // 辞書
+        if (ch == '<') { // 辞書
             // '<<' の確認
             if (!matchString("<<"))
                 return error("Invalid dictionary start '<<'"_L1);
 
             QCborMap subMap;
-            ParseError dictError = parseDictionary(&subMap);
+            ParseError dictError = parseDictionary(&subMap, selection);
             if (dictError)
                 return dictError;
 
             *value = QCborValue(subMap);
             return success(); // 成功
-        } else if (ch == '['_L1) { // 配列
+        } else if (ch == '[') { // 配列
             // '[' の消費
-            getNextChar(); // '['
+            ++m_pos;
 
+            // 配列は要素ごとに絞り込まず、すべて構築する
             QCborArray array;
-            while (m_pos < m_length) {
+            while (m_pos < m_end) {
                 skipWhitespace();
 
                 ch = peekNextChar();
-                if (QChar::fromLatin1(ch).isNull())
+                if (ch == 0)
                     return error(u"配列のパース中に予期せぬデータの終端に到達しました。"_s);
 
-                if (ch == ']'_L1) { // 配列の終了
-                    getNextChar(); // ']'
+                if (ch == ']') { // 配列の終了
+                    ++m_pos;
                     break;
                 }
 
                 // 配列要素のパース
                 QCborValue element;
-                ParseError elementError = parseValue(&element);
+                ParseError elementError = parseValue(&element, Build);
                 if (elementError)
                     return elementError;
 
@@ -221,121 +391,98 @@ private:
 
             *value = QCborValue(array);
             return success(); // 成功
-        } else if (ch == '('_L1) { // 文字列
-            QString str;
-            ParseError strError = parseString(&str);
-            if (strError)
-                return strError;
-
-            *value = QCborValue(str);
-            return success(); // 成功
-        } else if (QChar::fromLatin1(ch).toLower() == 't'_L1 || QChar::fromLatin1(ch).toLower() == 'f'_L1) { // ブール値
-            QByteArray boolStr;
-            ParseError boolError = parseBoolean(&boolStr);
-            if (boolError)
-                return boolError;
-
-            if (boolStr == "true") {
-                *value = QCborValue(true);
-                return success(); // 成功
-            } else if (boolStr == "false") {
-                *value = QCborValue(false);
-                return success(); // 成功
-            }
-            return error(u"無効なブール値です。"_s);
+        } else if (ch == '(') { // 文字列
+            return parseString(value);
+        } else if ((ch | 0x20) == 't' || (ch | 0x20) == 'f') { // ブール値
+            return parseBoolean(value);
         } else { // 数値
-            QByteArray numStr;
-            ParseError numError = parseNumber(&numStr);
-            if (numError)
-                return numError;
-
-            bool ok = false;
-            double num = numStr.toDouble(&ok);
-            if (!ok)
-                return error("Invalid number format: '%1'"_L1.arg(numStr));
-
-            if (numStr.contains('.')) {
-                *value = QCborValue(num);
-            } else {
-                qint64 intVal = numStr.toLongLong(&ok);
-                if (ok)
-                    *value = QCborValue(intVal);
-                else
-                    *value = QCborValue(num);
-            }
+            return parseNumber(value);
+        }
+    }
 
-            return success(); // 成功
+    /**
+     * @brief 文字列を読み飛ばします（'(' の位置から対応する ')' の次まで）。
+     */
+    void skipString() {
+        ++m_pos; // '('
+        while (m_pos < m_end) {
+            m_pos = findFirstOf<')', '\\'>(m_pos, m_end);
+            if (m_pos == m_end)
+                break;
+            if (*m_pos++ == ')')
+                break;
+            // エスケープされた文字を飛ばす
+            if (m_pos < m_end)
+                ++m_pos;
         }
-        return error("Invalid value type"_L1); // Add missing return statement
     }
 
     /**
      * @brief 文字列をパースします（'(' と ')' で囲まれ、特定のプレフィックスを持つ）。
-     * @param str パースした文字列を格納する QString のポインタ。
+     * @param value パースした文字列を格納する QCborValue のポインタ。
      * @return パースに失敗した場合はエラーメッセージを持つ ParseError を返します。成功した場合は空の ParseError を返します。
      */
-    ParseError parseString(QString* str) {
-        char ch = getNextChar();
-        if (ch != '(')
+    ParseError parseString(QCborValue* value) {
+        if (peekNextChar() != '(')
             return error("String must start with '('"_L1);
+        ++m_pos;
 
-        // 特殊なプレフィックス (˛ˇ) の処理
-        const auto prefix4 = m_data.mid(m_pos, 4);
-        if (prefix4 == "\xCB\x9B\xCB\x87") { // ˛ˇ == ogonek caron
-            m_pos += 4; // '˛ˇ' の消費
-        }
+        // 特殊なプレフィックス (˛ˇ) があれば消費する
+        matchString("\xCB\x9B\xCB\x87"); // ˛ˇ == ogonek caron
 
-        bool isUtf16 = false;
         // BOM Check
-        if (m_data.mid(m_pos, 2) == "\xFE\xFF") {
-            m_pos += 2; // BOM の消費
-            isUtf16 = true;
-        }
-
-        QByteArray strContent;
-        bool escaped = false;
-        while (m_pos < m_length) {
-            ch = getNextChar();
-            if (escaped) {
-                escaped = false;
-            } else if (ch == '\\') {
-                escaped = true;
-                continue;
-            } else {
-                if (ch == ')') {
+        const bool isUtf16 = matchString("\xFE\xFF");
+
+        // エスケープを含まない文字列は入力データ上の範囲をそのままデコードする
+        const char *start = m_pos;
+        m_pos = findFirstOf<')', '\\'>(m_pos, m_end);
+        QByteArrayView content(start, m_pos);
+        QByteArray unescaped;
+        if (m_pos < m_end && *m_pos == '\\') {
+            unescaped = content.toByteArray();
+            while (m_pos < m_end) {
+                const char ch = *m_pos++;
+                if (ch == ')')
                     break;
+                if (ch == '\\') {
+                    if (m_pos < m_end)
+                        unescaped += *m_pos++;
+                    continue;
                 }
+                const char *next = findFirstOf<')', '\\'>(m_pos, m_end);
+                unescaped += ch;
+                unescaped.append(m_pos, next - m_pos);
+                m_pos = next;
             }
-            strContent += ch;
+            content = unescaped;
+        } else if (m_pos < m_end) {
+            ++m_pos; // ')'
         }
 
-        QStringDecoder decoder(QStringDecoder::Utf16BE);
         if (isUtf16)
-            *str = decoder.decode(strContent);
+            *value = QCborValue(fromUtf16BE(content));
         else
-            *str = QString::fromLatin1(strContent);
+            *value = QCborValue(QLatin1StringView(content));
 
         return success(); // 成功
     }
 
     /**
      * @brief ブール値をパースします（'true' または 'false'）。
-     * @param boolStr パースしたブール値文字列を格納する QByteArray のポインタ。
+     * @param value パースしたブール値を格納する QCborValue のポインタ。
      * @return パースに失敗した場合はエラーメッセージを持つ ParseError を返します。成功した場合は空の ParseError を返します。
      */
-    ParseError parseBoolean(QByteArray* boolStr) {
-        QString boolQString;
-        while (m_pos < m_length && QChar::fromLatin1(m_data.at(m_pos)).isLetter()) {
-            boolQString += QLatin1Char(m_data.at(m_pos));
+    ParseError parseBoolean(QCborValue* value) {
+        const char *start = m_pos;
+        while (m_pos < m_end && QChar::fromLatin1(*m_pos).isLetter())
             ++m_pos;
-        }
 
-        QString boolLower = boolQString.toLower();
-        if (boolLower == "true"_L1) {
-            *boolStr = "true"_ba;
+        const qsizetype length = m_pos - start;
+        if (qstrnicmp(start, length, "true", 4) == 0) {
+            *value = QCborValue(true);
             return success(); // 成功
-        } else if (boolLower == "false"_L1) {
-            *boolStr = "false"_ba;
+        } else if (qstrnicmp(start, length, "false", 5) == 0) {
+            *value = QCborValue(false);
             return success(); // 成功
         }
         return error(u"無効なブール値です。"_s);
@@ -343,26 +490,49 @@ private:
 
     /**
      * @brief 数値をパースします。
-     * @param numStr パースした数値文字列を格納する QByteArray のポインタ。
+     * @param value パースした数値を格納する QCborValue のポインタ。
      * @return パースに失敗した場合はエラーメッセージを持つ ParseError を返します。成功した場合は空の ParseError を返します。
      */
-    ParseError parseNumber(QByteArray* numStr) {
-        QByteArray numberStr;
-        if (peekNextChar() == '-')
-            numberStr += getNextChar(); // '-' の消費
-
-        while (m_pos < m_length) {
-            char ch = peekNextChar();
-            if (QChar::fromLatin1(ch).isDigit() || ch == '.'_L1)
-                numberStr += getNextChar();
-            else
+    ParseError parseNumber(QCborValue* value) {
+        const char *start = m_pos;
+        const bool negative = peekNextChar() == '-';
+        if (negative)
+            ++m_pos; // '-' の消費
+
+        // 整数はその場で組み立て、桁あふれしたときだけ double にする
+        bool isInteger = true;
+        bool overflow = false;
+        qint64 intVal = 0;
+        while (m_pos < m_end) {
+            const char ch = *m_pos;
+            if (ch >= '0' && ch <= '9') {
+                const int digit = ch - '0';
+                overflow = overflow || qMulOverflow<qint64>(intVal, 10, &intVal)
+                        || qSubOverflow<qint64>(intVal, digit, &intVal);
+            } else if (ch == '.') {
+                isInteger = false;
+            } else {
                 break;
+            }
+            ++m_pos;
         }
 
-        if (numberStr.isEmpty() || numberStr == "-")
+        const QByteArrayView numStr(start, m_pos);
+        if (numStr.isEmpty() || numStr == "-")
             return error("Number expected but not found"_L1);
 
-        *numStr = numberStr;
+        // 負の値として組み立てているので、正の値は符号を反転する
+        if (isInteger && !overflow && (negative || intVal != std::numeric_limits<qint64>::min())) {
+            *value = QCborValue(negative ? intVal : -intVal);
+            return success(); // 成功
+        }
+
+        bool ok = false;
+        const double num = numStr.toDouble(&ok);
+        if (!ok)
+            return error("Invalid number format: '%1'"_L1.arg(QLatin1StringView(numStr)));
+
+        *value = QCborValue(num);
         return success(); // 成功
     }
 
@@ -392,9 +562,26 @@ private:
  * @return パース結果を格納した QCborMap。パースに失敗した場合は空の QCborMap を返します。
  */
 QCborMap QPsdEngineDataParser::parseEngineData(const QByteArray &data, ParseError* error)
+{
+    return parseEngineData(data, {}, error);
+}
+
+/**
+ * @brief EngineData のうち subtrees で指定したサブツリーだけを QCborMap に構築します。
+ *
+ * subtrees は "EngineDict" や "DocumentResources/FontSet" のように辞書のキーを '/' で
+ * 区切った経路です。経路上の辞書と指定されたサブツリーは通常どおり構築され、それ以外の
+ * 値は元のテキストを RawValueTag 付きの QCborValue として保持するため、
+ * serializeEngineData() で元どおり書き戻せます。
+ * @param data パース対象の QByteArray
+ * @param subtrees 構築するサブツリーの経路。空の場合はすべて構築します。
+ * @param error エラー情報を格納する ParseError のポインタ（オプション）。
+ * @return パース結果を格納した QCborMap。パースに失敗した場合は空の QCborMap を返します。
+ */
+QCborMap QPsdEngineDataParser::parseEngineData(const QByteArray &data, const QByteArrayList &subtrees, ParseError* error)
 {
     QCborMap map;
-    Private parser(data);
+    Private parser(data, subtrees);
     ParseError parseError = parser.parse(&map);
     if (!parseError)
         return map; // パース成功
@@ -478,6 +665,11 @@ static void serializeValue(QByteArray &out, const QCborValue &value, int indent)
     case QCborValue::False:
         out += pad + "false\n";
         break;
+    case QCborValue::Tag:
+        // Subtrees skipped by a selective parse keep their original text
+        if (value.tag() == QPsdEngineDataParser::RawValueTag)
+            out += pad + value.taggedValue().toByteArray() + "\n";
+        break;
     case QCborValue::Integer:
         out += pad + QByteArray::number(static_cast<qlonglong>(value.toInteger())) + "\n";
         break;
@@ -5,6 +5,7 @@
 #define QPSDENGINEDATACORE_H
 
 #include <QtPsdCore/qpsdcoreglobal.h>
+#include <QtCore/QByteArrayList>
 #include <QtCore/QCborMap>
 
 QT_BEGIN_NAMESPACE
@@ -28,7 +29,15 @@ public:
         // Error error = NoError;
         QString errorMessage;
     };
+    /*!
+     * Tag of the values that a selective parseEngineData() leaves unparsed.
+     * The tagged byte array holds the original EngineData text of the value,
+     * which serializeEngineData() writes back unchanged.
+     */
+    static constexpr QCborTag RawValueTag = QCborTag(0x50534445); // "PSDE"
+
     static QCborMap parseEngineData(const QByteArray &data, ParseError* error = nullptr);
+    static QCborMap parseEngineData(const QByteArray &data, const QByteArrayList &subtrees, ParseError* error = nullptr);
     static QByteArray serializeEngineData(const QCborMap &data);
 
 private:
@@ -9,6 +9,7 @@ class QPsdFileHeader::Private : public QSharedData
 {
 public:
     Private();
+    quint16 version;
     quint16 channels;
     quint32 height;
     quint32 width;
@@ -17,7 +18,8 @@ public:
 };
 
 QPsdFileHeader::Private::Private()
-    : channels(0)
+    : version(1)
+    , channels(0)
     , height(0)
     , width(0)
     , depth(0)
@@ -45,12 +47,17 @@ QPsdFileHeader::QPsdFileHeader(QIODevice *source)
 
     // Version: always equal to 1. Do not try to read the file if the version does not match this value. (**PSB** version is 2.)
     const auto version = readU16(source);
-    if (version != 1) {
+    if (version != 1 && version != 2) {
         qWarning() << version;
         source->close();
         setErrorString("Version error"_L1);
         return;
     }
+    d->version = version;
+    // The following sections read their lengths according to the version
+    auto options = readOptions(source);
+    options.setFlag(LargeDocument, version == 2);
+    setReadOptions(source, options);
 
     // Reserved: must be zero.
     skip(source, 6);
@@ -58,10 +65,10 @@ QPsdFileHeader::QPsdFileHeader(QIODevice *source)
     // The number of channels in the image, including any alpha channels. Supported range is 1 to 56.
     d->channels = readU16(source);
 
-    // The height of the image in pixels. Supported range is 1 to 30,000.
+    // The height of the image in pixels. Supported range is 1 to 30,000. (**PSB** max of 300,000.)
     d->height = readU32(source);
 
-    // The width of the image in pixels. Supported range is 1 to 30,000
+    // The width of the image in pixels. Supported range is 1 to 30,000 (**PSB** max of 300,000)
     d->width = readU32(source);
 
     // Depth: the number of bits per channel. Supported values are 1, 8, 16 and 32.
@@ -87,6 +94,16 @@ QPsdFileHeader &QPsdFileHeader::operator=(const QPsdFileHeader &other)
 
 QPsdFileHeader::~QPsdFileHeader() = default;
 
+quint16 QPsdFileHeader::version() const
+{
+    return d->version;
+}
+
+bool QPsdFileHeader::isLargeDocument() const
+{
+    return d->version == 2;
+}
+
 quint16 QPsdFileHeader::channels() const
 {
     return d->channels;
@@ -112,6 +129,11 @@ QPsdFileHeader::ColorMode QPsdFileHeader::colorMode() const
     return d->colorMode;
 }
 
+void QPsdFileHeader::setVersion(quint16 version)
+{
+    d->version = version;
+}
+
 void QPsdFileHeader::setChannels(quint16 channels)
 {
     d->channels = channels;
@@ -27,12 +27,15 @@ public:
     QPsdFileHeader &operator=(const QPsdFileHeader &other);
     ~QPsdFileHeader() override;
 
+    quint16 version() const;
+    bool isLargeDocument() const;
     quint16 channels() const;
     quint32 height() const;
     quint32 width() const;
     quint16 depth() const;
     ColorMode colorMode() const;
 
+    void setVersion(quint16 version);
     void setChannels(quint16 channels);
     void setHeight(quint32 height);
     void setWidth(quint32 width);
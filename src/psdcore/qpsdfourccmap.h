@@ -0,0 +1,267 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPSDFOURCCMAP_H
+#define QPSDFOURCCMAP_H
+
+#include <QtPsdCore/qpsdcoreglobal.h>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QByteArrayView>
+#include <QtCore/QDebug>
+#include <QtCore/QList>
+#include <QtCore/QVariant>
+
+#include <initializer_list>
+#include <iterator>
+#include <utility>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+ * A four character code such as "TySh" packed big-endian into a quint32,
+ * the way it is stored in the file.
+ */
+class QPsdFourCC
+{
+public:
+    constexpr QPsdFourCC() noexcept = default;
+    constexpr explicit QPsdFourCC(quint32 value) noexcept : v(value) {}
+
+    /*!
+     * Packs a four character string literal at compile time, so that
+     * lookups like \c value("lyid") neither allocate nor hash.
+     */
+    constexpr QPsdFourCC(const char (&key)[5]) noexcept
+        : v(pack(key[0], key[1], key[2], key[3]))
+    {}
+
+    /*!
+     * Packs the first four bytes of \a key. Shorter keys are padded with
+     * zero bytes.
+     */
+    constexpr explicit QPsdFourCC(QByteArrayView key) noexcept
+        : v(pack(key.size() > 0 ? key.at(0) : '\0',
+                 key.size() > 1 ? key.at(1) : '\0',
+                 key.size() > 2 ? key.at(2) : '\0',
+                 key.size() > 3 ? key.at(3) : '\0'))
+    {}
+
+    constexpr quint32 value() const noexcept { return v; }
+
+    QByteArray toByteArray() const
+    {
+        const char bytes[4] = { char(v >> 24), char(v >> 16), char(v >> 8), char(v) };
+        return QByteArray(bytes, 4);
+    }
+
+    friend constexpr bool operator==(QPsdFourCC lhs, QPsdFourCC rhs) noexcept { return lhs.v == rhs.v; }
+    friend constexpr bool operator!=(QPsdFourCC lhs, QPsdFourCC rhs) noexcept { return lhs.v != rhs.v; }
+    friend constexpr bool operator<(QPsdFourCC lhs, QPsdFourCC rhs) noexcept { return lhs.v < rhs.v; }
+    friend size_t qHash(QPsdFourCC key, size_t seed = 0) noexcept { return qHash(key.v, seed); }
+
+private:
+    static constexpr quint32 pack(char a, char b, char c, char d) noexcept
+    {
+        return quint32(uchar(a)) << 24 | quint32(uchar(b)) << 16
+            | quint32(uchar(c)) << 8 | quint32(uchar(d));
+    }
+
+    quint32 v = 0;
+};
+
+Q_DECLARE_TYPEINFO(QPsdFourCC, Q_PRIMITIVE_TYPE);
+
+inline QDebug operator<<(QDebug s, QPsdFourCC key)
+{
+    return s << key.toByteArray();
+}
+
+/*!
+ * An insertion-ordered map with a QHash-like interface, stored as two flat
+ * lists. The sections it backs hold a few dozen entries at most, where a
+ * linear scan over contiguous keys beats hashing a freshly built key.
+ * Lookups take a \c LookupKey, so that they need no temporary \c Key.
+ */
+template <typename Key, typename T = QVariant, typename LookupKey = Key>
+class QPsdFlatMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using size_type = qsizetype;
+
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using difference_type = qsizetype;
+        using value_type = T;
+        using pointer = const T *;
+        using reference = const T &;
+
+        constexpr const_iterator() = default;
+
+        const Key &key() const { return m->m_keys.at(i); }
+        const T &value() const { return m->m_values.at(i); }
+        const T &operator*() const { return value(); }
+        const T *operator->() const { return &value(); }
+
+        const_iterator &operator++() { ++i; return *this; }
+        const_iterator operator++(int) { auto ret = *this; ++i; return ret; }
+        const_iterator &operator--() { --i; return *this; }
+        const_iterator operator--(int) { auto ret = *this; --i; return ret; }
+
+        friend bool operator==(const const_iterator &lhs, const const_iterator &rhs) { return lhs.i == rhs.i; }
+        friend bool operator!=(const const_iterator &lhs, const const_iterator &rhs) { return lhs.i != rhs.i; }
+
+    private:
+        friend class QPsdFlatMap;
+        const_iterator(const QPsdFlatMap *m, qsizetype i) : m(m), i(i) {}
+        const QPsdFlatMap *m = nullptr;
+        qsizetype i = 0;
+    };
+    using ConstIterator = const_iterator;
+
+    QPsdFlatMap() = default;
+    QPsdFlatMap(std::initializer_list<std::pair<Key, T>> list)
+    {
+        reserve(list.size());
+        for (const auto &item : list)
+            insert(item.first, item.second);
+    }
+
+    bool isEmpty() const noexcept { return m_keys.isEmpty(); }
+    qsizetype size() const noexcept { return m_keys.size(); }
+    qsizetype count() const noexcept { return m_keys.size(); }
+    void reserve(qsizetype size)
+    {
+        m_keys.reserve(size);
+        m_values.reserve(size);
+    }
+    void clear()
+    {
+        m_keys.clear();
+        m_values.clear();
+    }
+
+    bool contains(LookupKey key) const { return indexOf(key) >= 0; }
+
+    T value(LookupKey key, const T &defaultValue = T()) const
+    {
+        const auto i = indexOf(key);
+        return i < 0 ? defaultValue : m_values.at(i);
+    }
+
+    /*!
+     * Returns the keys in the order they were first inserted.
+     */
+    QList<Key> keys() const { return m_keys; }
+    QList<T> values() const { return m_values; }
+
+    /*!
+     * Replaces the value of an existing \a key in place, or appends a new
+     * entry at the end.
+     */
+    void insert(const Key &key, const T &value)
+    {
+        const auto i = indexOf(LookupKey(key));
+        if (i < 0) {
+            m_keys.append(key);
+            m_values.append(value);
+        } else {
+            m_values[i] = value;
+        }
+    }
+
+    /*!
+     * Returns a reference to the value of \a key, appending a
+     * default-constructed one if the key is not in the map yet.
+     */
+    T &operator[](const Key &key)
+    {
+        auto i = indexOf(LookupKey(key));
+        if (i < 0) {
+            m_keys.append(key);
+            m_values.append(T());
+            i = m_values.size() - 1;
+        }
+        return m_values[i];
+    }
+
+    bool remove(LookupKey key)
+    {
+        const auto i = indexOf(key);
+        if (i < 0)
+            return false;
+        m_keys.removeAt(i);
+        m_values.removeAt(i);
+        return true;
+    }
+
+    T take(LookupKey key)
+    {
+        const auto i = indexOf(key);
+        if (i < 0)
+            return T();
+        m_keys.removeAt(i);
+        return m_values.takeAt(i);
+    }
+
+    const_iterator find(LookupKey key) const
+    {
+        const auto i = indexOf(key);
+        return const_iterator(this, i < 0 ? size() : i);
+    }
+    const_iterator constFind(LookupKey key) const { return find(key); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+    const_iterator constBegin() const { return begin(); }
+    const_iterator constEnd() const { return end(); }
+
+    friend bool operator==(const QPsdFlatMap &lhs, const QPsdFlatMap &rhs)
+    {
+        return lhs.m_keys == rhs.m_keys && lhs.m_values == rhs.m_values;
+    }
+    friend bool operator!=(const QPsdFlatMap &lhs, const QPsdFlatMap &rhs) { return !(lhs == rhs); }
+
+private:
+    qsizetype indexOf(LookupKey key) const
+    {
+        const Key *keys = m_keys.constData();
+        for (qsizetype i = 0, n = m_keys.size(); i < n; ++i) {
+            if (LookupKey(keys[i]) == key)
+                return i;
+        }
+        return -1;
+    }
+
+    QList<Key> m_keys;
+    QList<T> m_values;
+};
+
+template <typename Key, typename T, typename LookupKey>
+QDebug operator<<(QDebug s, const QPsdFlatMap<Key, T, LookupKey> &map)
+{
+    QDebugStateSaver saver(s);
+    s.nospace() << "QPsdFlatMap(";
+    for (auto it = map.cbegin(); it != map.cend(); ++it) {
+        if (it != map.cbegin())
+            s << ", ";
+        s << '(' << it.key() << ", " << it.value() << ')';
+    }
+    return s << ')';
+}
+
+/*!
+ * Additional layer information of a layer record or of the document,
+ * keyed by the block signature.
+ */
+using QPsdFourCCMap = QPsdFlatMap<QPsdFourCC>;
+
+QT_END_NAMESPACE
+
+#endif // QPSDFOURCCMAP_H
@@ -4,18 +4,84 @@
 #include "qpsdimagedata.h"
 #include "qpsdfileheader.h"
 
+#include <QtCore/QMutex>
+
 QT_BEGIN_NAMESPACE
 
 class QPsdImageData::Private : public QSharedData
 {
 public:
-    QByteArray imageData;
+    Private();
+    Private(const Private &other);
+
+    // The composite is decoded the first time its pixels are accessed, so
+    // that region() can decode parts of it without expanding all of it
+    QPsdByteSlice payload;
+    int countSize = 2;
+    mutable QPsdByteSlice imageData;
+    mutable bool isDecoded = true;
+    mutable QMutex mutex;
     quint16 compression = 0;
 #ifdef QT_PSD_RAW_ROUND_TRIP
-    QByteArray rawImageBytes;
+    QPsdByteSlice rawImageBytes;
 #endif
+
+    QPsdByteSlice decodedData(const QPsdFileHeader &header) const;
 };
 
+QPsdImageData::Private::Private()
+{}
+
+QPsdImageData::Private::Private(const Private &other)
+    : QSharedData(other)
+    , payload(other.payload)
+    , countSize(other.countSize)
+    , compression(other.compression)
+#ifdef QT_PSD_RAW_ROUND_TRIP
+    , rawImageBytes(other.rawImageBytes)
+#endif
+{
+    QMutexLocker locker(&other.mutex);
+    imageData = other.imageData;
+    isDecoded = other.isDecoded;
+}
+
+QPsdByteSlice QPsdImageData::Private::decodedData(const QPsdFileHeader &header) const
+{
+    {
+        QMutexLocker locker(&mutex);
+        if (isDecoded)
+            return imageData;
+    }
+
+    const int rows = header.height() * header.channels();
+    QPsdByteSlice decoded;
+    // The mapped document may have been truncated since it was parsed
+    if (payload.isTruncated()) {
+        qWarning("QPsdImageData: the memory-mapped document has been truncated");
+    } else {
+        switch (compression) {
+        case RLE:
+            decoded = QPsdByteSlice(decodePackBits(payload.view(), rows, countSize));
+            break;
+        case ZipWithPrediction:
+        case ZipWithoutPrediction:
+            // Each channel is predicted as its own block of rows, so the whole
+            // image can be treated as one channel of height * channels rows
+            decoded = QPsdByteSlice(decodeZip(payload.view(), static_cast<Compression>(compression),
+                                              header.width(), rows, header.depth()));
+            break;
+        }
+    }
+
+    QMutexLocker locker(&mutex);
+    if (!isDecoded) {
+        imageData = decoded;
+        isDecoded = true;
+    }
+    return imageData;
+}
+
 QPsdImageData::QPsdImageData()
     : QPsdAbstractImage()
     , d(new Private)
@@ -32,7 +98,8 @@ QPsdImageData::QPsdImageData(const QPsdFileHeader &header, QIODevice *source)
 
     // Image Data Section
     // https://www.adobe.com/devnet-apps/photoshop/fileformatashtml/#50577409_89817
-    quint32 length = source->bytesAvailable();
+    // PSB composites can be larger than 4 GiB
+    qint64 length = source->bytesAvailable();
     auto cleanup = qScopeGuard([&] {
         Q_ASSERT(length == 0);
     });
@@ -41,7 +108,8 @@ QPsdImageData::QPsdImageData(const QPsdFileHeader &header, QIODevice *source)
     // Save raw image data section (compression u16 + compressed data) for lossless round-trip
     {
         const qint64 imgStart = source->pos();
-        d->rawImageBytes = source->read(length);
+        qint64 rawLength = length;
+        d->rawImageBytes = readByteSlice(source, rawLength, &rawLength);
         source->seek(imgStart);
     }
 #endif
@@ -51,26 +119,122 @@ QPsdImageData::QPsdImageData(const QPsdFileHeader &header, QIODevice *source)
     // 1 = RLE compressed the image data starts with the byte counts for all the scan lines (rows * channels), with each count stored as a two-byte value. The RLE compressed data follows, with each scan line compressed separately. The RLE compression is the same compression algorithm used by the Macintosh ROM routine PackBits , and the TIFF standard.
     // 2 = ZIP without prediction
     // 3 = ZIP with prediction.
-    Compression compression = static_cast<Compression>(readU16(source, &length));
+    Compression compression = static_cast<Compression>(readU16(source));
+    length -= sizeof(quint16);
     d->compression = static_cast<quint16>(compression);
     // The color data.
+    const auto readPayload = [&] {
+#ifdef QT_PSD_RAW_ROUND_TRIP
+        // Refer to the bytes kept for round-trip instead of reading them twice
+        const auto ret = d->rawImageBytes.mid(sizeof(quint16), length);
+        skip(source, length, &length);
+        return ret;
+#else
+        return readByteSlice(source, length, &length);
+#endif
+    };
     switch (compression) {
     case RawData:
-        d->imageData = source->readAll();
-        length = 0;
+        d->imageData = readPayload();
         break;
     case RLE:
-        d->imageData = readRLE(source, header.height() * header.channels(), &length);
-        break;
+        // (**PSB** byte counts are four-byte values.)
+        d->countSize = isLargeDocument(source) ? 4 : 2;
+        Q_FALLTHROUGH();
     case ZipWithPrediction:
     case ZipWithoutPrediction:
-        d->imageData = readZip(source, &length);
+        d->payload = readPayload();
+        d->isDecoded = false;
         break;
     default:
         qFatal("not supported");
     }
 }
 
+QPsdImageData::QPsdImageData(const QPsdFileHeader &header, QIODevice *source, const QRect &rect)
+    : QPsdImageData()
+{
+    const QRect bounds = rect & QRect(0, 0, header.width(), header.height());
+
+    QPsdFileHeader fileHeader = header;
+    fileHeader.setWidth(bounds.width());
+    fileHeader.setHeight(bounds.height());
+    setHeader(fileHeader);
+    setWidth(bounds.width());
+    setHeight(bounds.height());
+    setOpacity(255);
+    // The region holds decoded pixels, see region()
+
+    const qint64 end = source->pos() + source->bytesAvailable();
+    const auto compression = static_cast<Compression>(readU16(source));
+    if (bounds.isEmpty())
+        return;
+
+    const int width = header.width();
+    const int height = header.height();
+    const int planes = header.channels();
+    const int depth = header.depth();
+    const qint64 start = source->pos();
+    // The scan lines of bounds of every plane, in full width
+    const QRect lines(bounds.x(), 0, bounds.width(), bounds.height());
+    switch (compression) {
+    case RawData: {
+        const qint64 rowBytes = depth == 1 ? (qint64(width) + 7) / 8 : qint64(width) * (depth / 8);
+        const qint64 planeBytes = rowBytes * bounds.height();
+        QByteArray data(planeBytes * planes, '\0');
+        for (int plane = 0; plane < planes; ++plane) {
+            if (!source->seek(start + (qint64(plane) * height + bounds.top()) * rowBytes))
+                break;
+            source->read(data.data() + plane * planeBytes, planeBytes);
+        }
+        setImageData(decodeRegion(data, RawData, width, bounds.height(), planes, depth, 0, lines));
+        break; }
+    case RLE: {
+        // The byte count table locates the lines, and those of each plane
+        // that fall into bounds follow each other
+        const int countSize = isLargeDocument(source) ? 4 : 2;
+        const qint64 tableSize = qint64(height) * planes * countSize;
+        const QByteArray table = source->read(tableSize);
+        if (table.size() < tableSize)
+            break;
+        const auto count = [&](qint64 line) {
+            const auto *p = reinterpret_cast<const uchar *>(table.constData()) + line * countSize;
+            return countSize == 4 ? qint64(qFromBigEndian<quint32>(p)) : qint64(qFromBigEndian<quint16>(p));
+        };
+
+        // A stream of the kept lines only, with a table of their own
+        QByteArray data(qint64(bounds.height()) * planes * countSize, '\0');
+        qint64 offset = start + tableSize;
+        for (int plane = 0; plane < planes; ++plane) {
+            const qint64 first = qint64(plane) * height;
+            for (qint64 line = first; line < first + bounds.top(); ++line)
+                offset += count(line);
+            qint64 size = 0;
+            for (int y = 0; y < bounds.height(); ++y) {
+                const qint64 line = first + bounds.top() + y;
+                memcpy(data.data() + (qint64(plane) * bounds.height() + y) * countSize,
+                       table.constData() + line * countSize, countSize);
+                size += count(line);
+            }
+            if (!source->seek(offset))
+                break;
+            data.append(source->read(size));
+            for (qint64 line = first + bounds.top(); line < first + height; ++line)
+                offset += count(line);
+        }
+        setImageData(decodeRegion(data, RLE, width, bounds.height(), planes, depth, countSize, lines));
+        break; }
+    case ZipWithPrediction:
+    case ZipWithoutPrediction:
+        setImageData(decodeRegion(source->read(end - start), compression, width, height, planes, depth, 0, bounds));
+        break;
+    default:
+        qWarning("QPsdImageData: compression %d not supported", int(compression));
+        break;
+    }
+    source->seek(end);
+}
+
 QPsdImageData::QPsdImageData(const QPsdImageData &other)
     : QPsdAbstractImage(other)
     , d(other.d)
@@ -89,12 +253,14 @@ QPsdImageData::~QPsdImageData() = default;
 
 QByteArray QPsdImageData::imageData() const
 {
-    return d->imageData;
+    return d->decodedData(header()).toByteArray();
 }
 
 void QPsdImageData::setImageData(const QByteArray &imageData)
 {
-    d->imageData = imageData;
+    d->payload = QPsdByteSlice();
+    d->imageData = QPsdByteSlice(imageData);
+    d->isDecoded = true;
 }
 
 quint16 QPsdImageData::compression() const
@@ -102,21 +268,63 @@ quint16 QPsdImageData::compression() const
     return d->compression;
 }
 
+QPsdImageData QPsdImageData::region(const QRect &rect) const
+{
+    const QRect bounds = rect & QRect(0, 0, width(), height());
+
+    QPsdFileHeader fileHeader = header();
+    fileHeader.setWidth(bounds.width());
+    fileHeader.setHeight(bounds.height());
+
+    QPsdImageData ret;
+    ret.setHeader(fileHeader);
+    ret.setWidth(bounds.width());
+    ret.setHeight(bounds.height());
+    ret.setOpacity(opacity());
+    // The region holds decoded pixels
+    ret.d->compression = RawData;
+    if (bounds.isEmpty())
+        return ret;
+
+    QPsdByteSlice decoded;
+    bool isDecoded;
+    {
+        QMutexLocker locker(&d->mutex);
+        decoded = d->imageData;
+        isDecoded = d->isDecoded;
+    }
+    if (!isDecoded && d->payload.isTruncated()) {
+        qWarning("QPsdImageData: the memory-mapped document has been truncated");
+        return ret;
+    }
+    const int planes = header().channels();
+    ret.setImageData(isDecoded
+        ? decodeRegion(decoded.view(), RawData, width(), height(), planes, depth(), 0, bounds)
+        : decodeRegion(d->payload.view(), static_cast<Compression>(d->compression),
+                       width(), height(), planes, depth(), d->countSize, bounds));
+    return ret;
+}
+
 #ifdef QT_PSD_RAW_ROUND_TRIP
 QByteArray QPsdImageData::rawImageBytes() const
+{
+    return d->rawImageBytes.toByteArray();
+}
+
+QPsdByteSlice QPsdImageData::rawImageSlice() const
 {
     return d->rawImageBytes;
 }
 
 void QPsdImageData::setRawImageBytes(const QByteArray &data)
 {
-    d->rawImageBytes = data;
+    d->rawImageBytes = QPsdByteSlice(data);
 }
 #endif
 
 const unsigned char *QPsdImageData::gray() const
 {
-    return reinterpret_cast<const unsigned char *>(d->imageData.constData());
+    return d->decodedData(header()).constData();
 }
 
 const unsigned char *QPsdImageData::r() const
@@ -15,6 +15,12 @@ class Q_PSDCORE_EXPORT QPsdImageData : public QPsdAbstractImage
 public:
     QPsdImageData();
     QPsdImageData(const QPsdFileHeader &header, QIODevice *source);
+    /*!
+     * Reads the pixels of \a rect, like region() does from a composite read
+     * as a whole. Raw and RLE scan lines outside \a rect are seeked past
+     * instead of being read; ZIP data is read whole.
+     */
+    QPsdImageData(const QPsdFileHeader &header, QIODevice *source, const QRect &rect);
     QPsdImageData(const QPsdImageData &other);
     QPsdImageData &operator=(const QPsdImageData &other);
     ~QPsdImageData() override;
@@ -27,8 +33,17 @@ public:
 
     quint16 compression() const;
 
+    /*!
+     * Returns the pixels of \a rect, in document coordinates, as a new image
+     * of the size of \a rect clipped to the document. Only the scan lines
+     * covering \a rect are decoded.
+     */
+    QPsdImageData region(const QRect &rect) const;
+
 #ifdef QT_PSD_RAW_ROUND_TRIP
     QByteArray rawImageBytes() const;
+    // Same bytes as rawImageBytes() without copying them out of a mapped file
+    QPsdByteSlice rawImageSlice() const;
     void setRawImageBytes(const QByteArray &data);
 #endif
 
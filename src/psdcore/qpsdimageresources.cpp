@@ -62,4 +62,34 @@ void QPsdImageResources::setImageResourceBlocks(const QList<QPsdImageResourceBlo
     d->imageResourceBlocks = blocks;
 }
 
+QPsdImageResourceBlock QPsdImageResources::findBlock(QIODevice *source, const QList<quint16> &ids)
+{
+    const auto length = readU32(source);
+    const qint64 end = source->pos() + length;
+
+    // Position and rank in ids of the best block seen so far
+    qint64 found = -1;
+    qsizetype foundRank = ids.size();
+    while (source->isOpen() && end - source->pos() > 8) {
+        const qint64 start = source->pos();
+        if (source->read(4) != "8BIM")
+            break;
+        const auto id = readU16(source);
+        readPascalString(source, 2);
+        const auto size = readU32(source);
+        const auto rank = ids.indexOf(id);
+        if (rank >= 0 && rank < foundRank) {
+            found = start;
+            foundRank = rank;
+            if (rank == 0)
+                break;
+        }
+        if (!source->seek(source->pos() + even(size)))
+            break;
+    }
+    if (found < 0 || !source->seek(found))
+        return {};
+    return QPsdImageResourceBlock(source);
+}
+
 QT_END_NAMESPACE
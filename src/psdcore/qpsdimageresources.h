@@ -21,6 +21,15 @@ public:
     QList<QPsdImageResourceBlock> imageResourceBlocks() const;
     void setImageResourceBlocks(const QList<QPsdImageResourceBlock> &blocks);
 
+    /*!
+     * Walks the image resources section at the current position of \a source
+     * and returns the block whose id comes first in \a ids, regardless of
+     * the order of the blocks in the file. The data of all other blocks is
+     * seeked past without reading it, and the walk stops as soon as a block
+     * with the first id is found. Returns a block with id 0 if there is none.
+     */
+    static QPsdImageResourceBlock findBlock(QIODevice *source, const QList<quint16> &ids);
+
 private:
     class Private;
     QSharedDataPointer<Private> d;
@@ -12,8 +12,7 @@ public:
     Private();
     QPsdLayerInfo layerInfo;
     QPsdGlobalLayerMaskInfo globalLayerMaskInfo;
-    QHash<QByteArray, QVariant> additionalLayerInformation;
-    QList<QByteArray> aliKeyOrder;
+    QPsdFourCCMap additionalLayerInformation;
 };
 
 QPsdLayerAndMaskInformation::Private::Private()
@@ -30,20 +29,25 @@ QPsdLayerAndMaskInformation::QPsdLayerAndMaskInformation(QIODevice *source)
     // Layer and Mask Information Section
     // https://www.adobe.com/devnet-apps/photoshop/fileformatashtml/#50577409_75067
 
+    const auto options = readOptions(source);
+
     // Length of the layer and mask information section. (**PSB** length is 8 bytes.)
-    auto length = readU32(source);
+    const auto length = readLength(source, options);
     EnsureSeek es(source, length);
 
     if (length == 0) {
         return;
     }
+    // The section length lets callers that only want the composite skip
+    // every layer record and channel without reading them
+    if (options.testFlag(SkipLayerAndMaskInformation))
+        return;
     d->layerInfo = QPsdLayerInfo(source);
     d->globalLayerMaskInfo = QPsdGlobalLayerMaskInfo(source);
 
     while (es.bytesAvailable() > 12) {
-        QPsdAdditionalLayerInformation ali(source, 4);
-        d->additionalLayerInformation.insert(ali.key(), ali.data());
-        d->aliKeyOrder.append(ali.key());
+        QPsdAdditionalLayerInformation ali(source, options, 4);
+        d->additionalLayerInformation.insert(QPsdFourCC(ali.key()), ali.data());
     }
 }
 
@@ -73,14 +77,18 @@ QPsdGlobalLayerMaskInfo QPsdLayerAndMaskInformation::globalLayerMaskInfo() const
     return d->globalLayerMaskInfo;
 }
 
-QHash<QByteArray, QVariant> QPsdLayerAndMaskInformation::additionalLayerInformation() const
+QPsdFourCCMap QPsdLayerAndMaskInformation::additionalLayerInformation() const
 {
     return d->additionalLayerInformation;
 }
 
 QList<QByteArray> QPsdLayerAndMaskInformation::aliKeyOrder() const
 {
-    return d->aliKeyOrder;
+    QList<QByteArray> ret;
+    ret.reserve(d->additionalLayerInformation.size());
+    for (auto it = d->additionalLayerInformation.cbegin(); it != d->additionalLayerInformation.cend(); ++it)
+        ret.append(it.key().toByteArray());
+    return ret;
 }
 
 bool QPsdLayerAndMaskInformation::hasMergedAlpha() const
@@ -98,7 +106,7 @@ void QPsdLayerAndMaskInformation::setGlobalLayerMaskInfo(const QPsdGlobalLayerMa
     d->globalLayerMaskInfo = globalLayerMaskInfo;
 }
 
-void QPsdLayerAndMaskInformation::setAdditionalLayerInformation(const QHash<QByteArray, QVariant> &info)
+void QPsdLayerAndMaskInformation::setAdditionalLayerInformation(const QPsdFourCCMap &info)
 {
     d->additionalLayerInformation = info;
 }
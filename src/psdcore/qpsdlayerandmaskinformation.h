@@ -9,6 +9,7 @@
 #include <QtPsdCore/qpsdgloballayermaskinfo.h>
 #include <QtPsdCore/qpsdadditionallayerinformation.h>
 #include <QtPsdCore/qpsdfileheader.h>
+#include <QtPsdCore/qpsdfourccmap.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -23,13 +24,13 @@ public:
 
     QPsdLayerInfo layerInfo() const;
     QPsdGlobalLayerMaskInfo globalLayerMaskInfo() const;
-    QHash<QByteArray, QVariant> additionalLayerInformation() const;
+    QPsdFourCCMap additionalLayerInformation() const;
     QList<QByteArray> aliKeyOrder() const;
     bool hasMergedAlpha() const;
 
     void setLayerInfo(const QPsdLayerInfo &layerInfo);
     void setGlobalLayerMaskInfo(const QPsdGlobalLayerMaskInfo &globalLayerMaskInfo);
-    void setAdditionalLayerInformation(const QHash<QByteArray, QVariant> &info);
+    void setAdditionalLayerInformation(const QPsdFourCCMap &info);
 
     void setFileHeader(const QPsdFileHeader &fileHeader);
 
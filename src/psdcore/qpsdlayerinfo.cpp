@@ -3,6 +3,7 @@
 
 #include "qpsdlayerinfo.h"
 #include "qpsdfileheader.h"
+#include "qpsdparallel_p.h"
 
 QT_BEGIN_NAMESPACE
 
@@ -10,7 +11,8 @@ class QPsdLayerInfo::Private : public QSharedData
 {
 public:
     Private();
-    void parse(QIODevice *source, quint32 length);
+    void parse(QIODevice *source, quint64 length);
+    void parseChannelImageDataConcurrently(QIODevice *source);
 
     QList<QPsdLayerRecord> records;
     QList<QPsdChannelImageData> channelImageData;
@@ -20,7 +22,7 @@ public:
 QPsdLayerInfo::Private::Private()
 {}
 
-void QPsdLayerInfo::Private::parse(QIODevice *source, quint32 length)
+void QPsdLayerInfo::Private::parse(QIODevice *source, quint64 length)
 {
     EnsureSeek es(source, length);
 
@@ -28,7 +30,29 @@ void QPsdLayerInfo::Private::parse(QIODevice *source, quint32 length)
     hasMergedAlpha = (count < 0);
 
     for (int i = 0; i < std::abs(count); i++) {
+        if (isCanceled(source))
+            return;
+        const qint64 start = source->pos();
         records.append(QPsdLayerRecord(source));
+        advance(source, source->pos() - start);
+    }
+
+    const auto options = readOptions(source);
+    if (options.testFlag(SkipChannelData)) {
+        // Keep the geometry of every layer, the EnsureSeek above skips the pixels
+        for (const QPsdLayerRecord &record : records) {
+            QPsdChannelImageData imageData;
+            imageData.setWidth(record.rect().width());
+            imageData.setHeight(record.rect().height());
+            imageData.setOpacity(record.opacity());
+            channelImageData.append(imageData);
+        }
+        return;
+    }
+
+    if (options.testFlag(ParallelLayers) && records.size() > 1) {
+        parseChannelImageDataConcurrently(source);
+        return;
     }
 
     for (const QPsdLayerRecord &record : records) {
@@ -37,6 +61,43 @@ void QPsdLayerInfo::Private::parse(QIODevice *source, quint32 length)
     }
 }
 
+void QPsdLayerInfo::Private::parseChannelImageDataConcurrently(QIODevice *source)
+{
+    // The channel image data of all layers follows the records back to back,
+    // so the channel lengths give every layer's byte range up front
+    QList<qint64> offsets(records.size() + 1);
+    for (qsizetype i = 0; i < records.size(); i++) {
+        qint64 size = 0;
+        for (const auto &channelInfo : records.at(i).channelInfo())
+            size += channelInfo.length();
+        offsets[i + 1] = offsets.at(i) + size;
+    }
+
+    // Take the whole range at once, a view of the mapping when reading
+    // through a QPsdByteCursor, and give each layer its own cursor on it
+    QPsdByteSlice layerData;
+    const qint64 start = source->pos();
+    if (auto cursor = qobject_cast<QPsdByteCursor *>(source)) {
+        layerData = cursor->slice(start, offsets.last());
+        cursor->seek(start + layerData.size());
+    } else {
+        layerData = QPsdByteSlice(source->read(offsets.last()), start);
+    }
+
+    const auto options = readOptions(source);
+    const auto observer = loadObserver(source);
+    channelImageData.resize(records.size());
+    QPsdChannelImageData *images = channelImageData.data();
+    psdParallelFor(records.size(), [&](qsizetype i) {
+        if (observer && observer->isCanceled())
+            return;
+        QPsdByteCursor layerSource(layerData.mid(offsets.at(i), offsets.at(i + 1) - offsets.at(i)));
+        setReadOptions(&layerSource, options);
+        setLoadObserver(&layerSource, observer);
+        images[i] = QPsdChannelImageData(records.at(i), &layerSource);
+    });
+}
+
 QPsdLayerInfo::QPsdLayerInfo()
     : QPsdSection()
     , d(new Private)
@@ -49,7 +110,7 @@ QPsdLayerInfo::QPsdLayerInfo(QIODevice *source)
     // https://www.adobe.com/devnet-apps/photoshop/fileformatashtml/#50577409_16000
 
     // Length of the layers info section, rounded up to a multiple of 2. (**PSB** length is 8 bytes.)
-    auto length = readU32(source);
+    const auto length = readLength(source);
     d->parse(source, length);
 }
 
@@ -19,8 +19,7 @@ public:
     QPsdLayerMaskAdjustmentLayerData layerMaskAdjustmentLayerData;
     QPsdLayerBlendingRangesData layerBlendingRangesData;
     QByteArray name;
-    QHash<QByteArray, QVariant> additionalLayerInformation;
-    QList<QByteArray> aliKeyOrder;
+    QPsdFourCCMap additionalLayerInformation;
     QPsdChannelImageData imageData;
 };
 
@@ -42,6 +41,9 @@ QPsdLayerRecord::QPsdLayerRecord(QIODevice *source)
     // Layer records
     // https://www.adobe.com/devnet-apps/photoshop/fileformatashtml/#50577409_13084
 
+    // Looked up once for the channels and blocks of the record
+    const auto options = readOptions(source);
+
     // Rectangle containing the contents of the layer. Specified as top, left, bottom, right coordinates
     d->rect = readRectangle(source);
 
@@ -50,7 +52,7 @@ QPsdLayerRecord::QPsdLayerRecord(QIODevice *source)
 
     // Channel information.
     for (int i = 0; i < channels; i++) {
-        d->channelInfo.append(QPsdChannelInfo(source));
+        d->channelInfo.append(QPsdChannelInfo(source, options));
     }
 
     // Blend mode signature: '8BIM'
@@ -95,9 +97,8 @@ QPsdLayerRecord::QPsdLayerRecord(QIODevice *source)
     d->name = readPascalString(source, 4);
 
     while (es.bytesAvailable() > 12) {
-        QPsdAdditionalLayerInformation ali(source);
-        d->additionalLayerInformation.insert(ali.key(), ali.data());
-        d->aliKeyOrder.append(ali.key());
+        QPsdAdditionalLayerInformation ali(source, options);
+        d->additionalLayerInformation.insert(QPsdFourCC(ali.key()), ali.data());
     }
 }
 
@@ -182,14 +183,18 @@ QByteArray QPsdLayerRecord::name() const
     return d->name;
 }
 
-QHash<QByteArray, QVariant> QPsdLayerRecord::additionalLayerInformation() const
+QPsdFourCCMap QPsdLayerRecord::additionalLayerInformation() const
 {
     return d->additionalLayerInformation;
 }
 
 QList<QByteArray> QPsdLayerRecord::aliKeyOrder() const
 {
-    return d->aliKeyOrder;
+    QList<QByteArray> ret;
+    ret.reserve(d->additionalLayerInformation.size());
+    for (auto it = d->additionalLayerInformation.cbegin(); it != d->additionalLayerInformation.cend(); ++it)
+        ret.append(it.key().toByteArray());
+    return ret;
 }
 
 QPsdChannelImageData QPsdLayerRecord::imageData() const
@@ -237,7 +242,7 @@ void QPsdLayerRecord::setName(const QByteArray &name)
     d->name = name;
 }
 
-void QPsdLayerRecord::setAdditionalLayerInformation(const QHash<QByteArray, QVariant> &info)
+void QPsdLayerRecord::setAdditionalLayerInformation(const QPsdFourCCMap &info)
 {
     d->additionalLayerInformation = info;
 }
@@ -10,6 +10,7 @@
 #include <QtPsdCore/qpsdlayerblendingrangesdata.h>
 #include <QtPsdCore/qpsdchannelimagedata.h>
 #include <QtPsdCore/qpsdblend.h>
+#include <QtPsdCore/qpsdfourccmap.h>
 
 QT_BEGIN_NAMESPACE
 
@@ -41,7 +42,7 @@ public:
     QPsdLayerMaskAdjustmentLayerData layerMaskAdjustmentLayerData() const;
     QPsdLayerBlendingRangesData layerBlendingRangesData() const;
     QByteArray name() const;
-    QHash<QByteArray, QVariant> additionalLayerInformation() const;
+    QPsdFourCCMap additionalLayerInformation() const;
     QList<QByteArray> aliKeyOrder() const;
 
     void setRect(const QRect &rect);
@@ -51,7 +52,7 @@ public:
     void setClipping(Clipping clipping);
     void setFlags(quint8 flags);
     void setName(const QByteArray &name);
-    void setAdditionalLayerInformation(const QHash<QByteArray, QVariant> &info);
+    void setAdditionalLayerInformation(const QPsdFourCCMap &info);
     void setLayerMaskAdjustmentLayerData(const QPsdLayerMaskAdjustmentLayerData &data);
     void setLayerBlendingRangesData(const QPsdLayerBlendingRangesData &data);
 
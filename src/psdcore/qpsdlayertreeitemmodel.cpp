@@ -9,6 +9,7 @@
 #include "qpsdsectiondividersetting.h"
 
 #include <QtCore/QFileInfo>
+#include <QtCore/QFutureWatcher>
 #include <QtCore/QVariant>
 
 QT_BEGIN_NAMESPACE
@@ -22,6 +23,8 @@ public:
         qint32 parentNodeIndex;
         enum FolderType folderType;
         bool isCloseFolder;
+        int row = -1;
+        QList<qint32> childNodeIndexes;
     };
 
     struct IndexInfo {
@@ -33,6 +36,8 @@ public:
     ~Private();
 
     bool isValidIndex(const QModelIndex &index) const;
+    const QList<qint32> *childNodeIndexes(qint32 parentNodeIndex) const;
+    void buildChildNodeIndexes();
 
     const ::QPsdLayerTreeItemModel *q;
     QString fileName;
@@ -42,12 +47,15 @@ public:
     QPsdFileHeader fileHeader;
     QList<QPsdLayerRecord> layerRecords;
     QList<Node> treeNodeList;
+    QList<qint32> topLevelNodeIndexes;
     QList<int> groupIDs;
     QMultiMap<int, IndexInfo> groupsMap;
     QList<IndexInfo> clippingMasks;
     QPsdResolutionInfo resolutionInfo;
     QPsdFilterMask filterMask;
     bool hasMergedAlpha = false;
+
+    QFutureWatcher<QPsdParser> loadWatcher;
 };
 
 QPsdLayerTreeItemModel::Private::Private(const ::QPsdLayerTreeItemModel *model) : q(model)
@@ -63,13 +71,61 @@ bool QPsdLayerTreeItemModel::Private::isValidIndex(const QModelIndex &index) con
     return index.isValid() && index.model() == q;
 }
 
+const QList<qint32> *QPsdLayerTreeItemModel::Private::childNodeIndexes(qint32 parentNodeIndex) const
+{
+    if (parentNodeIndex < 0)
+        return &topLevelNodeIndexes;
+    if (treeNodeList.size() <= parentNodeIndex)
+        return nullptr;
+    return &treeNodeList.at(parentNodeIndex).childNodeIndexes;
+}
+
+void QPsdLayerTreeItemModel::Private::buildChildNodeIndexes()
+{
+    // Children are listed top to bottom, the order of the layers panel and
+    // of the records read backwards. The bounding section divider that
+    // closes a folder ends its list; it is not a row of its own.
+    topLevelNodeIndexes.clear();
+    QList<bool> closed(treeNodeList.size() + 1, false);
+    for (qint32 i = treeNodeList.size() - 1; i >= 0; i--) {
+        auto &node = treeNodeList[i];
+        const qint32 parentNodeIndex = node.parentNodeIndex;
+        if (parentNodeIndex >= treeNodeList.size())
+            continue;
+        auto &children = parentNodeIndex < 0
+            ? topLevelNodeIndexes
+            : treeNodeList[parentNodeIndex].childNodeIndexes;
+        if (closed.at(parentNodeIndex + 1))
+            continue;
+        if (node.isCloseFolder) {
+            closed[parentNodeIndex + 1] = true;
+            continue;
+        }
+        node.row = children.size();
+        children.append(i);
+    }
+}
+
 QPsdLayerTreeItemModel::QPsdLayerTreeItemModel(QObject *parent)
     : QAbstractItemModel(parent), d(new Private(this))
 {
+    connect(&d->loadWatcher, &QFutureWatcherBase::progressValueChanged, this, [this](int value) {
+        emit loadProgress(value, d->loadWatcher.progressMaximum());
+    });
+    connect(&d->loadWatcher, &QFutureWatcherBase::finished, this, [this] {
+        const auto future = d->loadWatcher.future();
+        if (future.isCanceled())
+            return;
+        if (future.resultCount() > 0)
+            endLoad(future.result());
+        else
+            endLoad(QPsdParser(), tr("Cannot open file"));
+    });
 }
 
 QPsdLayerTreeItemModel::~QPsdLayerTreeItemModel()
 {
+    d->loadWatcher.cancel();
 }
 
 QHash<int, QByteArray> QPsdLayerTreeItemModel::roleNames() const
@@ -97,20 +153,12 @@ QModelIndex QPsdLayerTreeItemModel::index(int row, int column, const QModelIndex
         parentNodeIndex = parent.internalId();
     }
 
-    int r = -1;
-    int i = d->treeNodeList.size();
-    for (auto it = d->treeNodeList.crbegin(); it != d->treeNodeList.crend(); ++it) {
-        const auto node = *it;
-        i--;
-        if (node.parentNodeIndex == parentNodeIndex) {
-            r++;
-            if (r == row) {
-                return createIndex(row, column, i);
-            }
-        }
+    const auto *children = d->childNodeIndexes(parentNodeIndex);
+    if (!children || row < 0 || children->size() <= row) {
+        return {};
     }
 
-    return {};
+    return createIndex(row, column, children->at(row));
 }
 
 QModelIndex QPsdLayerTreeItemModel::parent(const QModelIndex &index) const
@@ -131,22 +179,11 @@ QModelIndex QPsdLayerTreeItemModel::parent(const QModelIndex &index) const
         return {};
     }
     const auto &parentNode = d->treeNodeList.at(parentNodeIndex);
-    qint32 grandParentNodeIndex = parentNode.parentNodeIndex;
-
-    int r = -1;
-    int i = d->treeNodeList.size();
-    for (auto it = d->treeNodeList.crbegin(); it != d->treeNodeList.crend(); ++it) {
-        const auto node = *it;
-        i--;
-        if (node.parentNodeIndex == grandParentNodeIndex) {
-            r++;
-            if (i == parentNodeIndex) {
-                return createIndex(r, 0, i);
-            }
-        }
+    if (parentNode.row < 0) {
+        return {};
     }
 
-    return {};
+    return createIndex(parentNode.row, 0, parentNodeIndex);
 }
 
 int QPsdLayerTreeItemModel::rowCount(const QModelIndex &parent) const
@@ -156,20 +193,8 @@ int QPsdLayerTreeItemModel::rowCount(const QModelIndex &parent) const
     }
 
     qint32 parentNodeIndex = parent.isValid() ? parent.internalId() : -1;
-    int count = 0;
-    for (auto it = d->treeNodeList.crbegin(); it != d->treeNodeList.crend(); ++it) {
-        const auto node = *it;
-
-        if (node.parentNodeIndex == parentNodeIndex) {
-            if (node.isCloseFolder) {
-                return count;
-            }
-
-            count++;
-        }
-    }
-
-    return count;
+    const auto *children = d->childNodeIndexes(parentNodeIndex);
+    return children ? children->size() : 0;
 }
 
 int QPsdLayerTreeItemModel::columnCount(const QModelIndex &parent) const
@@ -241,6 +266,7 @@ void QPsdLayerTreeItemModel::fromParser(const QPsdParser &parser)
     beginResetModel();
 
     d->treeNodeList.clear();
+    d->topLevelNodeIndexes.clear();
     d->groupIDs.clear();
     d->groupsMap.clear();
     d->clippingMasks.clear();
@@ -262,6 +288,9 @@ void QPsdLayerTreeItemModel::fromParser(const QPsdParser &parser)
                 d->groupIDs.append(id);
             }
             break; }
+        case 1033: // (Photoshop 4.0) Thumbnail resource, see QPsdThumbnail
+        case 1036: // (Photoshop 5.0) Thumbnail resource, see QPsdThumbnail
+            break;
         case 1082: // (Photoshop CS5) Print Information. 4 bytes (descriptor version = 16), Descriptor (see See Descriptor structure) Information about the current print settings in the document. The color management options.
         case 1083: // (Photoshop CS5) Print Style. 4 bytes (descriptor version = 16), Descriptor (see See Descriptor structure) Information about the current print style in the document. The printing marks, labels, ornaments, etc.
         {
@@ -380,6 +409,8 @@ void QPsdLayerTreeItemModel::fromParser(const QPsdParser &parser)
         d->clippingMasks.prepend({});
     }
 
+    d->buildChildNodeIndexes();
+
     const auto additionalLayerInformation = layerAndMaskInformation.additionalLayerInformation();
     if (additionalLayerInformation.contains("FMsk")) {
         d->filterMask = additionalLayerInformation.value("FMsk").value<QPsdFilterMask>();
@@ -498,25 +529,49 @@ bool QPsdLayerTreeItemModel::hasMergedAlpha() const
 }
 
 void QPsdLayerTreeItemModel::load(const QString &fileName)
+{
+    d->loadWatcher.cancel();
+    if (!beginLoad(fileName))
+        return;
+
+    QPsdParser parser;
+    parser.load(fileName);
+    endLoad(parser);
+}
+
+QFuture<QPsdParser> QPsdLayerTreeItemModel::loadAsync(const QString &fileName, QPsdParser::LoadOptions options)
+{
+    d->loadWatcher.cancel();
+    if (!beginLoad(fileName))
+        return {};
+
+    auto future = QPsdParser::loadAsync(fileName, options);
+    d->loadWatcher.setFuture(future);
+    return future;
+}
+
+bool QPsdLayerTreeItemModel::beginLoad(const QString &fileName)
 {
     d->fileInfo = QFileInfo(fileName);
     d->fileName = fileName;
     if (!d->fileInfo.exists()) {
         setErrorMessage(tr("File not found"));
-        return;
+        return false;
     }
     emit fileInfoChanged(d->fileInfo);
+    return true;
+}
 
-    QPsdParser parser;
-    parser.load(fileName);
-
+void QPsdLayerTreeItemModel::endLoad(const QPsdParser &parser, const QString &errorMessage)
+{
     fromParser(parser);
 
     const auto header = parser.fileHeader();
-    if (!header.errorString().isEmpty()) {
+    if (!errorMessage.isEmpty())
+        setErrorMessage(errorMessage);
+    else if (!header.errorString().isEmpty())
         setErrorMessage(header.errorString());
-        return;
-    }
+    emit loadFinished();
 }
 
 void QPsdLayerTreeItemModel::setErrorMessage(const QString &errorMessage)
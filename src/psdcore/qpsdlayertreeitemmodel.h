@@ -76,6 +76,15 @@ public:
     QPsdFilterMask filterMask() const;
     bool hasMergedAlpha() const;
 
+    /*!
+     * Starts loading \a fileName with QPsdParser::loadAsync() and returns its
+     * future. The model is rebuilt on its own thread when the load finishes,
+     * and a load that is still running is canceled first. load() parses on
+     * the calling thread instead.
+     */
+    QFuture<QPsdParser> loadAsync(const QString &fileName,
+                                  QPsdParser::LoadOptions options = QPsdParser::NoLoadOptions);
+
 public slots:
     void load(const QString &fileName);
 
@@ -85,8 +94,15 @@ private slots:
 signals:
     void fileInfoChanged(const QFileInfo &fileInfo);
     void errorOccurred(const QString &errorMessage);
+    // Progress of loadAsync(), see QPsdParser::loadAsync()
+    void loadProgress(int value, int maximum);
+    // The model has been rebuilt by load() or a loadAsync() that was not canceled
+    void loadFinished();
 
 private:
+    bool beginLoad(const QString &fileName);
+    void endLoad(const QPsdParser &parser, const QString &errorMessage = QString());
+
     class Private;
     QScopedPointer<Private> d;
 };
@@ -0,0 +1,90 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPSDPARALLEL_P_H
+#define QPSDPARALLEL_P_H
+
+#include <QtCore/QMutex>
+#include <QtCore/QThreadPool>
+#include <QtCore/QWaitCondition>
+
+#include <atomic>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+// Calls function(i) for every i in [0, count) on the global thread pool.
+// The calling thread takes part in the work and only waits for indices
+// that another thread has already claimed, so nested calls from inside a
+// pool thread cannot deadlock even when the pool is saturated.
+template <typename Function>
+void psdParallelFor(qsizetype count, Function function)
+{
+    if (count <= 0)
+        return;
+
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const qsizetype helpers = qMin<qsizetype>(pool->maxThreadCount(), count) - 1;
+    if (helpers <= 0) {
+        for (qsizetype i = 0; i < count; ++i)
+            function(i);
+        return;
+    }
+
+    struct State {
+        explicit State(qsizetype count, Function &&function)
+            : count(count), function(std::move(function))
+        {}
+        const qsizetype count;
+        Function function;
+        std::atomic<qsizetype> next = 0;
+        std::atomic<qsizetype> done = 0;
+        QMutex mutex;
+        QWaitCondition finished;
+    };
+    const auto state = std::make_shared<State>(count, std::move(function));
+
+    const auto work = [state] {
+        qsizetype i;
+        while ((i = state->next.fetch_add(1, std::memory_order_relaxed)) < state->count) {
+            state->function(i);
+            if (state->done.fetch_add(1, std::memory_order_acq_rel) + 1 == state->count) {
+                QMutexLocker locker(&state->mutex);
+                state->finished.wakeAll();
+            }
+        }
+    };
+
+    // Helpers that cannot start right away are not queued; the caller and
+    // the threads that did start pick up their share
+    for (qsizetype i = 0; i < helpers; ++i) {
+        if (!pool->tryStart(work))
+            break;
+    }
+    work();
+
+    QMutexLocker locker(&state->mutex);
+    while (state->done.load(std::memory_order_acquire) < state->count)
+        state->finished.wait(&state->mutex);
+}
+
+// Splits [0, count) into blocks of at least grainSize items and calls
+// function(begin, end) for each block with psdParallelFor().
+template <typename Function>
+void psdParallelForBlocks(qsizetype count, qsizetype grainSize, Function function)
+{
+    if (count <= 0)
+        return;
+    grainSize = qMax<qsizetype>(grainSize, 1);
+    const qsizetype maxBlocks = qMax(QThreadPool::globalInstance()->maxThreadCount(), 1) * 4;
+    const qsizetype blockSize = qMax(grainSize, (count + maxBlocks - 1) / maxBlocks);
+    const qsizetype blocks = (count + blockSize - 1) / blockSize;
+    psdParallelFor(blocks, [&function, count, blockSize](qsizetype block) {
+        const qsizetype begin = block * blockSize;
+        function(begin, qMin(begin + blockSize, count));
+    });
+}
+
+QT_END_NAMESPACE
+
+#endif // QPSDPARALLEL_P_H
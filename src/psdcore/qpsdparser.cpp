@@ -2,8 +2,16 @@
 // SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qpsdparser.h"
+#include "qpsdarena_p.h"
+#include "qpsdbytecursor.h"
+#include "qpsdparallel_p.h"
 
 #include <QtCore/QFile>
+#include <QtCore/QPromise>
+
+#include <atomic>
+#include <limits>
+#include <memory>
 
 QT_BEGIN_NAMESPACE
 
@@ -34,38 +42,215 @@ QPsdParser &QPsdParser::operator=(const QPsdParser &other)
 
 QPsdParser::~QPsdParser() = default;
 
-void QPsdParser::load(const QString &psd)
+static std::unique_ptr<QIODevice> openSource(const QString &psd, QPsdParser::LoadOptions options)
 {
-    QFile file(psd);
-    if (!file.open(QFile::ReadOnly)) {
-        qWarning() << file.errorString();
-        return;
+    if (options.testFlag(QPsdParser::MemoryMapped)) {
+        auto cursor = std::make_unique<QPsdByteCursor>();
+        if (!cursor->map(psd)) {
+            qWarning() << cursor->errorString();
+            return {};
+        }
+        return cursor;
+    }
+
+    auto file = std::make_unique<QFile>(psd);
+    if (!file->open(QFile::ReadOnly)) {
+        qWarning() << file->errorString();
+        return {};
+    }
+    return file;
+}
+
+// Reports the bytes a section consumed to the observer of source, if any
+class SectionProgress
+{
+public:
+    explicit SectionProgress(QIODevice *source)
+        : source(source), start(source->pos())
+    {}
+    ~SectionProgress()
+    {
+        QPsdSection::advance(source, source->pos() - start);
     }
 
-    d->fileHeader = QPsdFileHeader(&file);
-    if (!file.isOpen())
+private:
+    QIODevice *source;
+    const qint64 start;
+};
+
+void QPsdParser::load(const QString &psd, LoadOptions options)
+{
+    const auto source = openSource(psd, options);
+    if (source)
+        load(source.get(), options);
+}
+
+void QPsdParser::load(QIODevice *source, LoadOptions options)
+{
+    load(source, options, nullptr);
+}
+
+void QPsdParser::loadCompositeRegion(const QString &psd, const QRect &rect, LoadOptions options)
+{
+    const auto source = openSource(psd, options);
+    if (source)
+        loadCompositeRegion(source.get(), rect, options);
+}
+
+void QPsdParser::loadCompositeRegion(QIODevice *source, const QRect &rect, LoadOptions options)
+{
+    load(source, options | CompositeOnly, &rect);
+}
+
+void QPsdParser::load(QIODevice *source, LoadOptions options, const QRect *compositeRegion)
+{
+    // The blocks of the arena stay alive as long as the sections referring
+    // to them, the arena itself is only needed while reading
+    QPsdArena arena;
+    QPsdArena::Scope scope(options.testFlag(Arena) ? &arena : nullptr);
+
+    auto readOptions = QPsdSection::readOptions(source);
+    readOptions.setFlag(QPsdSection::ParallelLayers, options.testFlag(ParallelDecode));
+    readOptions.setFlag(QPsdSection::SkipChannelData, options.testFlag(Skeleton));
+    readOptions.setFlag(QPsdSection::SkipLayerAndMaskInformation, options.testFlag(CompositeOnly));
+    QPsdSection::setReadOptions(source, readOptions);
+
+    {
+        SectionProgress progress(source);
+        d->fileHeader = QPsdFileHeader(source);
+    }
+    if (!source->isOpen() || QPsdSection::isCanceled(source))
         return;
 
-    d->colorModeData = QPsdColorModeData(&file);
-    if (!file.isOpen())
+    {
+        SectionProgress progress(source);
+        d->colorModeData = QPsdColorModeData(source);
+    }
+    if (!source->isOpen() || QPsdSection::isCanceled(source))
         return;
 
-    d->imageResources = QPsdImageResources(&file);
-    if (!file.isOpen())
+    {
+        SectionProgress progress(source);
+        d->imageResources = QPsdImageResources(source);
+    }
+    if (!source->isOpen() || QPsdSection::isCanceled(source))
         return;
 
-    d->layerAndMaskInformation = QPsdLayerAndMaskInformation(&file);
-    if (!file.isOpen())
+    // Layer records and channels report their own progress
+    d->layerAndMaskInformation = QPsdLayerAndMaskInformation(source);
+    if (!source->isOpen() || QPsdSection::isCanceled(source))
         return;
 
     // Set file header on layer info so layer records have proper document size
     d->layerAndMaskInformation.setFileHeader(d->fileHeader);
 
-    d->imageData = QPsdImageData(d->fileHeader, &file);
-    if (!file.isOpen())
+    // The composite is not read in skeleton mode
+    if (options.testFlag(Skeleton)) {
+        d->imageData = QPsdImageData();
         return;
+    }
+
+    // Decoding needs the depth from the file header, so it can only start now
+    if (options.testFlag(ParallelDecode)) {
+        const auto records = d->layerAndMaskInformation.layerInfo().records();
+        const auto images = d->layerAndMaskInformation.layerInfo().channelImageData();
+        const auto observer = QPsdSection::loadObserver(source);
+        // Decoding a layer counts as much work as reading its channels
+        const auto layerBytes = [&records](qsizetype i) {
+            qint64 bytes = 0;
+            if (i < records.size()) {
+                for (const auto &channelInfo : records.at(i).channelInfo())
+                    bytes += channelInfo.length();
+            }
+            return bytes;
+        };
+        if (observer) {
+            qint64 total = 0;
+            for (qsizetype i = 0; i < images.size(); i++)
+                total += layerBytes(i);
+            observer->addWork(total);
+        }
+        psdParallelFor(images.size(), [&](qsizetype i) {
+            if (observer && observer->isCanceled())
+                return;
+            images.at(i).decodeChannels();
+            if (observer)
+                observer->advance(layerBytes(i));
+        });
+        if (observer && observer->isCanceled())
+            return;
+    }
+
+    SectionProgress progress(source);
+    d->imageData = compositeRegion ? QPsdImageData(d->fileHeader, source, *compositeRegion)
+                                   : QPsdImageData(d->fileHeader, source);
+}
+
+namespace {
+// Forwards the progress of the sections to a QPromise. QFuture progress is an
+// int, so the byte counts are shifted right until twice the file size fits;
+// the decode stage never adds more than the file size.
+class PromiseObserver : public QPsdSection::LoadObserver
+{
+public:
+    PromiseObserver(QPromise<QPsdParser> &promise, qint64 fileSize)
+        : promise(promise)
+    {
+        while (((fileSize * 2) >> shift) > std::numeric_limits<int>::max())
+            shift++;
+        addWork(fileSize);
+    }
 
-    file.close();
+    bool isCanceled() const override { return promise.isCanceled(); }
+
+    void addWork(qint64 bytes) override
+    {
+        const qint64 value = total.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        promise.setProgressRange(0, int(value >> shift));
+    }
+
+    void advance(qint64 bytes) override
+    {
+        const qint64 value = done.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        promise.setProgressValue(int(qMin(value, total.load(std::memory_order_relaxed)) >> shift));
+    }
+
+    void finish()
+    {
+        promise.setProgressValue(int(total.load(std::memory_order_relaxed) >> shift));
+    }
+
+private:
+    QPromise<QPsdParser> &promise;
+    int shift = 0;
+    std::atomic<qint64> total = 0;
+    std::atomic<qint64> done = 0;
+};
+} // namespace
+
+QFuture<QPsdParser> QPsdParser::loadAsync(const QString &source, LoadOptions options)
+{
+    const auto promise = std::make_shared<QPromise<QPsdParser>>();
+    promise->start();
+    auto future = promise->future();
+
+    QThreadPool::globalInstance()->start([promise, source, options] {
+        const auto device = openSource(source, options);
+        if (device) {
+            PromiseObserver observer(*promise, device->size());
+            QPsdSection::setLoadObserver(device.get(), &observer);
+
+            QPsdParser parser;
+            parser.load(device.get(), options);
+            QPsdSection::setLoadObserver(device.get(), nullptr);
+            if (!promise->isCanceled()) {
+                observer.finish();
+                promise->addResult(parser);
+            }
+        }
+        promise->finish();
+    });
+    return future;
 }
 
 QPsdFileHeader QPsdParser::fileHeader() const
@@ -5,6 +5,7 @@
 #define QPSDCORE_H
 
 #include <QtPsdCore/qpsdcoreglobal.h>
+#include <QtCore/QFuture>
 #include <QtCore/QSharedDataPointer>
 
 #include <QtPsdCore/qpsdfileheader.h>
@@ -18,6 +19,29 @@ QT_BEGIN_NAMESPACE
 class Q_PSDCORE_EXPORT QPsdParser
 {
 public:
+    enum LoadOption {
+        NoLoadOptions = 0x0,
+        // Map the file into memory and parse from a QPsdByteCursor instead of
+        // reading through QFile. Uncompressed channel payloads alias the mapping.
+        MemoryMapped = 0x1,
+        // Parse the layers' channel data concurrently and decode every layer's
+        // pixels on the thread pool during load instead of on first access.
+        ParallelDecode = 0x2,
+        // Read the header, image resources and all layer records with their
+        // additional layer information, but seek past the layers' channel data
+        // and the composite image. Nothing is read or allocated for pixels.
+        Skeleton = 0x4,
+        // Read the header, color mode data and image resources, seek past the
+        // layer and mask information section using its length and read only
+        // the composite image. The layer section is left empty.
+        CompositeOnly = 0x8,
+        // Read the encoded channel data of a document that is not memory
+        // mapped into shared blocks instead of one buffer per channel. A
+        // block is released once no section refers to it any more.
+        Arena = 0x10,
+    };
+    Q_DECLARE_FLAGS(LoadOptions, LoadOption)
+
     QPsdParser();
     QPsdParser(const QPsdParser &other);
     QPsdParser &operator=(const QPsdParser &other);
@@ -60,8 +84,36 @@ public:
     /*!
      * Loads and parses a PSD file from the specified source path.
      * \param source The path to the PSD file to load.
+     * \param options Flags selecting how the file is read.
+     */
+    void load(const QString &source, LoadOptions options = NoLoadOptions);
+
+    /*!
+     * Parses a PSD document from an open \a source device. Passing a
+     * QPsdByteCursor lets sections take slices of its storage instead of
+     * copying payloads.
+     */
+    void load(QIODevice *source, LoadOptions options = NoLoadOptions);
+
+    /*!
+     * Reads \a source like load() with CompositeOnly, but only the pixels of
+     * \a rect of the composite, which imageData() then holds the way
+     * QPsdImageData::region() returns them. The scan lines outside \a rect
+     * are seeked past, so a large composite is not read whole even when the
+     * file is not memory mapped.
+     */
+    void loadCompositeRegion(const QString &source, const QRect &rect, LoadOptions options = NoLoadOptions);
+    void loadCompositeRegion(QIODevice *source, const QRect &rect, LoadOptions options = NoLoadOptions);
+
+    /*!
+     * Loads \a source on the global thread pool and returns a future for the
+     * parsed document. As with load(), the layers are decoded on first access
+     * unless \a options contains ParallelDecode. The progress of the future counts the bytes read and
+     * decoded so far, scaled down to fit into an int for very large files.
+     * Canceling the future stops the load between layers and channels. No
+     * result is reported for a canceled load or a file that cannot be opened.
      */
-    void load(const QString &source);
+    static QFuture<QPsdParser> loadAsync(const QString &source, LoadOptions options = NoLoadOptions);
 
     void setFileHeader(const QPsdFileHeader &header);
     void setColorModeData(const QPsdColorModeData &data);
@@ -70,10 +122,14 @@ public:
     void setImageData(const QPsdImageData &data);
 
 private:
+    void load(QIODevice *source, LoadOptions options, const QRect *compositeRegion);
+
     class Private;
     QSharedDataPointer<Private> d;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(QPsdParser::LoadOptions)
+
 QT_END_NAMESPACE
 
 #endif // QPSDCORE_H
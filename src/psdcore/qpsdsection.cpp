@@ -2,11 +2,15 @@
 // SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include "qpsdsection.h"
+#include "qpsdarena_p.h"
 #include "qpsdcolorspace.h"
+#include "qpsdparallel_p.h"
 
 #include <QtCore/QStringDecoder>
 #include <QtCore/QStringEncoder>
 
+#include <cstring>
+
 QT_BEGIN_NAMESPACE
 
 class QPsdSection::Private : public QSharedData
@@ -68,6 +72,61 @@ QByteArray QPsdSection::readByteArray(QIODevice *source, quint32 size, quint32 *
     return source->read(size);
 }
 
+QPsdByteSlice QPsdSection::readByteSlice(QIODevice *source, qint64 size, qint64 *length)
+{
+    if (length) {
+        if (size > *length) {
+            qWarning("readByteSlice: requested %lld bytes with only %lld bytes remaining; clamping",
+                     size, *length);
+            size = *length;
+        }
+        *length -= size;
+    }
+    // A QPsdByteCursor hands out a view of its storage; other devices copy
+    if (auto cursor = qobject_cast<QPsdByteCursor *>(source))
+        return cursor->readSlice(size);
+    if (auto arena = QPsdArena::current())
+        return arena->read(source, size);
+    const qint64 offset = source->pos();
+    return QPsdByteSlice(source->read(size), offset);
+}
+
+static const char readOptionsProperty[] = "_q_psdReadOptions";
+
+QPsdSection::ReadOptions QPsdSection::readOptions(QIODevice *source)
+{
+    return ReadOptions::fromInt(source->property(readOptionsProperty).toInt());
+}
+
+void QPsdSection::setReadOptions(QIODevice *source, ReadOptions options)
+{
+    source->setProperty(readOptionsProperty, options.toInt());
+}
+
+static const char loadObserverProperty[] = "_q_psdLoadObserver";
+
+QPsdSection::LoadObserver *QPsdSection::loadObserver(QIODevice *source)
+{
+    return static_cast<LoadObserver *>(source->property(loadObserverProperty).value<void *>());
+}
+
+void QPsdSection::setLoadObserver(QIODevice *source, LoadObserver *observer)
+{
+    source->setProperty(loadObserverProperty, QVariant::fromValue(static_cast<void *>(observer)));
+}
+
+quint64 QPsdSection::readLength(QIODevice *source, quint32 *length)
+{
+    return readLength(source, readOptions(source), length);
+}
+
+quint64 QPsdSection::readLength(QIODevice *source, ReadOptions options, quint32 *length)
+{
+    if (options.testFlag(LargeDocument))
+        return readU64(source, length);
+    return readU32(source, length);
+}
+
 QString QPsdSection::readString(QIODevice *source, quint32 *length)
 {
     // https://www.adobe.com/devnet-apps/photoshop/fileformatashtml/#UnicodeStringDefine
@@ -301,4 +360,144 @@ QByteArray QPsdSection::encodePackBits(const QByteArray &rawData, int rowWidth,
     return result;
 }
 
+qsizetype QPsdSection::decodePackBits(const uchar *src, qsizetype srcSize, uchar *dst, qsizetype dstSize)
+{
+    const uchar *in = src;
+    const uchar *const inEnd = src + srcSize;
+    uchar *out = dst;
+    uchar *const outEnd = dst + dstSize;
+
+    while (in < inEnd && out < outEnd) {
+        const qint8 header = static_cast<qint8>(*in++);
+        if (header >= 0) {
+            // Literal run: copy the next header + 1 bytes
+            const qsizetype available = qMin(qsizetype(header + 1), qsizetype(inEnd - in));
+            const qsizetype count = qMin(available, qsizetype(outEnd - out));
+            memcpy(out, in, count);
+            in += available;
+            out += count;
+        } else if (header != -128) {
+            // Repeat run: the next byte repeated 1 - header times
+            if (in == inEnd)
+                break;
+            const qsizetype count = qMin(qsizetype(1 - header), qsizetype(outEnd - out));
+            memset(out, *in++, count);
+            out += count;
+        }
+        // -128 is a no-op
+    }
+    return out - dst;
+}
+
+qsizetype QPsdSection::decodePackBits(const uchar *src, qsizetype srcSize, qsizetype skip, uchar *dst, qsizetype dstSize)
+{
+    const uchar *in = src;
+    const uchar *const inEnd = src + srcSize;
+    uchar *out = dst;
+    uchar *const outEnd = dst + dstSize;
+
+    while (in < inEnd && out < outEnd) {
+        const qint8 header = static_cast<qint8>(*in++);
+        if (header >= 0) {
+            const qsizetype available = qMin(qsizetype(header + 1), qsizetype(inEnd - in));
+            if (skip >= available) {
+                skip -= available;
+            } else {
+                const qsizetype count = qMin(available - skip, qsizetype(outEnd - out));
+                memcpy(out, in + skip, count);
+                out += count;
+                skip = 0;
+            }
+            in += available;
+        } else if (header != -128) {
+            if (in == inEnd)
+                break;
+            const qsizetype repeat = 1 - header;
+            if (skip >= repeat) {
+                skip -= repeat;
+            } else {
+                const qsizetype count = qMin(repeat - skip, qsizetype(outEnd - out));
+                memset(out, *in, count);
+                out += count;
+                skip = 0;
+            }
+            in++;
+        }
+    }
+    return out - dst;
+}
+
+qsizetype QPsdSection::packBitsDecodedSize(const uchar *src, qsizetype srcSize)
+{
+    const uchar *in = src;
+    const uchar *const inEnd = src + srcSize;
+    qsizetype size = 0;
+
+    while (in < inEnd) {
+        const qint8 header = static_cast<qint8>(*in++);
+        if (header >= 0) {
+            const qsizetype count = qMin(qsizetype(header + 1), qsizetype(inEnd - in));
+            size += count;
+            in += count;
+        } else if (header != -128) {
+            if (in == inEnd)
+                break;
+            size += 1 - header;
+            in++;
+        }
+    }
+    return size;
+}
+
+QByteArray QPsdSection::decodePackBits(QByteArrayView rleData, int height, int countSize)
+{
+    if (height <= 0)
+        return {};
+    const qsizetype tableSize = qsizetype(height) * countSize;
+    if (rleData.size() < tableSize) {
+        qWarning("decodePackBits: %lld bytes is too short for %d byte counts",
+                 qlonglong(rleData.size()), height);
+        return {};
+    }
+
+    const auto *counts = reinterpret_cast<const uchar *>(rleData.data());
+    const uchar *const dataStart = counts + tableSize;
+    const qsizetype dataSize = rleData.size() - tableSize;
+
+    // The byte count table gives every line's input offset up front, and a
+    // first pass over the control bytes gives its output offset. After that
+    // the lines are independent and are decoded in parallel.
+    QList<qsizetype> inOffsets(height + 1);
+    for (int y = 0; y < height; y++) {
+        const qsizetype count = countSize == 4 ? qsizetype(qFromBigEndian<quint32>(counts + y * 4))
+                                               : qsizetype(qFromBigEndian<quint16>(counts + y * 2));
+        inOffsets[y + 1] = qMin(inOffsets.at(y) + count, dataSize);
+    }
+
+    // Blocks of lines worth roughly 256 KiB of input each
+    constexpr qsizetype targetBlockBytes = 256 * 1024;
+    const qsizetype grainSize = dataSize > 0 ? qMax<qsizetype>(1, targetBlockBytes * height / dataSize) : height;
+
+    QList<qsizetype> outOffsets(height + 1);
+    qsizetype *lineSizes = outOffsets.data() + 1;
+    psdParallelForBlocks(height, grainSize, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype y = begin; y < end; y++) {
+            lineSizes[y] = packBitsDecodedSize(dataStart + inOffsets.at(y),
+                                                    inOffsets.at(y + 1) - inOffsets.at(y));
+        }
+    });
+    for (int y = 0; y < height; y++)
+        outOffsets[y + 1] += outOffsets.at(y);
+
+    QByteArray ret(outOffsets.at(height), Qt::Uninitialized);
+    auto *out = reinterpret_cast<uchar *>(ret.data());
+    psdParallelForBlocks(height, grainSize, [&](qsizetype begin, qsizetype end) {
+        for (qsizetype y = begin; y < end; y++) {
+            decodePackBits(dataStart + inOffsets.at(y), inOffsets.at(y + 1) - inOffsets.at(y),
+                           out + outOffsets.at(y), outOffsets.at(y + 1) - outOffsets.at(y));
+        }
+    });
+    return ret;
+}
+
 QT_END_NAMESPACE
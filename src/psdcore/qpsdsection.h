@@ -5,6 +5,7 @@
 #define QPSDSECTION_H
 
 #include <QtPsdCore/qpsdcoreglobal.h>
+#include <QtPsdCore/qpsdbytecursor.h>
 
 #include <QtCore/QIODevice>
 #include <QtCore/QRect>
@@ -19,6 +20,23 @@ class QPsdColorSpace;
 class Q_PSDCORE_EXPORT QPsdSection
 {
 public:
+    // Document wide state the sections need while reading, attached to the
+    // source device by the file header and QPsdParser. Looking them up goes
+    // through a dynamic property, so sections read them once and hand them
+    // to the records and blocks they contain.
+    enum ReadOption {
+        NoReadOptions = 0x0,
+        // Large Document Format (PSB): 8-byte lengths, 4-byte RLE counts
+        LargeDocument = 0x1,
+        // Split layer channel data into per-layer views and parse them concurrently
+        ParallelLayers = 0x2,
+        // Seek past layer channel data without reading it
+        SkipChannelData = 0x4,
+        // Seek past the whole layer and mask information section
+        SkipLayerAndMaskInformation = 0x8,
+    };
+    Q_DECLARE_FLAGS(ReadOptions, ReadOption)
+
     QPsdSection();
     QPsdSection(const QPsdSection &other);
     QPsdSection &operator=(const QPsdSection &other);
@@ -27,6 +45,35 @@ public:
 
     bool hasError() const { return !errorString().isEmpty(); }
     QString errorString() const;
+
+    static ReadOptions readOptions(QIODevice *source);
+    static void setReadOptions(QIODevice *source, ReadOptions options);
+
+    // Follows a load in progress and can stop it early. The sections report
+    // the bytes they consume and give up between layers and channels once
+    // isCanceled() returns true. Layers may be parsed on several threads.
+    class LoadObserver
+    {
+    public:
+        virtual ~LoadObserver() = default;
+        virtual bool isCanceled() const = 0;
+        // Adds bytes to the total amount of work of the load
+        virtual void addWork(qint64 bytes) = 0;
+        virtual void advance(qint64 bytes) = 0;
+    };
+
+    static LoadObserver *loadObserver(QIODevice *source);
+    static void setLoadObserver(QIODevice *source, LoadObserver *observer);
+
+    static bool isCanceled(QIODevice *source) {
+        const auto observer = loadObserver(source);
+        return observer && observer->isCanceled();
+    }
+    static void advance(QIODevice *source, qint64 bytes) {
+        if (const auto observer = loadObserver(source))
+            observer->advance(bytes);
+    }
+
 protected:
     void setErrorString(const QString &errorString);
 
@@ -35,13 +82,22 @@ protected:
             *length -= size;
         source->skip(size);
     }
+    // PSB channel and composite data can exceed 4 GiB, so they are measured
+    // in 64 bits with these overloads
+    static void skip(QIODevice *source, qint64 size, qint64 *length) {
+        *length -= size;
+        source->skip(size);
+    }
 
     template<typename T>
     static T read(QIODevice *source, quint32 *length = nullptr) {
-        QByteArray data = source->read(sizeof(T));
+        // Read into a local instead of through QIODevice::read(qint64), which
+        // allocates a temporary QByteArray for every integer
+        T data{};
+        source->read(reinterpret_cast<char *>(&data), sizeof(T));
         if (length)
             *length -= sizeof(T);
-        return qFromBigEndian<T>(data.constData());
+        return qFromBigEndian<T>(&data);
     }
 
     static qint8 readS8(QIODevice *source, quint32 *length = nullptr) {
@@ -77,10 +133,11 @@ protected:
 
     template<typename T>
     static T readLE(QIODevice *source, quint32 *length = nullptr) {
-        QByteArray data = source->read(sizeof(T));
+        T data{};
+        source->read(reinterpret_cast<char *>(&data), sizeof(T));
         if (length)
             *length -= sizeof(T);
-        return qFromLittleEndian<T>(data.constData());
+        return qFromLittleEndian<T>(&data);
     }
 
     static quint32 readU32LE(QIODevice *source, quint32 *length = nullptr) {
@@ -89,6 +146,21 @@ protected:
 
     static QByteArray readPascalString(QIODevice *source, int padding = 1, quint32 *length = nullptr);
     static QByteArray readByteArray(QIODevice *source, quint32 size, quint32 *length = nullptr);
+    // Measured in 64 bits, PSB channel and composite data can exceed 4 GiB
+    static QPsdByteSlice readByteSlice(QIODevice *source, qint64 size, qint64 *length = nullptr);
+
+    /*!
+     * Returns true if \a source is a Large Document Format (PSB) file. The file
+     * header marks the device when it reads version 2, and the sections use it
+     * to pick between 4- and 8-byte length fields.
+     */
+    static bool isLargeDocument(QIODevice *source) { return readOptions(source).testFlag(LargeDocument); }
+
+    /*!
+     * Reads a length field that is 4 bytes in PSD and 8 bytes in PSB documents.
+     */
+    static quint64 readLength(QIODevice *source, quint32 *length = nullptr);
+    static quint64 readLength(QIODevice *source, ReadOptions options, quint32 *length = nullptr);
     static QString readString(QIODevice *source, quint32 *length = nullptr);
     static QString readStringLE(QIODevice *source, quint32 *length = nullptr);
 
@@ -169,6 +241,31 @@ public:
 
     static QByteArray encodePackBits(const QByteArray &rawData, int rowWidth, int height);
 
+    /*!
+     * Decodes PackBits data from \a src into the presized buffer \a dst and
+     * returns the number of bytes written. Decoding stops at the end of either
+     * buffer, so truncated or corrupt input never writes out of bounds.
+     */
+    static qsizetype decodePackBits(const uchar *src, qsizetype srcSize, uchar *dst, qsizetype dstSize);
+
+    /*!
+     * Same as above, but drops the first \a skip decoded bytes, so a span of a
+     * scan line can be extracted without expanding the whole line.
+     */
+    static qsizetype decodePackBits(const uchar *src, qsizetype srcSize, qsizetype skip, uchar *dst, qsizetype dstSize);
+
+    /*!
+     * Returns the number of bytes decodePackBits() produces for \a src.
+     */
+    static qsizetype packBitsDecodedSize(const uchar *src, qsizetype srcSize);
+
+    /*!
+     * Inverse of encodePackBits(): decodes \a height scan lines given as a table
+     * of big-endian byte counts followed by the PackBits data of each line. The
+     * counts are \a countSize bytes wide, 2 in PSD and 4 in PSB documents.
+     */
+    static QByteArray decodePackBits(QByteArrayView rleData, int height, int countSize = 2);
+
 protected:
     static int even(int size)
     {
@@ -215,6 +312,8 @@ private:
     QSharedDataPointer<Private> d;
 };
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(QPsdSection::ReadOptions)
+
 QT_END_NAMESPACE
 
 #endif // QPSDSECTION_H
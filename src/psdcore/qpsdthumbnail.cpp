@@ -0,0 +1,154 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qpsdthumbnail.h"
+#include "qpsdcolormodedata.h"
+#include "qpsdfileheader.h"
+#include "qpsdimageresources.h"
+
+#include <QtCore/QDataStream>
+#include <QtCore/QFile>
+
+QT_BEGIN_NAMESPACE
+
+class QPsdThumbnail::Private : public QSharedData
+{
+public:
+    bool valid = false;
+    bool bgr = false;
+    QPsdThumbnail::Format format = QPsdThumbnail::JpegRgb;
+    quint32 width = 0;
+    quint32 height = 0;
+    quint32 widthBytes = 0;
+    quint16 bitsPerPixel = 0;
+    QByteArray data;
+};
+
+QPsdThumbnail::QPsdThumbnail()
+    : d(new Private)
+{
+}
+
+QPsdThumbnail::QPsdThumbnail(const QPsdImageResourceBlock &block)
+    : d(new Private)
+{
+    if (block.id() != 1036 && block.id() != 1033) {
+        qWarning() << "QPsdThumbnail: Invalid block ID" << block.id() << "expected 1036 or 1033";
+        return;
+    }
+
+    const QByteArray data = block.data();
+    if (data.size() < 28) {
+        qWarning() << "QPsdThumbnail: Insufficient data size" << data.size() << "expected at least 28";
+        return;
+    }
+
+    QDataStream stream(data);
+    stream.setByteOrder(QDataStream::BigEndian);
+
+    // Thumbnail resource format:
+    // 4 bytes: Format. 1 = kJpegRGB, 0 = kRawRGB
+    // 4 bytes: Width of thumbnail in pixels
+    // 4 bytes: Height of thumbnail in pixels
+    // 4 bytes: Widthbytes: Padded row bytes = (width * bits per pixel + 31) / 32 * 4
+    // 4 bytes: Total size = widthbytes * height * planes
+    // 4 bytes: Size after compression. Used for consistency check
+    // 2 bytes: Bits per pixel. = 24
+    // 2 bytes: Number of planes. = 1
+    // Variable: JFIF data in RGB format (BGR for resource 1033)
+
+    quint32 format;
+    quint32 totalSize;
+    quint32 compressedSize;
+    quint16 planes;
+
+    stream >> format >> d->width >> d->height >> d->widthBytes >> totalSize >> compressedSize
+           >> d->bitsPerPixel >> planes;
+
+    d->format = static_cast<Format>(format);
+    d->bgr = block.id() == 1033;
+    d->data = data.mid(28);
+    d->valid = true;
+}
+
+QPsdThumbnail::QPsdThumbnail(const QPsdThumbnail &other)
+    : d(other.d)
+{
+}
+
+QPsdThumbnail &QPsdThumbnail::operator=(const QPsdThumbnail &other)
+{
+    if (this != &other) {
+        d = other.d;
+    }
+    return *this;
+}
+
+QPsdThumbnail::~QPsdThumbnail() = default;
+
+QPsdThumbnail QPsdThumbnail::fromFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        qWarning() << file.errorString();
+        return {};
+    }
+    return fromDevice(&file);
+}
+
+QPsdThumbnail QPsdThumbnail::fromDevice(QIODevice *source)
+{
+    const QPsdFileHeader header(source);
+    if (header.hasError())
+        return {};
+    const QPsdColorModeData colorModeData(source);
+    if (!source->isOpen())
+        return {};
+
+    const auto block = QPsdImageResources::findBlock(source, { 1036, 1033 });
+    if (block.id() == 0)
+        return {};
+    return QPsdThumbnail(block);
+}
+
+bool QPsdThumbnail::isValid() const
+{
+    return d->valid;
+}
+
+QPsdThumbnail::Format QPsdThumbnail::format() const
+{
+    return d->format;
+}
+
+quint32 QPsdThumbnail::width() const
+{
+    return d->width;
+}
+
+quint32 QPsdThumbnail::height() const
+{
+    return d->height;
+}
+
+quint32 QPsdThumbnail::widthBytes() const
+{
+    return d->widthBytes;
+}
+
+quint16 QPsdThumbnail::bitsPerPixel() const
+{
+    return d->bitsPerPixel;
+}
+
+bool QPsdThumbnail::isBgr() const
+{
+    return d->bgr;
+}
+
+QByteArray QPsdThumbnail::data() const
+{
+    return d->data;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,59 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPSDTHUMBNAIL_H
+#define QPSDTHUMBNAIL_H
+
+#include <QtPsdCore/qpsdcoreglobal.h>
+#include <QtCore/QSharedDataPointer>
+
+QT_BEGIN_NAMESPACE
+
+class QIODevice;
+class QPsdImageResourceBlock;
+
+class Q_PSDCORE_EXPORT QPsdThumbnail
+{
+public:
+    enum Format {
+        RawRgb = 0,
+        JpegRgb = 1,
+    };
+
+    QPsdThumbnail();
+    explicit QPsdThumbnail(const QPsdImageResourceBlock &block);
+    QPsdThumbnail(const QPsdThumbnail &other);
+    QPsdThumbnail &operator=(const QPsdThumbnail &other);
+    ~QPsdThumbnail();
+
+    bool isValid() const;
+
+    Format format() const;
+    quint32 width() const;
+    quint32 height() const;
+    // Padded row size of the raw image
+    quint32 widthBytes() const;
+    quint16 bitsPerPixel() const;
+
+    // Photoshop 4.0 thumbnails (resource 1033) store BGR instead of RGB
+    bool isBgr() const;
+
+    // JPEG or raw pixel data following the thumbnail header
+    QByteArray data() const;
+
+    /*!
+     * Reads the thumbnail of \a fileName. Only the file header, the color
+     * mode data and the image resource headers are read; the walk stops at
+     * the thumbnail, so layers and the composite are never touched.
+     */
+    static QPsdThumbnail fromFile(const QString &fileName);
+    static QPsdThumbnail fromDevice(QIODevice *source);
+
+private:
+    class Private;
+    QSharedDataPointer<Private> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPSDTHUMBNAIL_H
@@ -251,6 +251,8 @@ void QPsdExporterTreeItemModel::setSourceModel(QAbstractItemModel *source)
             connect(model, &QPsdLayerTreeItemModel::errorOccurred, this, [this](const QString &errorMessage) {
                 setErrorMessage(errorMessage);
             }),
+            connect(model, &QPsdLayerTreeItemModel::loadProgress, this, &QPsdExporterTreeItemModel::loadProgress),
+            connect(model, &QPsdLayerTreeItemModel::loadFinished, this, &QPsdExporterTreeItemModel::loadFinished),
         };
     } else if (source) {
         // Non-PSD source model: connect modelReset only
@@ -450,6 +452,15 @@ void QPsdExporterTreeItemModel::load(const QString &fileName)
         model->load(fileName);
 }
 
+QFuture<QPsdParser> QPsdExporterTreeItemModel::loadAsync(const QString &fileName)
+{
+    d->setDefaultHintFile(fileName);
+    auto *model = dynamic_cast<QPsdLayerTreeItemModel *>(sourceModel());
+    if (!model)
+        return {};
+    return model->loadAsync(fileName);
+}
+
 static QJsonObject serializeLayerHints(const QPsdExporterTreeItemModel *self)
 {
     QJsonObject layerHintsJson;
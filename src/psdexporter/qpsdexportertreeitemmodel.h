@@ -191,6 +191,9 @@ public:
     QMap<QString, DesignToken> designTokens() const;
     void setDesignTokens(const QMap<QString, DesignToken> &tokens);
 
+    // Loads fileName into the source model with QPsdLayerTreeItemModel::loadAsync()
+    QFuture<QPsdParser> loadAsync(const QString &fileName);
+
 public slots:
     void load(const QString &fileName);
     void save();
@@ -201,6 +204,8 @@ private slots:
 signals:
     void fileInfoChanged(const QFileInfo &fileInfo);
     void errorOccurred(const QString &errorMessage);
+    void loadProgress(int value, int maximum);
+    void loadFinished();
 
 private:
     class Private;
@@ -1118,9 +1118,9 @@ void QPsdQmlExporterPlugin::applyAdjustmentLayer(const QPsdAbstractLayerItem *it
     const QByteArray key = adj->adjustmentKey();
     const auto ali = item->record().additionalLayerInformation();
     // ALI data may be a QVariantMap (custom plugins) or QPsdDescriptor (v16descriptor plugin)
-    QVariantMap data = ali.value(key).toMap();
-    if (data.isEmpty() && ali.value(key).canConvert<QPsdDescriptor>()) {
-        const auto desc = ali.value(key).value<QPsdDescriptor>();
+    QVariantMap data = ali.value(QPsdFourCC(key)).toMap();
+    if (data.isEmpty() && ali.value(QPsdFourCC(key)).canConvert<QPsdDescriptor>()) {
+        const auto desc = ali.value(QPsdFourCC(key)).value<QPsdDescriptor>();
         const auto hash = desc.data();
         for (auto it = hash.cbegin(); it != hash.cend(); ++it)
             data.insert(QString::fromLatin1(it.key()), it.value());
@@ -1282,12 +1282,12 @@ void QPsdQmlExporterPlugin::applyAdjustmentLayer(const QPsdAbstractLayerItem *it
     } else if (key == "post") {
         effect.properties.insert("property int adjustmentType", 8);
         // "post" is a raw u16 (level count), not a descriptor map
-        const int postLevels = ali.value(key).toInt();
+        const int postLevels = ali.value(QPsdFourCC(key)).toInt();
         setFloat("posterizeLevels", postLevels > 1 ? postLevels : 4.0);
     } else if (key == "thrs") {
         effect.properties.insert("property int adjustmentType", 9);
         // "thrs" is a raw u16 (threshold level 1-255), not a descriptor map
-        const int thresholdLevel = ali.value(key).toInt();
+        const int thresholdLevel = ali.value(QPsdFourCC(key)).toInt();
         setFloat("thresholdLevel", (thresholdLevel > 0 ? thresholdLevel : 128) / 255.0);
     } else if (key == "mixr") {
         effect.properties.insert("property int adjustmentType", 11);
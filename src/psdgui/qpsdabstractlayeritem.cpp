@@ -341,7 +341,7 @@ QPsdAbstractLayerItem::QPsdAbstractLayerItem(const QPsdLayerRecord &record)
             }
         }
 
-        auto descriptorColor = [](const QHash<QByteArray, QVariant> &data) -> QColor {
+        auto descriptorColor = [](const QPsdDescriptorData &data) -> QColor {
             const auto clr_ = data.value("Clr ").value<QPsdDescriptor>().data();
             return QColor::fromRgbF(clr_.value("Rd  ").toDouble() / 255.0,
                                     clr_.value("Grn ").toDouble() / 255.0,
@@ -629,10 +629,15 @@ void QPsdAbstractLayerItem::setLinkedFile(const QPsdLinkedLayer::LinkedFile &lin
 void QPsdAbstractLayerItem::setIccProfile(const QByteArray &iccProfile)
 {
     if (d->image.format() == QImage::Format_CMYK8888 && !iccProfile.isEmpty()) {
-        QColorSpace cmykColorSpace = QColorSpace::fromIccProfile(iccProfile);
-        if (cmykColorSpace.isValid()) {
-            d->image.setColorSpace(cmykColorSpace);
-            d->image = d->image.convertedToColorSpace(QColorSpace(QColorSpace::SRgb));
+        // The transform is shared with the other layers and the composite
+        const QPsdColorTransform transform = QtPsdGui::cmykTransform(iccProfile);
+        if (transform.isValid()) {
+            // CMYK8888 and RGB32 pixels have the same size, convert in place
+            uchar *bits = d->image.bits();
+            transform.map(bits, d->image.bytesPerLine(), bits, d->image.bytesPerLine(),
+                          d->image.width(), d->image.height());
+            d->image.reinterpretAsFormat(QImage::Format_RGB32);
+            d->image.setColorSpace(QColorSpace::SRgb);
         }
     }
 }
@@ -136,9 +136,9 @@ bool applyAdjustmentToImage(QImage &image, const QPsdAdjustmentLayerItem *layer,
     const QByteArray key = layer->adjustmentKey();
     const auto ali = layer->record().additionalLayerInformation();
     // ALI data may be a QVariantMap (custom plugins) or QPsdDescriptor (v16descriptor plugin)
-    QVariantMap data = ali.value(key).toMap();
-    if (data.isEmpty() && ali.value(key).canConvert<QPsdDescriptor>()) {
-        const auto desc = ali.value(key).value<QPsdDescriptor>();
+    QVariantMap data = ali.value(QPsdFourCC(key)).toMap();
+    if (data.isEmpty() && ali.value(QPsdFourCC(key)).canConvert<QPsdDescriptor>()) {
+        const auto desc = ali.value(QPsdFourCC(key)).value<QPsdDescriptor>();
         const auto hash = desc.data();
         for (auto it = hash.cbegin(); it != hash.cend(); ++it)
             data.insert(QString::fromLatin1(it.key()), it.value());
@@ -314,7 +314,7 @@ bool applyAdjustmentToImage(QImage &image, const QPsdAdjustmentLayerItem *layer,
             return {1.0 - in.r, 1.0 - in.g, 1.0 - in.b};
         };
     } else if (key == "post") {
-        const int postLevels = ali.value(key).toInt();
+        const int postLevels = ali.value(QPsdFourCC(key)).toInt();
         const qreal levels = qMax(2.0, qreal(postLevels > 1 ? postLevels : 4));
         transform = [=](const Rgb &in) -> Rgb {
             auto apply = [&](qreal v) {
@@ -323,7 +323,7 @@ bool applyAdjustmentToImage(QImage &image, const QPsdAdjustmentLayerItem *layer,
             return {apply(in.r), apply(in.g), apply(in.b)};
         };
     } else if (key == "thrs") {
-        const int level = ali.value(key).toInt();
+        const int level = ali.value(QPsdFourCC(key)).toInt();
         const qreal threshold = (level > 0 ? level : 128) / 255.0;
         transform = [=](const Rgb &in) -> Rgb {
             const qreal v = lum(in) >= threshold - 0.5 / 255.0 ? 1.0 : 0.0;
@@ -600,9 +600,9 @@ QPsdAdjustmentShaderParams adjustmentShaderParams(const QPsdAdjustmentLayerItem
     const QByteArray key = layer->adjustmentKey();
     const auto ali = layer->record().additionalLayerInformation();
     // ALI data may be a QVariantMap (custom plugins) or QPsdDescriptor (v16descriptor plugin)
-    QVariantMap data = ali.value(key).toMap();
-    if (data.isEmpty() && ali.value(key).canConvert<QPsdDescriptor>()) {
-        const auto desc = ali.value(key).value<QPsdDescriptor>();
+    QVariantMap data = ali.value(QPsdFourCC(key)).toMap();
+    if (data.isEmpty() && ali.value(QPsdFourCC(key)).canConvert<QPsdDescriptor>()) {
+        const auto desc = ali.value(QPsdFourCC(key)).value<QPsdDescriptor>();
         const auto hash = desc.data();
         for (auto it = hash.cbegin(); it != hash.cend(); ++it)
             data.insert(QString::fromLatin1(it.key()), it.value());
@@ -702,11 +702,11 @@ QPsdAdjustmentShaderParams adjustmentShaderParams(const QPsdAdjustmentLayerItem
         params.type = 7;
     } else if (key == "post") {
         params.type = 8;
-        const int levels = ali.value(key).toInt();
+        const int levels = ali.value(QPsdFourCC(key)).toInt();
         set(u"post_levels"_s, levels > 1 ? levels : 4);
     } else if (key == "thrs") {
         params.type = 9;
-        const int level = ali.value(key).toInt();
+        const int level = ali.value(QPsdFourCC(key)).toInt();
         set(u"threshold"_s, (level > 0 ? level : 128) / 255.0);
     } else if (key == "vibA") {
         params.type = 10;
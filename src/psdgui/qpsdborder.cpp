@@ -8,7 +8,7 @@ QT_BEGIN_NAMESPACE
 class QPsdBorder::Private
 {
 public:
-    Private(const QHash<QByteArray, QVariant> &descriptor)
+    Private(const QPsdDescriptorData &descriptor)
     {
         // Enabled
         enabled = descriptor.value("enab").toBool();
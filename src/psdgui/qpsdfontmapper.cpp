@@ -9,9 +9,12 @@
 #include <QtCore/QReadWriteLock>
 #include <QtCore/QSettings>
 #include <QtGui/QFontDatabase>
+#include <QtGui/QGuiApplication>
 #include <QtGui/QFontInfo>
 #include <QtGui/QRawFont>
 
+#include <atomic>
+
 QT_BEGIN_NAMESPACE
 
 // Parse OpenType 'name' table to extract a specific name ID
@@ -119,10 +122,13 @@ public:
     // Cached list of available font families
     QStringList availableFamilies;
 
-    Private() {
-        availableFamilies = QFontDatabase::families();
-        buildPostScriptNameTable();
-    }
+    // availableFamilies and postScriptToFamily are filled on the first
+    // lookup. The font database needs a QGuiApplication, which may be
+    // created after the mapper; headless users such as QPsdRenderer only
+    // read the stored pixels of text layers and never get here.
+    QMutex fontDatabaseMutex;
+    std::atomic<bool> fontDatabaseLoaded = false;
+    void ensureFontDatabase();
 
     // Build the PostScript name to family name mapping table
     void buildPostScriptNameTable();
@@ -137,6 +143,18 @@ public:
     QFont autoResolveFont(const QString &fontName) const;
 };
 
+void QPsdFontMapper::Private::ensureFontDatabase()
+{
+    if (fontDatabaseLoaded.load(std::memory_order_acquire))
+        return;
+    QMutexLocker locker(&fontDatabaseMutex);
+    if (fontDatabaseLoaded.load(std::memory_order_relaxed))
+        return;
+    availableFamilies = QFontDatabase::families();
+    buildPostScriptNameTable();
+    fontDatabaseLoaded.store(true, std::memory_order_release);
+}
+
 void QPsdFontMapper::Private::buildPostScriptNameTable()
 {
     for (const QString &family : availableFamilies) {
@@ -573,6 +591,18 @@ QFont QPsdFontMapper::resolveFont(const QString &fontName, const QString &psdPat
         }
     }
 
+    // Without a font database the name is taken as it is
+    if (!qGuiApp) {
+        auto [family, style] = Private::parsePostScriptName(mappedName);
+        resultFont = QFont(family);
+        applyStyleToFont(resultFont, style);
+        QWriteLocker locker(&d->lock);
+        d->fontCache.insert(cacheKey, resultFont);
+        return resultFont;
+    }
+
+    d->ensureFontDatabase();
+
     // 3. Try the mapped name first (if mapping was found)
     if (mappedName != fontName) {
         resultFont = QFont(mappedName);
@@ -13,6 +13,8 @@
 #include <QtPsdCore/QPsdAbstractImage>
 #include <QtPsdCore/QPsdFileHeader>
 #include <QtPsdCore/QPsdColorModeData>
+#include <QtPsdCore/QPsdColorTransform>
+#include <QtPsdCore/QPsdThumbnail>
 #include <QtPsdCore/qpsdblend.h>
 
 using namespace Qt::Literals::StringLiterals;
@@ -21,6 +23,10 @@ QT_BEGIN_NAMESPACE
 
 namespace QtPsdGui {
 Q_PSDGUI_EXPORT QImage imageDataToImage(const QPsdAbstractImage &imageData, const QPsdFileHeader &fileHeader, const QPsdColorModeData &colorModeData = QPsdColorModeData(), const QByteArray &iccProfile = QByteArray());
+Q_PSDGUI_EXPORT QImage thumbnailToImage(const QPsdThumbnail &thumbnail);
+// Returns the CMYK to sRGB transform of a CMYK ICC profile, or an invalid
+// one. Transforms are built once per profile and shared by every image.
+Q_PSDGUI_EXPORT QPsdColorTransform cmykTransform(const QByteArray &iccProfile);
 Q_PSDGUI_EXPORT QPainter::CompositionMode compositionMode(QPsdBlend::Mode psdBlendMode);
 Q_PSDGUI_EXPORT bool isCustomBlendMode(QPsdBlend::Mode mode);
 Q_PSDGUI_EXPORT void customBlend(QImage &dest, const QImage &src,
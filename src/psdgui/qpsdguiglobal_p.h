@@ -0,0 +1,24 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPSDGUIGLOBAL_P_H
+#define QPSDGUIGLOBAL_P_H
+
+#include <QtPsdGui/qpsdguiglobal.h>
+
+QT_BEGIN_NAMESPACE
+
+namespace QtPsdGui {
+// The per-pixel qreal implementation of customBlend(), which the blend
+// kernels are checked against
+Q_PSDGUI_EXPORT void customBlendReference(QImage &dest, const QImage &src,
+                                          QPsdBlend::Mode mode, qreal opacity);
+// customBlend() into dest lying at origin of a larger image, such as a tile
+// of a document, so that the Dissolve noise lines up across the pieces
+Q_PSDGUI_EXPORT void customBlend(QImage &dest, const QImage &src,
+                                 QPsdBlend::Mode mode, qreal opacity, const QPoint &origin);
+}
+
+QT_END_NAMESPACE
+
+#endif // QPSDGUIGLOBAL_P_H
@@ -63,7 +63,7 @@ QPsdAbstractLayerItem *QPsdGuiLayerTreeItemModel::Private::layerItemObject(const
             break;
         default: {
             // Known adjustment layer ALI keys
-            static const QList<QByteArray> adjustmentKeys = {
+            static constexpr QPsdFourCC adjustmentKeys[] = {
                 "brit", "levl", "curv", "expA", "vibA", "hue2", "blnc",
                 "blwh", "phfl", "mixr", "clrL", "nvrt", "post", "thrs",
                 "grdm", "selc"
@@ -76,9 +76,9 @@ QPsdAbstractLayerItem *QPsdGuiLayerTreeItemModel::Private::layerItemObject(const
             } else {
                 // Check for adjustment layer keys
                 QByteArray foundKey;
-                for (const auto &key : adjustmentKeys) {
+                for (const auto key : adjustmentKeys) {
                     if (additionalLayerInformation.contains(key)) {
-                        foundKey = key;
+                        foundKey = key.toByteArray();
                         break;
                     }
                 }
@@ -187,7 +187,8 @@ void QPsdGuiLayerTreeItemModel::fromParser(const QPsdParser &parser)
     }
 
     // Store pattern images for pattern fill rendering
-    for (const auto &key : {"Patt", "Pat2", "Pat3"}) {
+    static constexpr QPsdFourCC patternKeys[] = { "Patt", "Pat2", "Pat3" };
+    for (const auto key : patternKeys) {
         if (additionalLayerInformation.contains(key)) {
             const auto patternMap = additionalLayerInformation.value(key).value<QVariantHash>();
             for (auto it = patternMap.begin(); it != patternMap.end(); ++it) {
@@ -8,7 +8,7 @@ QT_BEGIN_NAMESPACE
 class QPsdPatternFill::Private
 {
 public:
-    Private(const QHash<QByteArray, QVariant> &descriptor) {
+    Private(const QPsdDescriptorData &descriptor) {
         // Mode
         if (descriptor.contains("Md  ")) {
             const auto md__ = descriptor.value("Md  ").value<QPsdEnum>();
@@ -0,0 +1,570 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qpsdrenderer.h"
+#include "qpsdabstractlayeritem.h"
+#include "qpsdadjustmentlayeritem.h"
+#include "qpsdadjustments.h"
+#include "qpsdguiglobal_p.h"
+#include "qpsdguilayertreeitemmodel.h"
+
+#include <QtPsdCore/private/qpsdparallel_p.h>
+
+#include <QtGui/QPainter>
+#include <QtGui/QPainterPath>
+
+#include <memory>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+namespace {
+
+// A vector mask rasterized over the part of the document it spans, so that
+// the tiles only read pixels and never touch the shared QPainterPath
+struct ClipMask
+{
+    QRect rect;
+    // Alpha8
+    QImage shape;
+};
+
+// One visible layer of the document, with everything the tiles read from
+// it copied out of the layer item up front
+struct Node
+{
+    enum Kind {
+        Pixels,
+        Adjustment,
+        Group,
+    };
+
+    Kind kind = Pixels;
+    const QPsdAbstractLayerItem *layer = nullptr;
+    // The layer pixels and the part of the document the node can change,
+    // both in document coordinates
+    QRect rect;
+    QRect bounds;
+    QImage image;
+    QImage transparencyMask;
+    // Grayscale8, null when the layer has no raster mask
+    QImage layerMask;
+    QRect layerMaskRect;
+    int layerMaskDefaultColor = 255;
+    int layerMaskDensity = 255;
+    // Vector masks of the layer and of the groups above it
+    QList<ClipMask> clipMasks;
+    const Node *clipBase = nullptr;
+    // Bottom to top, the nodes clipped to this one. They are composited
+    // with it as a group and are not among its siblings.
+    QList<const Node *> clipped;
+    // Adjustments only: raster mask and clipping in document coordinates
+    QImage weightMask;
+    QPsdBlend::Mode blendMode = QPsdBlend::Normal;
+    qreal opacity = 1.0;
+    // Fades the pixels of the layer but not the layers clipped to it
+    qreal fillOpacity = 1.0;
+    bool isolated = false;
+    // Bottom to top
+    QList<const Node *> children;
+};
+
+class Compositor
+{
+public:
+    Compositor(const QPsdGuiLayerTreeItemModel *model, const QRect &canvas)
+        : model(model), canvas(canvas)
+    {}
+
+    void build(const QModelIndex &parent, QList<const Node *> *siblings,
+               const QList<ClipMask> &clipMasks);
+    void renderNodes(const QList<const Node *> &nodes, QImage &target, const QRect &targetRect) const;
+
+    QList<const Node *> roots;
+
+private:
+    QImage content(const Node &node, const QRect &area, const ClipMask *baseMask = nullptr) const;
+    QImage coverage(const Node &node, const QRect &area, const ClipMask *baseMask) const;
+    void composeClipped(const Node &base, QImage &pixels, const QRect &area) const;
+    void adjust(const Node &node, QImage &target, const QRect &targetRect, const QRect &area) const;
+
+    const QPsdGuiLayerTreeItemModel *model;
+    const QRect canvas;
+    std::vector<std::unique_ptr<Node>> storage;
+    QHash<const QPsdAbstractLayerItem *, Node *> nodeOfLayer;
+};
+
+inline uchar multiplyByte(uint a, uint b)
+{
+    const uint t = a * b + 0x80;
+    return uchar((t + (t >> 8)) >> 8);
+}
+
+// Scales all four channels of a premultiplied pixel by a / 255
+inline QRgb multiplyPixel(QRgb pixel, uint a)
+{
+    uint t = (pixel & 0xff00ff) * a;
+    t = ((t + ((t >> 8) & 0xff00ff) + 0x800080) >> 8) & 0xff00ff;
+    uint x = ((pixel >> 8) & 0xff00ff) * a;
+    x = (x + ((x >> 8) & 0xff00ff) + 0x800080) & 0xff00ff00;
+    return x | t;
+}
+
+// Returns an image sharing the 32-bit pixels of rect in image
+QImage subImage(QImage &image, const QRect &rect)
+{
+    return QImage(image.bits() + rect.y() * image.bytesPerLine() + rect.x() * 4,
+                  rect.width(), rect.height(), image.bytesPerLine(), image.format());
+}
+
+void applyCoverage(QImage &pixels, const QImage &coverage)
+{
+    if (coverage.isNull())
+        return;
+    for (int y = 0; y < pixels.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(pixels.scanLine(y));
+        const uchar *mask = coverage.constScanLine(y);
+        for (int x = 0; x < pixels.width(); ++x)
+            line[x] = multiplyPixel(line[x], mask[x]);
+    }
+}
+
+// Blends source into rect of target, which lies at origin of the document
+void blend(QImage &target, const QRect &rect, const QImage &source,
+           QPsdBlend::Mode mode, qreal opacity, const QPoint &origin)
+{
+    if (QtPsdGui::isCustomBlendMode(mode)) {
+        QImage dest = subImage(target, rect);
+        QtPsdGui::customBlend(dest, source, mode, opacity, origin);
+    } else {
+        QPainter painter(&target);
+        painter.setCompositionMode(QtPsdGui::compositionMode(mode));
+        painter.setOpacity(opacity);
+        painter.drawImage(rect.topLeft(), source);
+    }
+}
+
+QPainterPath toPath(const QPsdAbstractLayerItem::PathInfo &info)
+{
+    QPainterPath path;
+    switch (info.type) {
+    case QPsdAbstractLayerItem::PathInfo::None:
+        break;
+    case QPsdAbstractLayerItem::PathInfo::Rectangle:
+        path.addRect(info.rect);
+        break;
+    case QPsdAbstractLayerItem::PathInfo::RoundedRectangle:
+        path.addRoundedRect(info.rect, info.radius, info.radius);
+        break;
+    default:
+        path = info.path;
+        break;
+    }
+    return path;
+}
+
+ClipMask toClipMask(const QPainterPath &path, const QRect &canvas)
+{
+    ClipMask ret;
+    ret.rect = path.boundingRect().toAlignedRect() & canvas;
+    if (ret.rect.isEmpty())
+        return ret;
+    ret.shape = QImage(ret.rect.size(), QImage::Format_Alpha8);
+    ret.shape.fill(0);
+    QPainter painter(&ret.shape);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.translate(-ret.rect.topLeft());
+    painter.fillPath(path, Qt::black);
+    return ret;
+}
+
+void Compositor::build(const QModelIndex &parent, QList<const Node *> *siblings,
+                       const QList<ClipMask> &clipMasks)
+{
+    // The last row is the bottom of the stack
+    for (int row = model->rowCount(parent) - 1; row >= 0; --row) {
+        const QModelIndex index = model->index(row, 0, parent);
+        const QPsdAbstractLayerItem *layer = model->layerItem(index);
+        if (!layer || !layer->isVisible())
+            continue;
+
+        auto node = std::make_unique<Node>();
+        node->layer = layer;
+        node->rect = layer->rect();
+        node->blendMode = layer->record().blendMode();
+        node->opacity = layer->opacity();
+        node->clipMasks = clipMasks;
+        const QPainterPath vectorMask = toPath(layer->vectorMask());
+        if (!vectorMask.isEmpty())
+            node->clipMasks.append(toClipMask(vectorMask.translated(node->rect.topLeft()), canvas));
+
+        // Layers clipped to a hidden base are hidden with it
+        const QModelIndex clipIndex = model->clippingMaskIndex(index);
+        const QPsdAbstractLayerItem *clipLayer = clipIndex.isValid() ? model->layerItem(clipIndex) : nullptr;
+        Node *clipBase = nullptr;
+        if (clipLayer) {
+            clipBase = nodeOfLayer.value(clipLayer);
+            if (!clipBase)
+                continue;
+            node->clipBase = clipBase;
+        }
+
+        QRect bounds;
+        switch (layer->type()) {
+        case QPsdAbstractLayerItem::Folder:
+            node->kind = Node::Group;
+            build(index, &node->children, node->clipMasks);
+            for (const Node *child : std::as_const(node->children))
+                bounds |= child->bounds;
+            // Like QPsdScene, a group with a blend mode of its own or with
+            // an opacity is composited against transparency first and the
+            // result is blended onto the backdrop. Masking or clipping the
+            // group needs that result too.
+            node->isolated = (node->blendMode != QPsdBlend::PassThrough
+                              && node->blendMode != QPsdBlend::Invalid
+                              && node->blendMode != QPsdBlend::Normal)
+                || node->opacity < 1.0 || !layer->layerMask().isNull() || node->clipBase;
+            if (node->blendMode == QPsdBlend::PassThrough || node->blendMode == QPsdBlend::Invalid)
+                node->blendMode = QPsdBlend::Normal;
+            break;
+        case QPsdAbstractLayerItem::Adjustment:
+            node->kind = Node::Adjustment;
+            // The raster mask and the clipping base are part of the weight
+            node->weightMask = QtPsdGui::adjustmentWeightMask(
+                static_cast<const QPsdAdjustmentLayerItem *>(layer), clipLayer, canvas.size());
+            bounds = canvas;
+            break;
+        default:
+            node->image = layer->image();
+            node->transparencyMask = layer->transparencyMask();
+            // Fill opacity spares layer effects, which are not rendered, and
+            // the layers clipped to this one
+            node->fillOpacity = layer->fillOpacity();
+            bounds = node->rect;
+            break;
+        }
+
+        if (node->kind != Node::Adjustment) {
+            const QImage layerMask = layer->layerMask();
+            if (!layerMask.isNull()) {
+                node->layerMask = layerMask.convertToFormat(QImage::Format_Grayscale8);
+                node->layerMaskRect = layer->layerMaskRect();
+                node->layerMaskDefaultColor = layer->layerMaskDefaultColor();
+                node->layerMaskDensity = layer->layerMaskDensity();
+                if (node->layerMaskDefaultColor == 0 && node->layerMaskDensity == 255)
+                    bounds &= node->layerMaskRect;
+            }
+        }
+        for (const ClipMask &clipMask : std::as_const(node->clipMasks))
+            bounds &= clipMask.rect;
+        if (node->clipBase)
+            bounds &= node->clipBase->bounds;
+        node->bounds = bounds;
+
+        nodeOfLayer.insert(layer, node.get());
+        if (!bounds.isEmpty()) {
+            if (clipBase) {
+                clipBase->clipped.append(node.get());
+                // The base of a clipping group is composited on its own
+                if (clipBase->kind == Node::Group)
+                    clipBase->isolated = true;
+            } else {
+                siblings->append(node.get());
+            }
+        }
+        storage.push_back(std::move(node));
+    }
+}
+
+void Compositor::renderNodes(const QList<const Node *> &nodes, QImage &target,
+                             const QRect &targetRect) const
+{
+    for (const Node *node : nodes) {
+        const QRect area = node->bounds & targetRect;
+        if (area.isEmpty())
+            continue;
+
+        switch (node->kind) {
+        case Node::Adjustment:
+            adjust(*node, target, targetRect, area);
+            break;
+        case Node::Group:
+            if (!node->isolated) {
+                renderNodes(node->children, target, targetRect);
+                break;
+            }
+            Q_FALLTHROUGH();
+        case Node::Pixels: {
+            QImage pixels = content(*node, area);
+            qreal opacity = node->opacity * node->fillOpacity;
+            if (!node->clipped.isEmpty()) {
+                composeClipped(*node, pixels, area);
+                opacity = node->opacity;
+            }
+            blend(target, area.translated(-targetRect.topLeft()), pixels,
+                  node->blendMode, opacity, area.topLeft());
+            break;
+        }
+        }
+    }
+}
+
+// Composites the layers clipped to base onto its pixels over area, the way
+// Photoshop blends clipped layers as a group. They show wherever base has
+// pixels, however much its fill opacity fades them, and are faded along
+// with base by its opacity when the group is blended onto the backdrop.
+void Compositor::composeClipped(const Node &base, QImage &pixels, const QRect &area) const
+{
+    // Taken once per tile and shared by all the clipped layers
+    ClipMask baseMask;
+    baseMask.rect = area;
+    baseMask.shape = QImage(area.size(), QImage::Format_Alpha8);
+    const uint fill = uint(qBound(0, qRound(base.fillOpacity * 255), 255));
+    for (int y = 0; y < area.height(); ++y) {
+        QRgb *line = reinterpret_cast<QRgb *>(pixels.scanLine(y));
+        uchar *mask = baseMask.shape.scanLine(y);
+        for (int x = 0; x < area.width(); ++x) {
+            mask[x] = qAlpha(line[x]);
+            if (fill < 255)
+                line[x] = multiplyPixel(line[x], fill);
+        }
+    }
+
+    for (const Node *clipped : base.clipped) {
+        const QRect clippedArea = clipped->bounds & area;
+        if (clippedArea.isEmpty())
+            continue;
+        if (clipped->kind == Node::Adjustment) {
+            adjust(*clipped, pixels, area, clippedArea);
+            continue;
+        }
+        blend(pixels, clippedArea.translated(-area.topLeft()), content(*clipped, clippedArea, &baseMask),
+              clipped->blendMode, clipped->opacity * clipped->fillOpacity, clippedArea.topLeft());
+    }
+}
+
+// Returns the premultiplied pixels of node over area, masked but not faded
+// by the node opacity. baseMask is the alpha of the clipping base of node.
+QImage Compositor::content(const Node &node, const QRect &area, const ClipMask *baseMask) const
+{
+    QImage pixels;
+    switch (node.kind) {
+    case Node::Group:
+        pixels = QImage(area.size(), QImage::Format_ARGB32_Premultiplied);
+        pixels.fill(Qt::transparent);
+        renderNodes(node.children, pixels, area);
+        break;
+    case Node::Pixels:
+        pixels = node.image.copy(area.translated(-node.rect.topLeft()));
+        // Layers decoded without alpha, such as CMYK ones, carry their
+        // transparency separately
+        if (!pixels.isNull() && !node.transparencyMask.isNull() && !pixels.hasAlphaChannel()) {
+            const QImage alpha = node.transparencyMask.copy(area.translated(-node.rect.topLeft()))
+                                     .convertToFormat(QImage::Format_Grayscale8);
+            pixels = std::move(pixels).convertToFormat(QImage::Format_ARGB32);
+            for (int y = 0; y < pixels.height(); ++y) {
+                QRgb *line = reinterpret_cast<QRgb *>(pixels.scanLine(y));
+                const uchar *a = alpha.constScanLine(y);
+                for (int x = 0; x < pixels.width(); ++x)
+                    line[x] = (line[x] & RGB_MASK) | (uint(a[x]) << 24);
+            }
+        }
+        pixels = std::move(pixels).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        break;
+    case Node::Adjustment:
+        break;
+    }
+    if (pixels.size() != area.size()) {
+        pixels = QImage(area.size(), QImage::Format_ARGB32_Premultiplied);
+        pixels.fill(Qt::transparent);
+        return pixels;
+    }
+    applyCoverage(pixels, coverage(node, area, baseMask));
+    return pixels;
+}
+
+// Returns how much of node shows through its layer mask, its vector masks
+// and its clipping base over area as Grayscale8, or a null image when none
+// of them hides anything
+QImage Compositor::coverage(const Node &node, const QRect &area, const ClipMask *baseMask) const
+{
+    QImage ret;
+    const auto start = [&] {
+        if (ret.isNull()) {
+            ret = QImage(area.size(), QImage::Format_Grayscale8);
+            ret.fill(255);
+        }
+    };
+
+    if (!node.layerMask.isNull()) {
+        start();
+        // Density scales the effect of the mask, 0 leaves it out entirely
+        uchar values[256];
+        for (int i = 0; i < 256; ++i)
+            values[i] = uchar(255 - node.layerMaskDensity * (255 - i) / 255);
+        const uchar outside = values[node.layerMaskDefaultColor];
+        const QRect maskArea = area.translated(-node.layerMaskRect.topLeft());
+        const int maskWidth = node.layerMask.width();
+        const int maskHeight = node.layerMask.height();
+        for (int y = 0; y < area.height(); ++y) {
+            uchar *line = ret.scanLine(y);
+            const int maskY = maskArea.y() + y;
+            if (maskY < 0 || maskY >= maskHeight) {
+                for (int x = 0; x < area.width(); ++x)
+                    line[x] = multiplyByte(line[x], outside);
+                continue;
+            }
+            const uchar *mask = node.layerMask.constScanLine(maskY);
+            for (int x = 0; x < area.width(); ++x) {
+                const int maskX = maskArea.x() + x;
+                const uchar value = maskX >= 0 && maskX < maskWidth ? values[mask[maskX]] : outside;
+                line[x] = multiplyByte(line[x], value);
+            }
+        }
+    }
+
+    // The vector masks of a group are already applied to its children. The
+    // bounds of a node lie within each of its masks, and so does area.
+    for (const ClipMask &clipMask : node.clipMasks) {
+        if (node.kind == Node::Group)
+            break;
+        Q_ASSERT(clipMask.rect.contains(area));
+        start();
+        const QPoint offset = area.topLeft() - clipMask.rect.topLeft();
+        for (int y = 0; y < area.height(); ++y) {
+            uchar *line = ret.scanLine(y);
+            const uchar *mask = clipMask.shape.constScanLine(offset.y() + y) + offset.x();
+            for (int x = 0; x < area.width(); ++x)
+                line[x] = multiplyByte(line[x], mask[x]);
+        }
+    }
+
+    // Adjustments have their clipping base in their weight mask
+    if (baseMask && node.kind != Node::Adjustment) {
+        Q_ASSERT(baseMask->rect.contains(area));
+        start();
+        const QPoint offset = area.topLeft() - baseMask->rect.topLeft();
+        for (int y = 0; y < area.height(); ++y) {
+            uchar *line = ret.scanLine(y);
+            const uchar *mask = baseMask->shape.constScanLine(offset.y() + y) + offset.x();
+            for (int x = 0; x < area.width(); ++x)
+                line[x] = multiplyByte(line[x], mask[x]);
+        }
+    }
+
+    return ret;
+}
+
+void Compositor::adjust(const Node &node, QImage &target, const QRect &targetRect,
+                        const QRect &area) const
+{
+    QImage weight;
+    if (!node.weightMask.isNull())
+        weight = node.weightMask.copy(area);
+    const QImage shape = coverage(node, area, nullptr);
+    if (weight.isNull()) {
+        weight = shape;
+    } else if (!shape.isNull()) {
+        for (int y = 0; y < area.height(); ++y) {
+            uchar *line = weight.scanLine(y);
+            const uchar *mask = shape.constScanLine(y);
+            for (int x = 0; x < area.width(); ++x)
+                line[x] = multiplyByte(line[x], mask[x]);
+        }
+    }
+
+    QImage dest = subImage(target, area.translated(-targetRect.topLeft()));
+    QImage region = dest.convertToFormat(QImage::Format_ARGB32);
+    if (!QtPsdGui::applyAdjustmentToImage(region, static_cast<const QPsdAdjustmentLayerItem *>(node.layer), weight))
+        return;
+    region.convertTo(QImage::Format_ARGB32_Premultiplied);
+    for (int y = 0; y < area.height(); ++y)
+        memcpy(dest.scanLine(y), region.constScanLine(y), area.width() * sizeof(QRgb));
+}
+
+} // namespace
+
+class QPsdRenderer::Private
+{
+public:
+    const QPsdGuiLayerTreeItemModel *model = nullptr;
+    QSize tileSize = QSize(256, 256);
+};
+
+QPsdRenderer::QPsdRenderer(const QPsdGuiLayerTreeItemModel *model)
+    : d(new Private)
+{
+    d->model = model;
+}
+
+QPsdRenderer::~QPsdRenderer() = default;
+
+const QPsdGuiLayerTreeItemModel *QPsdRenderer::model() const
+{
+    return d->model;
+}
+
+void QPsdRenderer::setModel(const QPsdGuiLayerTreeItemModel *model)
+{
+    d->model = model;
+}
+
+QSize QPsdRenderer::tileSize() const
+{
+    return d->tileSize;
+}
+
+void QPsdRenderer::setTileSize(const QSize &tileSize)
+{
+    d->tileSize = tileSize;
+}
+
+QImage QPsdRenderer::render(const QRect &rect) const
+{
+    if (!d->model)
+        return QImage();
+
+    const QRect canvas(QPoint(0, 0), d->model->size());
+    const QRect area = rect.isNull() ? canvas : rect;
+    if (area.isEmpty())
+        return QImage();
+
+    // Like QPsdScene, documents without layers and CMYK documents, whose
+    // layers would have to be blended in CMYK, show the composite image
+    if (d->model->colorMode() == QPsdFileHeader::CMYK || d->model->rowCount() == 0)
+        return d->model->mergedImage().copy(area).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    Compositor compositor(d->model, canvas);
+    compositor.build(QModelIndex(), &compositor.roots, {});
+    const QImage alphaMask = d->model->documentAlphaMask();
+
+    QImage image(area.size(), QImage::Format_ARGB32_Premultiplied);
+    if (image.isNull())
+        return image;
+    uchar *bits = image.bits();
+    const qsizetype bytesPerLine = image.bytesPerLine();
+
+    const QSize tileSize = d->tileSize.isEmpty() ? area.size() : d->tileSize;
+    const int columns = (area.width() + tileSize.width() - 1) / tileSize.width();
+    const int rows = (area.height() + tileSize.height() - 1) / tileSize.height();
+    psdParallelFor(qsizetype(columns) * rows, [&](qsizetype i) {
+        const QRect tileRect = QRect(area.x() + int(i % columns) * tileSize.width(),
+                                     area.y() + int(i / columns) * tileSize.height(),
+                                     tileSize.width(), tileSize.height()) & area;
+        const QPoint offset = tileRect.topLeft() - area.topLeft();
+        // Each tile draws straight into its own part of the image
+        QImage tile(bits + offset.y() * bytesPerLine + offset.x() * 4,
+                    tileRect.width(), tileRect.height(), bytesPerLine,
+                    QImage::Format_ARGB32_Premultiplied);
+        tile.fill(Qt::transparent);
+        compositor.renderNodes(compositor.roots, tile, tileRect);
+
+        // Extra channels of the document, as QPsdScene::drawForeground()
+        if (!alphaMask.isNull())
+            applyCoverage(tile, alphaMask.copy(tileRect));
+    });
+
+    return image;
+}
+
+QT_END_NAMESPACE
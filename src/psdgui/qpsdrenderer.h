@@ -0,0 +1,47 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPSDRENDERER_H
+#define QPSDRENDERER_H
+
+#include <QtPsdGui/qpsdguiglobal.h>
+
+#include <QtCore/QRect>
+#include <QtCore/QSize>
+#include <QtGui/QImage>
+
+QT_BEGIN_NAMESPACE
+
+class QPsdGuiLayerTreeItemModel;
+
+// Composites the layers of a document into a QImage without a scene or a
+// QApplication. The canvas is split into tiles that are rendered on the
+// global thread pool, and each tile only visits the layers that touch it.
+class Q_PSDGUI_EXPORT QPsdRenderer
+{
+public:
+    explicit QPsdRenderer(const QPsdGuiLayerTreeItemModel *model = nullptr);
+    ~QPsdRenderer();
+
+    const QPsdGuiLayerTreeItemModel *model() const;
+    void setModel(const QPsdGuiLayerTreeItemModel *model);
+
+    QSize tileSize() const;
+    void setTileSize(const QSize &tileSize);
+
+    // Returns the ARGB32_Premultiplied pixels of rect in document
+    // coordinates, or of the whole canvas when rect is null. Layer pixels,
+    // transparency and layer masks, vector masks, clipping groups, fill
+    // opacity, blend modes and adjustment layers are composited; layer
+    // effects and blur are not.
+    QImage render(const QRect &rect = QRect()) const;
+
+private:
+    Q_DISABLE_COPY(QPsdRenderer)
+    class Private;
+    QScopedPointer<Private> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPSDRENDERER_H
@@ -73,7 +73,14 @@ QPsdTextLayerItem::QPsdTextLayerItem(const QPsdLayerRecord &record)
         return;
     }
     QPsdEngineDataParser::ParseError parseError;
-    const auto engineData = QPsdEngineDataParser::parseEngineData(engineDataData, &parseError);
+    // Only the parts read below are built; the rest of EngineData (undo
+    // history, kinsoku tables, ...) is skipped
+    static const QByteArrayList subtrees = {
+        "EngineDict"_ba,
+        "DocumentResources/FontSet"_ba,
+        "DocumentResources/StyleSheetSet"_ba,
+    };
+    const auto engineData = QPsdEngineDataParser::parseEngineData(engineDataData, subtrees, &parseError);
     if (parseError) {
         qWarning() << "QPsdTextLayerItem: failed to parse EngineData:" << parseError.errorMessage;
         appendFallbackRun();
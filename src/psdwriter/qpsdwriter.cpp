@@ -7,7 +7,12 @@
 #include <QtPsdCore/qpsdblend.h>
 
 #include <QtCore/QBuffer>
-#include <QtCore/QFile>
+#include <QtCore/QSaveFile>
+
+#if defined(Q_OS_LINUX)
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 QT_BEGIN_NAMESPACE
 
@@ -202,6 +207,68 @@ static void writeBlendingRangesData(QIODevice *dest, const QPsdLayerBlendingRang
     dest->write(buf.data());
 }
 
+// Writes a payload such as the raw bytes kept for round-trip. Slices of a
+// mapped document are copied file to file by the kernel where possible and
+// otherwise written straight from the mapping in large blocks, so that the
+// pixel data is never copied into a buffer of its own.
+static bool writeSlice(QIODevice *device, const QPsdByteSlice &slice, QString *errorString)
+{
+    qint64 done = 0;
+#if defined(Q_OS_LINUX)
+    auto file = qobject_cast<QFileDevice *>(device);
+    if (file && slice.fileHandle() >= 0 && file->handle() >= 0) {
+        // Opening the source itself for writing has truncated it under the
+        // mapping, and reading the slice would fault
+        struct stat source, target;
+        if (::fstat(slice.fileHandle(), &source) == 0 && ::fstat(file->handle(), &target) == 0
+            && source.st_dev == target.st_dev && source.st_ino == target.st_ino) {
+            *errorString = u"Cannot write over the memory-mapped source document"_s;
+            return false;
+        }
+    }
+    if (file && slice.fileHandle() >= 0 && file->handle() >= 0 && file->flush()) {
+        const qint64 start = file->pos();
+        off64_t sourceOffset = slice.offset();
+        off64_t targetOffset = start;
+        while (done < slice.size()) {
+            const ssize_t copied = ::copy_file_range(slice.fileHandle(), &sourceOffset,
+                                                     file->handle(), &targetOffset,
+                                                     size_t(slice.size() - done), 0);
+            // Not supported between these files (e.g. across file systems on
+            // older kernels); the rest goes through write() below
+            if (copied <= 0)
+                break;
+            done += copied;
+        }
+        if (done > 0 && !file->seek(start + done)) {
+            *errorString = file->errorString();
+            return false;
+        }
+    }
+#endif
+    constexpr qint64 BlockSize = 4 * 1024 * 1024;
+    const char *data = reinterpret_cast<const char *>(slice.constData());
+    while (done < slice.size()) {
+        const qint64 written = device->write(data + done, qMin(BlockSize, slice.size() - done));
+        if (written <= 0) {
+            *errorString = device->errorString();
+            return false;
+        }
+        done += written;
+    }
+    return true;
+}
+
+// The raw bytes that parsers such as patt keep under __rawData__ for
+// round-trip. They are written with writeSlice() instead of being copied into
+// the payload that serialize() returns.
+static QPsdByteSlice rawDataSlice(const QVariant &value)
+{
+    if (value.typeId() != QMetaType::QVariantHash)
+        return {};
+    return value.toHash().value(u"__rawData__"_s).value<QPsdByteSlice>();
+}
+
 bool QPsdWriter::write(QIODevice *device) const
 {
     d->errorString.clear();
@@ -211,6 +278,13 @@ bool QPsdWriter::write(QIODevice *device) const
         return false;
     }
 
+    // Raw round-trip data of PSB documents uses 8-byte lengths and 4-byte
+    // RLE counts, which cannot be written into a version 1 file
+    if (d->fileHeader.isLargeDocument()) {
+        d->errorString = u"Writing Large Document Format (PSB) files is not supported"_s;
+        return false;
+    }
+
     // === Section 1: File Header (26 bytes fixed) ===
     // Signature
     device->write("8BPS", 4);
@@ -261,6 +335,9 @@ bool QPsdWriter::write(QIODevice *device) const
 
     // === Section 4: Layer and Mask Information ===
     {
+        // Everything but the channel image data is assembled in memory to
+        // compute the section lengths. The channel image data, by far the
+        // largest part, goes to the device directly at the end.
         QBuffer lmiBuf;
         lmiBuf.open(QIODevice::WriteOnly);
 
@@ -269,10 +346,12 @@ bool QPsdWriter::write(QIODevice *device) const
         const auto &channelImageDataList = layerInfo.channelImageData();
 
         // --- Layer Info sub-section ---
+        QBuffer liBuf;
+        liBuf.open(QIODevice::WriteOnly);
+        // For each record, for each channel: encoded bytes (including compression u16)
+        QList<QList<QPsdByteSlice>> allEncodedChannels;
+        qint64 channelDataSize = 0;
         {
-            QBuffer liBuf;
-            liBuf.open(QIODevice::WriteOnly);
-
             if (!records.isEmpty()) {
             // Layer count (signed, negative means first alpha is merged result)
             qint16 layerCount = static_cast<qint16>(records.size());
@@ -281,20 +360,21 @@ bool QPsdWriter::write(QIODevice *device) const
             QPsdSection::writeS16(&liBuf, layerCount);
 
             // --- Pre-compute channel encoded data ---
-            // For each record, for each channel: encoded bytes (including compression u16)
-            QList<QList<QByteArray>> allEncodedChannels;
             for (int ri = 0; ri < records.size(); ++ri) {
                 const auto &record = records.at(ri);
-                QList<QByteArray> encodedChannels;
+                QList<QPsdByteSlice> encodedChannels;
                 for (const auto &ci : record.channelInfo()) {
                     QByteArray encoded;
                     if (ri < channelImageDataList.size()) {
                         const auto &cid = channelImageDataList.at(ri);
 #ifdef QT_PSD_RAW_ROUND_TRIP
-                        // Use raw compressed bytes for lossless round-trip if available
-                        const QByteArray rawBytes = d->useRawBytes ? cid.rawChannelBytes(ci.id()) : QByteArray();
+                        // Use raw compressed bytes for lossless round-trip if
+                        // available, without copying them out of the source
+                        const QPsdByteSlice rawBytes = d->useRawBytes ? cid.rawChannelSlice(ci.id()) : QPsdByteSlice();
                         if (!rawBytes.isEmpty()) {
-                            encoded = rawBytes;
+                            encodedChannels.append(rawBytes);
+                            channelDataSize += rawBytes.size();
+                            continue;
                         } else
 #endif
                         {
@@ -351,7 +431,8 @@ bool QPsdWriter::write(QIODevice *device) const
                         comprBuf.close();
                         encoded = comprBuf.data();
                     }
-                    encodedChannels.append(encoded);
+                    encodedChannels.append(QPsdByteSlice(encoded));
+                    channelDataSize += encoded.size();
                 }
                 allEncodedChannels.append(encodedChannels);
             }
@@ -405,38 +486,39 @@ bool QPsdWriter::write(QIODevice *device) const
                 // Layer name (Pascal string, padded to multiple of 4)
                 QPsdSection::writePascalString(&extraBuf, record.name(), 4);
 
-                // Additional layer information (preserve original order)
-                const auto &ali = record.additionalLayerInformation();
-                const auto &keyOrder = record.aliKeyOrder();
-                // Use original key order if available, otherwise fall back to hash iteration
-                const auto keys = keyOrder.isEmpty() ? ali.keys() : keyOrder;
-                for (const auto &key : keys) {
-                    if (!ali.contains(key))
-                        continue;
-                    const QVariant &value = ali.value(key);
+                // Additional layer information, in the original order
+                const auto ali = record.additionalLayerInformation();
+                for (auto it = ali.cbegin(); it != ali.cend(); ++it) {
+                    const QByteArray key = it.key().toByteArray();
+                    const QVariant &value = it.value();
+                    const QPsdByteSlice rawData = rawDataSlice(value);
                     QByteArray payload;
                     if (value.typeId() == QMetaType::QByteArray) {
                         payload = value.toByteArray();
-                    } else {
+                    } else if (rawData.isEmpty()) {
                         auto plugin = QPsdAdditionalLayerInformationPlugin::plugin(key);
                         if (plugin)
                             payload = plugin->serialize(value);
                     }
+                    const qint64 payloadSize = rawData.isEmpty() ? payload.size() : rawData.size();
                     // Write entry if payload is non-empty, or if the parsed value
                     // was valid (e.g. Patt with no patterns has valid QVariantHash
                     // but empty serialized payload). Skip only for invalid QVariant
                     // (plugins that discard data, like lmsk/lr16/anno/feid).
-                    if (!payload.isEmpty() || value.isValid()) {
+                    if (payloadSize > 0 || value.isValid()) {
                         extraBuf.write("8BIM", 4);
                         extraBuf.write(key.leftJustified(4, '\0', true));
                         // Per-layer ALI: length field includes padding to 4-byte boundary
-                        quint32 paddedSize = payload.size();
+                        quint32 paddedSize = payloadSize;
                         int remainder = paddedSize % 4;
                         if (remainder != 0) paddedSize += (4 - remainder);
                         QPsdSection::writeU32(&extraBuf, paddedSize);
-                        extraBuf.write(payload);
-                        if (paddedSize > static_cast<quint32>(payload.size()))
-                            extraBuf.write(QByteArray(paddedSize - payload.size(), '\0'));
+                        if (rawData.isEmpty())
+                            extraBuf.write(payload);
+                        else if (!writeSlice(&extraBuf, rawData, &d->errorString))
+                            return false;
+                        if (paddedSize > payloadSize)
+                            extraBuf.write(QByteArray(paddedSize - payloadSize, '\0'));
                     }
                 }
                 extraBuf.close();
@@ -446,26 +528,15 @@ bool QPsdWriter::write(QIODevice *device) const
                 liBuf.write(extraBuf.data());
             }
 
-            // --- Channel image data ---
-            for (int ri = 0; ri < records.size(); ++ri) {
-                for (int ci = 0; ci < allEncodedChannels.at(ri).size(); ++ci) {
-                    liBuf.write(allEncodedChannels.at(ri).at(ci));
-                }
-            }
-
             } // end if (!records.isEmpty())
 
             liBuf.close();
-
-            // Write layer info length (rounded up to multiple of 4)
-            quint32 liSize = liBuf.data().size();
-            quint32 liPaddedSize = (liSize + 3) & ~3u;
-            QPsdSection::writeU32(&lmiBuf, liPaddedSize);
-            lmiBuf.write(liBuf.data());
-            if (liPaddedSize > liSize)
-                lmiBuf.write(QByteArray(liPaddedSize - liSize, '\0'));
         }
 
+        // Layer info length (rounded up to multiple of 4), channel image data included
+        const quint32 liSize = quint32(liBuf.data().size() + channelDataSize);
+        const quint32 liPaddedSize = (liSize + 3) & ~3u;
+
         // --- Global layer mask info ---
         const auto &glmi = d->layerAndMaskInformation.globalLayerMaskInfo();
         if (glmi.length() == 0) {
@@ -492,29 +563,31 @@ bool QPsdWriter::write(QIODevice *device) const
         }
 
         // --- Additional layer information (top-level, preserve original order) ---
-        const auto &topAli = d->layerAndMaskInformation.additionalLayerInformation();
-        const auto &topKeyOrder = d->layerAndMaskInformation.aliKeyOrder();
-        const auto topKeys = topKeyOrder.isEmpty() ? topAli.keys() : topKeyOrder;
-        for (const auto &key : topKeys) {
-            if (!topAli.contains(key))
-                continue;
-            const QVariant &value = topAli.value(key);
+        const auto topAli = d->layerAndMaskInformation.additionalLayerInformation();
+        for (auto it = topAli.cbegin(); it != topAli.cend(); ++it) {
+            const QByteArray key = it.key().toByteArray();
+            const QVariant &value = it.value();
+            const QPsdByteSlice rawData = rawDataSlice(value);
             QByteArray payload;
             if (value.typeId() == QMetaType::QByteArray) {
                 payload = value.toByteArray();
-            } else {
+            } else if (rawData.isEmpty()) {
                 auto plugin = QPsdAdditionalLayerInformationPlugin::plugin(key);
                 if (plugin)
                     payload = plugin->serialize(value);
             }
-            if (!payload.isEmpty() || value.isValid()) {
+            const qint64 payloadSize = rawData.isEmpty() ? payload.size() : rawData.size();
+            if (payloadSize > 0 || value.isValid()) {
                 lmiBuf.write("8BIM", 4);
                 lmiBuf.write(key.leftJustified(4, '\0', true));
                 // Top-level ALI: length is actual payload size,
                 // padded to 4-byte boundary (parser uses EnsureSeek with padding=4)
-                QPsdSection::writeU32(&lmiBuf, payload.size());
-                lmiBuf.write(payload);
-                int remainder = payload.size() % 4;
+                QPsdSection::writeU32(&lmiBuf, payloadSize);
+                if (rawData.isEmpty())
+                    lmiBuf.write(payload);
+                else if (!writeSlice(&lmiBuf, rawData, &d->errorString))
+                    return false;
+                int remainder = payloadSize % 4;
                 if (remainder != 0)
                     lmiBuf.write(QByteArray(4 - remainder, '\0'));
             }
@@ -523,16 +596,29 @@ bool QPsdWriter::write(QIODevice *device) const
         lmiBuf.close();
 
         // Write entire layer and mask info section length
-        QPsdSection::writeU32(device, lmiBuf.data().size());
+        QPsdSection::writeU32(device, quint32(sizeof(quint32) + liPaddedSize + lmiBuf.data().size()));
+        QPsdSection::writeU32(device, liPaddedSize);
+        device->write(liBuf.data());
+        // --- Channel image data ---
+        for (const auto &encodedChannels : std::as_const(allEncodedChannels)) {
+            for (const auto &encoded : encodedChannels) {
+                if (!writeSlice(device, encoded, &d->errorString))
+                    return false;
+            }
+        }
+        if (liPaddedSize > liSize)
+            device->write(QByteArray(liPaddedSize - liSize, '\0'));
+        // Global layer mask info and additional layer information
         device->write(lmiBuf.data());
     }
 
     // === Section 5: Image Data ===
     {
 #ifdef QT_PSD_RAW_ROUND_TRIP
-        const QByteArray rawImgBytes = d->useRawBytes ? d->imageData.rawImageBytes() : QByteArray();
+        const QPsdByteSlice rawImgBytes = d->useRawBytes ? d->imageData.rawImageSlice() : QPsdByteSlice();
         if (!rawImgBytes.isEmpty()) {
-            device->write(rawImgBytes);
+            if (!writeSlice(device, rawImgBytes, &d->errorString))
+                return false;
         } else
 #endif
         {
@@ -576,17 +662,27 @@ bool QPsdWriter::write(QIODevice *device) const
     return true;
 }
 
+// The document is written to a temporary file that replaces filePath once
+// it is complete. A document loaded with QPsdParser::MemoryMapped can thus
+// be saved to the file it was loaded from: its mapping keeps the old
+// contents until the parser is gone.
 bool QPsdWriter::write(const QString &filePath) const
 {
-    QFile file(filePath);
-    if (!file.open(QFile::WriteOnly)) {
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
         d->errorString = file.errorString();
         return false;
     }
 
-    bool ok = write(&file);
-    file.close();
-    return ok;
+    if (!write(&file)) {
+        file.cancelWriting();
+        return false;
+    }
+    if (!file.commit()) {
+        d->errorString = file.errorString();
+        return false;
+    }
+    return true;
 }
 
 QT_END_NAMESPACE
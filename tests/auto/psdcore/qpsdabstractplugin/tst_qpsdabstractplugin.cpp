@@ -0,0 +1,96 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+#include <QtPsdCore/qpsdadditionallayerinformationplugin.h>
+
+using namespace Qt::Literals::StringLiterals;
+
+class tst_QPsdAbstractPlugin : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void loadOnFirstUse();
+
+private:
+    static QSet<QString> loadedLibraries();
+
+    QTemporaryDir m_cacheDir;
+};
+
+void tst_QPsdAbstractPlugin::initTestCase()
+{
+    QVERIFY(m_cacheDir.isValid());
+    // The index is written here, which tells the test which library holds
+    // which key without loading any of them
+    qputenv("QTPSD_PLUGIN_CACHE", QFile::encodeName(m_cacheDir.path()));
+}
+
+// File names of the shared objects mapped into this process
+QSet<QString> tst_QPsdAbstractPlugin::loadedLibraries()
+{
+    QSet<QString> ret;
+    QFile maps(u"/proc/self/maps"_s);
+    if (!maps.open(QIODevice::ReadOnly | QIODevice::Text))
+        return ret;
+    const auto lines = maps.readAll().split('\n');
+    for (const QByteArray &line : lines) {
+        const auto path = line.indexOf('/');
+        if (path >= 0)
+            ret.insert(QFileInfo(QFile::decodeName(line.mid(path))).fileName());
+    }
+    return ret;
+}
+
+void tst_QPsdAbstractPlugin::loadOnFirstUse()
+{
+#ifndef Q_OS_LINUX
+    QSKIP("Reads the mapped libraries from /proc");
+#endif
+    // Nothing in this process has asked for a plugin yet
+    const auto keys = QPsdAdditionalLayerInformationPlugin::keys();
+    QVERIFY(keys.contains("luni"_ba));
+    QVERIFY(keys.contains("lsct"_ba));
+
+    const auto cacheFiles = QDir(m_cacheDir.path()).entryInfoList({ u"psdadditionallayerinformation-*.json"_s });
+    QCOMPARE(cacheFiles.size(), 1);
+    QFile cacheFile(cacheFiles.first().absoluteFilePath());
+    QVERIFY(cacheFile.open(QIODevice::ReadOnly));
+    const auto libraries = QJsonDocument::fromJson(cacheFile.readAll()).object().value("libraries"_L1).toArray();
+    QHash<QByteArray, QString> libraryOfKey;
+    for (const QJsonValue &library : libraries) {
+        const auto entry = library.toObject();
+        for (const QJsonValue &key : entry.value("keys"_L1).toArray())
+            libraryOfKey.insert(key.toString().toUtf8(), entry.value("file"_L1).toString());
+    }
+    if (!libraryOfKey.contains("luni"_ba))
+        QSKIP("The format plugins are built into PsdCore");
+    const QString luni = libraryOfKey.value("luni"_ba);
+    const QString lsct = libraryOfKey.value("lsct"_ba);
+    QVERIFY(!luni.isEmpty());
+    QVERIFY(!lsct.isEmpty());
+    QCOMPARE_NE(luni, lsct);
+
+    // Listing the keys only read the metadata
+    auto loaded = loadedLibraries();
+    for (const QString &library : std::as_const(libraryOfKey))
+        QVERIFY2(!loaded.contains(library), qPrintable(library));
+
+    auto *plugin = QPsdAdditionalLayerInformationPlugin::plugin("luni"_ba);
+    QVERIFY(plugin);
+    loaded = loadedLibraries();
+    QVERIFY(loaded.contains(luni));
+    QVERIFY(!loaded.contains(lsct));
+
+    // Later lookups reuse the instance
+    QCOMPARE(QPsdAdditionalLayerInformationPlugin::plugin("luni"_ba), plugin);
+    QVERIFY(!QPsdAdditionalLayerInformationPlugin::plugin("????"_ba));
+    QVERIFY(!loadedLibraries().contains(lsct));
+
+    QVERIFY(QPsdAdditionalLayerInformationPlugin::plugin("lsct"_ba));
+    QVERIFY(loadedLibraries().contains(lsct));
+}
+
+QTEST_GUILESS_MAIN(tst_QPsdAbstractPlugin)
+#include "tst_qpsdabstractplugin.moc"
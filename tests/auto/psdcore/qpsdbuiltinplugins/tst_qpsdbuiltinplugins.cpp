@@ -0,0 +1,94 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+#include <QtPsdCore/qpsdadditionallayerinformationplugin.h>
+#include <QtPsdCore/qpsddescriptorplugin.h>
+#include <QtPsdCore/qpsdeffectslayerplugin.h>
+#include <QtPsdCore/private/qpsdbuiltinplugins_p.h>
+
+#include <dlfcn.h>
+
+using namespace Qt::Literals::StringLiterals;
+
+class tst_QPsdBuiltinPlugins : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void table();
+    void resolveWithoutPluginDirectory();
+
+private:
+    // Whether the plugin directory of type has been listed
+    bool scanned(const char *type) const;
+
+    QTemporaryDir m_cacheDir;
+};
+
+void tst_QPsdBuiltinPlugins::initTestCase()
+{
+    QVERIFY(m_cacheDir.isValid());
+    // An index is written here for every plugin directory that is listed
+    qputenv("QTPSD_PLUGIN_CACHE", QFile::encodeName(m_cacheDir.path()));
+}
+
+bool tst_QPsdBuiltinPlugins::scanned(const char *type) const
+{
+    return !QDir(m_cacheDir.path()).entryList({ QLatin1StringView(type) + "-*.json"_L1 }).isEmpty();
+}
+
+void tst_QPsdBuiltinPlugins::table()
+{
+    QVERIFY(qpsdBuiltinPluginTypeCount > 0);
+    for (qsizetype i = 0; i < qpsdBuiltinPluginTypeCount; i++) {
+        const QPsdBuiltinPluginType &type = qpsdBuiltinPluginTypes[i];
+        QCOMPARE(qpsdBuiltinPluginType(type.name), &type);
+        for (qsizetype j = 0; j < type.count; j++) {
+            const QPsdBuiltinPlugin &plugin = type.plugins[j];
+            if (j > 0)
+                QVERIFY(type.plugins[j - 1].key < plugin.key);
+            QCOMPARE(qpsdBuiltinPlugin(&type, plugin.key.toByteArray()), &plugin);
+        }
+        QVERIFY(!qpsdBuiltinPlugin(&type, "????"));
+        QVERIFY(!qpsdBuiltinPlugin(&type, "lyid-"));
+    }
+    QVERIFY(!qpsdBuiltinPluginType("psdexporter"));
+}
+
+// Built-in keys come from the table, without locating or listing the plugin
+// directory and without loading anything
+void tst_QPsdBuiltinPlugins::resolveWithoutPluginDirectory()
+{
+    const QPsdBuiltinPluginType *descriptors = qpsdBuiltinPluginType("psddescriptor");
+    QVERIFY(descriptors);
+    QVERIFY(descriptors->complete);
+
+    auto *objc = QPsdDescriptorPlugin::plugin("Objc"_ba);
+    QVERIFY(objc);
+    QCOMPARE(objc->key(), "Objc"_ba);
+    QCOMPARE(QPsdDescriptorPlugin::plugin("Objc"_ba), objc);
+    QVERIFY(!QPsdDescriptorPlugin::plugin("????"_ba));
+    QVERIFY(QPsdEffectsLayerPlugin::plugin("sofi"_ba));
+    // Another key of the same plugin shares its instance and its key
+    auto *lfx2 = QPsdAdditionalLayerInformationPlugin::plugin("lfx2"_ba);
+    QVERIFY(lfx2);
+    QCOMPARE(QPsdAdditionalLayerInformationPlugin::plugin("lmfx"_ba), lfx2);
+    QCOMPARE(lfx2->key(), "lfx2"_ba);
+
+    // The instance lives in PsdCore itself
+    Dl_info plugin, core;
+    QVERIFY(dladdr(objc->metaObject(), &plugin));
+    QVERIFY(dladdr(&QPsdDescriptorPlugin::staticMetaObject, &core));
+    QCOMPARE(QByteArray(plugin.dli_fname), QByteArray(core.dli_fname));
+
+    // Types without plugins left in the directory are never listed, not even
+    // for all of their keys
+    QCOMPARE(QPsdDescriptorPlugin::keys().size(), descriptors->count);
+    QVERIFY(!scanned("psddescriptor"));
+    QVERIFY(!scanned("psdeffectslayer"));
+    QVERIFY(!scanned("psdadditionallayerinformation"));
+}
+
+QTEST_GUILESS_MAIN(tst_QPsdBuiltinPlugins)
+#include "tst_qpsdbuiltinplugins.moc"
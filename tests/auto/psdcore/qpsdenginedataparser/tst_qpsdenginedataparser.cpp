@@ -12,6 +12,8 @@ class tst_QPsdEngineDataParser : public QObject
 private slots:
     void parse_data();
     void parse();
+    void subtrees_data();
+    void subtrees();
 };
 
 void tst_QPsdEngineDataParser::parse_data()
@@ -53,5 +55,49 @@ void tst_QPsdEngineDataParser::parse()
     QCOMPARE(cbor.toJsonObject(), json.object());
 }
 
+void tst_QPsdEngineDataParser::subtrees_data()
+{
+    parse_data();
+}
+
+void tst_QPsdEngineDataParser::subtrees()
+{
+    QFETCH(QString, ed);
+
+    QFile engineDataFile(ed);
+    QVERIFY(engineDataFile.open(QIODevice::ReadOnly));
+    const QByteArray engineDataData = engineDataFile.readAll();
+    engineDataFile.close();
+
+    QPsdEngineDataParser::ParseError error;
+    const auto full = QPsdEngineDataParser::parseEngineData(engineDataData, &error);
+    QVERIFY(!error);
+
+    const QByteArrayList subtrees = { "EngineDict"_ba, "Font/Name"_ba };
+    const auto partial = QPsdEngineDataParser::parseEngineData(engineDataData, subtrees, &error);
+    QVERIFY(!error);
+
+    // Selected subtrees are identical to a full parse
+    QCOMPARE(partial.value("EngineDict"_L1), full.value("EngineDict"_L1));
+    const auto font = partial.value("Font"_L1).toMap();
+    const auto fullFont = full.value("Font"_L1).toMap();
+    QCOMPARE(font.value("Name"_L1), fullFont.value("Name"_L1));
+
+    // Everything else is kept as raw text
+    QCOMPARE(font.size(), fullFont.size());
+    for (auto it = font.constBegin(); it != font.constEnd(); ++it) {
+        if (it.key() == "Name"_L1)
+            continue;
+        QVERIFY(it.value().isTag());
+        QCOMPARE(it.value().tag(), QPsdEngineDataParser::RawValueTag);
+    }
+
+    // and written back unchanged
+    const auto serialized = QPsdEngineDataParser::serializeEngineData(partial);
+    const auto reparsed = QPsdEngineDataParser::parseEngineData(serialized, &error);
+    QVERIFY(!error);
+    QCOMPARE(reparsed, full);
+}
+
 QTEST_MAIN(tst_QPsdEngineDataParser)
 #include "tst_qpsdenginedataparser.moc"
@@ -0,0 +1,148 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtTest/QtTest>
+#include <QtPsdCore/qpsdfourccmap.h>
+
+using namespace Qt::Literals::StringLiterals;
+
+class tst_QPsdFlatMap : public QObject
+{
+    Q_OBJECT
+private slots:
+    void fourCC();
+    void insertionOrder();
+    void lookup();
+    void overwrite();
+    void iteration();
+    void removal();
+    void lookupKey();
+};
+
+void tst_QPsdFlatMap::fourCC()
+{
+    static_assert(QPsdFourCC("lyid").value() == 0x6c796964);
+    QCOMPARE(QPsdFourCC("TySh").toByteArray(), "TySh"_ba);
+    QCOMPARE(QPsdFourCC(QByteArrayView("TySh")), QPsdFourCC("TySh"));
+    // Shorter keys are padded with zero bytes
+    QCOMPARE(QPsdFourCC(QByteArrayView("ab")).toByteArray(), QByteArray("ab\0\0", 4));
+}
+
+void tst_QPsdFlatMap::insertionOrder()
+{
+    QPsdFourCCMap map;
+    QVERIFY(map.isEmpty());
+    map.insert("lyid", 1);
+    map.insert("TySh", 2);
+    map.insert("luni", 3);
+    map["lsct"] = 4;
+
+    QCOMPARE(map.size(), 4);
+    QCOMPARE(map.keys(), (QList<QPsdFourCC> { "lyid", "TySh", "luni", "lsct" }));
+    QCOMPARE(map.values(), (QList<QVariant> { 1, 2, 3, 4 }));
+
+    // Keys that sort or hash differently keep their insertion order
+    const QPsdFourCCMap list { { "zzzz", 1 }, { "aaaa", 2 }, { "mmmm", 3 } };
+    QCOMPARE(list.keys(), (QList<QPsdFourCC> { "zzzz", "aaaa", "mmmm" }));
+}
+
+void tst_QPsdFlatMap::lookup()
+{
+    const QPsdFourCCMap map { { "lyid", 1 }, { "TySh", u"text"_s } };
+
+    QVERIFY(map.contains("lyid"));
+    QVERIFY(map.contains("TySh"));
+    QVERIFY(!map.contains("tysh"));
+    QCOMPARE(map.value("lyid"), QVariant(1));
+    QCOMPARE(map.value("TySh"), QVariant(u"text"_s));
+    QVERIFY(!map.value("luni").isValid());
+    QCOMPARE(map.value("luni", 42), QVariant(42));
+
+    QCOMPARE(map.find("TySh").value(), QVariant(u"text"_s));
+    QCOMPARE(map.find("TySh").key(), QPsdFourCC("TySh"));
+    QVERIFY(map.find("luni") == map.end());
+    QVERIFY(map.constFind("luni") == map.constEnd());
+}
+
+void tst_QPsdFlatMap::overwrite()
+{
+    QPsdFourCCMap map { { "lyid", 1 }, { "TySh", 2 }, { "luni", 3 } };
+
+    // An existing key keeps its place
+    map.insert("TySh", 20);
+    QCOMPARE(map.size(), 3);
+    QCOMPARE(map.value("TySh"), QVariant(20));
+    QCOMPARE(map.keys(), (QList<QPsdFourCC> { "lyid", "TySh", "luni" }));
+
+    map["lyid"] = 10;
+    QCOMPARE(map.size(), 3);
+    QCOMPARE(map.values(), (QList<QVariant> { 10, 20, 3 }));
+
+    // operator[] appends a default value for a new key
+    QVERIFY(!map["lsct"].isValid());
+    QCOMPARE(map.size(), 4);
+    QCOMPARE(map.keys().last(), QPsdFourCC("lsct"));
+
+    const QPsdFourCCMap expected { { "lyid", 10 }, { "TySh", 20 }, { "luni", 3 }, { "lsct", QVariant() } };
+    QCOMPARE(map, expected);
+    QVERIFY(map != QPsdFourCCMap());
+}
+
+void tst_QPsdFlatMap::iteration()
+{
+    const QPsdFourCCMap map { { "lyid", 1 }, { "TySh", 2 }, { "luni", 3 } };
+
+    QList<QPsdFourCC> keys;
+    QList<QVariant> values;
+    for (auto it = map.cbegin(); it != map.cend(); ++it) {
+        keys.append(it.key());
+        values.append(*it);
+    }
+    QCOMPARE(keys, map.keys());
+    QCOMPARE(values, map.values());
+
+    // Range-for visits the values
+    values.clear();
+    for (const QVariant &value : map)
+        values.append(value);
+    QCOMPARE(values, map.values());
+
+    auto it = map.end();
+    --it;
+    QCOMPARE(it.key(), QPsdFourCC("luni"));
+    QCOMPARE(std::distance(map.begin(), map.end()), qsizetype(3));
+
+    QVERIFY(QPsdFourCCMap().begin() == QPsdFourCCMap().end());
+}
+
+void tst_QPsdFlatMap::removal()
+{
+    QPsdFourCCMap map { { "lyid", 1 }, { "TySh", 2 }, { "luni", 3 } };
+
+    QVERIFY(map.remove("TySh"));
+    QVERIFY(!map.remove("TySh"));
+    QCOMPARE(map.keys(), (QList<QPsdFourCC> { "lyid", "luni" }));
+
+    QCOMPARE(map.take("lyid"), QVariant(1));
+    QVERIFY(!map.take("lyid").isValid());
+    QCOMPARE(map.keys(), (QList<QPsdFourCC> { "luni" }));
+
+    map.clear();
+    QVERIFY(map.isEmpty());
+}
+
+// Descriptors are keyed by byte arrays and looked up by views of them
+void tst_QPsdFlatMap::lookupKey()
+{
+    QPsdFlatMap<QByteArray, QVariant, QByteArrayView> map;
+    map.insert("Nm  "_ba, u"name"_s);
+    map.insert("Clr "_ba, 1);
+
+    QVERIFY(map.contains("Nm  "));
+    QCOMPARE(map.value(QByteArrayView("Clr ")), QVariant(1));
+    QVERIFY(!map.contains("Nm"));
+    QCOMPARE(map.keys(), (QByteArrayList { "Nm  "_ba, "Clr "_ba }));
+}
+
+QTEST_GUILESS_MAIN(tst_QPsdFlatMap)
+#include "tst_qpsdflatmap.moc"
@@ -3,16 +3,44 @@
 
 #include <QtPsdCore/QPsdFileHeader>
 #include <QtPsdCore/QPsdImageData>
+#include <QtPsdCore/QPsdLayerInfo>
 #include <QtPsdCore/QPsdLayerRecord>
 #include <QtPsdCore/QPsdParser>
+#include <QtPsdCore/QPsdThumbnail>
+#include <QtCore/QTemporaryFile>
 #include <QtTest/QtTest>
 
+#include <array>
+
 class tst_QPsdParser : public QObject
 {
     Q_OBJECT
 private slots:
     void parse_data();
     void parse();
+    void memoryMapped_data();
+    void memoryMapped();
+    void lazyChannelDecoding_data();
+    void lazyChannelDecoding();
+    void truncatedMapping_data();
+    void truncatedMapping();
+    void parallelDecode_data();
+    void parallelDecode();
+    void concurrentParse_data();
+    void concurrentParse();
+    void arena_data();
+    void arena();
+    void skeleton_data();
+    void skeleton();
+    void compositeOnly_data();
+    void compositeOnly();
+    void loadAsync_data();
+    void loadAsync();
+    void loadAsyncCanceled();
+    void thumbnail_data();
+    void thumbnail();
+    void region_data();
+    void region();
 
 private:
     void addPsdFiles();
@@ -29,7 +57,7 @@ void tst_QPsdParser::addPsdFiles()
             findPsd(dir, baseDir);
             dir->cdUp();
         }
-        for (const QString &fileName : dir->entryList(QStringList() << "*.psd")) {
+        for (const QString &fileName : dir->entryList(QStringList() << "*.psd" << "*.psb")) {
             // Use relative path from base directory for test row name
             QString relativePath = baseDir.relativeFilePath(dir->filePath(fileName));
             QTest::newRow(relativePath.toLatin1().data()) << dir->filePath(fileName);
@@ -56,5 +84,445 @@ void tst_QPsdParser::parse()
     parser.load(psd);
 }
 
+void tst_QPsdParser::memoryMapped_data()
+{
+    addPsdFiles();
+}
+
+void tst_QPsdParser::memoryMapped()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser buffered;
+    buffered.load(psd);
+
+    QPsdParser mapped;
+    mapped.load(psd, QPsdParser::MemoryMapped);
+
+    QCOMPARE(mapped.fileHeader().width(), buffered.fileHeader().width());
+    QCOMPARE(mapped.fileHeader().height(), buffered.fileHeader().height());
+    QCOMPARE(mapped.imageData().imageData(), buffered.imageData().imageData());
+
+    const auto mappedRecords = mapped.layerAndMaskInformation().layerInfo().records();
+    const auto bufferedRecords = buffered.layerAndMaskInformation().layerInfo().records();
+    QCOMPARE(mappedRecords.size(), bufferedRecords.size());
+    for (qsizetype i = 0; i < mappedRecords.size(); i++) {
+        const auto mappedImage = mappedRecords.at(i).imageData();
+        const auto bufferedImage = bufferedRecords.at(i).imageData();
+        for (const auto &channelInfo : bufferedRecords.at(i).channelInfo()) {
+            QCOMPARE(mappedImage.channelData(channelInfo.id()),
+                     bufferedImage.channelData(channelInfo.id()));
+        }
+    }
+}
+
+void tst_QPsdParser::lazyChannelDecoding_data()
+{
+    addPsdFiles();
+}
+
+void tst_QPsdParser::lazyChannelDecoding()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser parser;
+    parser.load(psd);
+
+    const auto records = parser.layerAndMaskInformation().layerInfo().records();
+    for (const auto &record : records) {
+        auto imageData = record.imageData();
+        for (const auto &channelInfo : record.channelInfo())
+            QVERIFY(!imageData.isChannelDecoded(channelInfo.id()));
+        for (const auto &channelInfo : record.channelInfo()) {
+            const auto data = imageData.channelData(channelInfo.id());
+            if (!data.isEmpty())
+                QVERIFY(imageData.isChannelDecoded(channelInfo.id()));
+        }
+        imageData.releaseDecodedData();
+        for (const auto &channelInfo : record.channelInfo())
+            QVERIFY(!imageData.isChannelDecoded(channelInfo.id()));
+    }
+}
+
+void tst_QPsdParser::truncatedMapping_data()
+{
+    addPsdFiles();
+}
+
+// Decoding the channels of a mapped document that has been truncated since
+// must not touch the pages that are gone
+void tst_QPsdParser::truncatedMapping()
+{
+#if !defined(Q_OS_UNIX)
+    QSKIP("Only Unix lets a memory-mapped file be truncated");
+#else
+    QFETCH(QString, psd);
+
+    QTemporaryFile copy;
+    QVERIFY(copy.open());
+    {
+        QFile source(psd);
+        QVERIFY(source.open(QIODevice::ReadOnly));
+        QVERIFY(copy.write(source.readAll()) == source.size());
+        QVERIFY(copy.flush());
+    }
+
+    QPsdParser parser;
+    parser.load(copy.fileName(), QPsdParser::MemoryMapped);
+    const auto records = parser.layerAndMaskInformation().layerInfo().records();
+    if (records.isEmpty())
+        QSKIP("No layers");
+
+    QVERIFY(copy.resize(0));
+    for (const auto &record : records) {
+        const auto imageData = record.imageData();
+        for (const auto &channelInfo : record.channelInfo())
+            QVERIFY(imageData.channelData(channelInfo.id()).isEmpty());
+    }
+#endif
+}
+
+void tst_QPsdParser::parallelDecode_data()
+{
+    addPsdFiles();
+}
+
+void tst_QPsdParser::parallelDecode()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser serial;
+    serial.load(psd);
+
+    QPsdParser parallel;
+    parallel.load(psd, QPsdParser::MemoryMapped | QPsdParser::ParallelDecode);
+
+    const auto parallelRecords = parallel.layerAndMaskInformation().layerInfo().records();
+    const auto serialRecords = serial.layerAndMaskInformation().layerInfo().records();
+    QCOMPARE(parallelRecords.size(), serialRecords.size());
+    for (qsizetype i = 0; i < parallelRecords.size(); i++) {
+        QCOMPARE(parallelRecords.at(i).name(), serialRecords.at(i).name());
+        const auto parallelImage = parallelRecords.at(i).imageData();
+        const auto serialImage = serialRecords.at(i).imageData();
+        for (const auto &channelInfo : serialRecords.at(i).channelInfo()) {
+            const auto data = serialImage.channelData(channelInfo.id());
+            if (!data.isEmpty())
+                QVERIFY(parallelImage.isChannelDecoded(channelInfo.id()));
+            QCOMPARE(parallelImage.channelData(channelInfo.id()), data);
+        }
+    }
+}
+
+void tst_QPsdParser::concurrentParse_data()
+{
+    addPsdFiles();
+}
+
+void tst_QPsdParser::concurrentParse()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser serial;
+    serial.load(psd);
+
+    // Every thread goes through the same plugin instances at the same time
+    std::array<QPsdParser, 4> parsers;
+    std::vector<std::unique_ptr<QThread>> threads;
+    for (auto &parser : parsers) {
+        threads.emplace_back(QThread::create([&parser, psd] {
+            parser.load(psd, QPsdParser::ParallelDecode);
+        }));
+        threads.back()->start();
+    }
+    for (const auto &thread : threads)
+        QVERIFY(thread->wait());
+
+    const auto compareInformation = [](const QPsdFourCCMap &information,
+                                       const QPsdFourCCMap &expected) {
+        QCOMPARE(information.size(), expected.size());
+        for (auto it = expected.cbegin(); it != expected.cend(); ++it) {
+            QVERIFY2(information.contains(it.key()), it.key().toByteArray().constData());
+            QCOMPARE(information.value(it.key()).typeId(), it.value().typeId());
+        }
+    };
+
+    const auto serialRecords = serial.layerAndMaskInformation().layerInfo().records();
+    for (const auto &parser : parsers) {
+        compareInformation(parser.layerAndMaskInformation().additionalLayerInformation(),
+                           serial.layerAndMaskInformation().additionalLayerInformation());
+        if (QTest::currentTestFailed())
+            return;
+        const auto records = parser.layerAndMaskInformation().layerInfo().records();
+        QCOMPARE(records.size(), serialRecords.size());
+        for (qsizetype i = 0; i < records.size(); i++) {
+            QCOMPARE(records.at(i).name(), serialRecords.at(i).name());
+            compareInformation(records.at(i).additionalLayerInformation(),
+                               serialRecords.at(i).additionalLayerInformation());
+            if (QTest::currentTestFailed())
+                return;
+        }
+        QCOMPARE(parser.imageData().imageData(), serial.imageData().imageData());
+    }
+}
+
+void tst_QPsdParser::arena_data()
+{
+    addPsdFiles();
+}
+
+void tst_QPsdParser::arena()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser serial;
+    serial.load(psd);
+
+    const auto serialRecords = serial.layerAndMaskInformation().layerInfo().records();
+    // Channels read one by one share the arena's blocks, the parallel path
+    // reads all layers at once
+    const QPsdParser::LoadOptions optionSets[] = {
+        QPsdParser::Arena,
+        QPsdParser::Arena | QPsdParser::ParallelDecode,
+    };
+    for (const auto options : optionSets) {
+        // The channels must stay valid after the parser that read them is gone
+        QList<QPsdLayerRecord> records;
+        QPsdImageData imageData;
+        {
+            QPsdParser parser;
+            parser.load(psd, options);
+            records = parser.layerAndMaskInformation().layerInfo().records();
+            imageData = parser.imageData();
+        }
+
+        QCOMPARE(records.size(), serialRecords.size());
+        for (qsizetype i = 0; i < records.size(); i++) {
+            QCOMPARE(records.at(i).name(), serialRecords.at(i).name());
+            QCOMPARE(records.at(i).aliKeyOrder(), serialRecords.at(i).aliKeyOrder());
+            for (const auto &channelInfo : serialRecords.at(i).channelInfo()) {
+                QCOMPARE(records.at(i).imageData().channelData(channelInfo.id()),
+                         serialRecords.at(i).imageData().channelData(channelInfo.id()));
+            }
+        }
+        QCOMPARE(imageData.imageData(), serial.imageData().imageData());
+    }
+}
+
+void tst_QPsdParser::skeleton_data()
+{
+    addPsdFiles();
+}
+
+void tst_QPsdParser::skeleton()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser full;
+    full.load(psd);
+
+    QPsdParser skeleton;
+    skeleton.load(psd, QPsdParser::Skeleton);
+
+    QCOMPARE(skeleton.fileHeader().size(), full.fileHeader().size());
+    QVERIFY(skeleton.imageData().imageData().isEmpty());
+
+    const auto skeletonRecords = skeleton.layerAndMaskInformation().layerInfo().records();
+    const auto fullRecords = full.layerAndMaskInformation().layerInfo().records();
+    QCOMPARE(skeletonRecords.size(), fullRecords.size());
+    for (qsizetype i = 0; i < skeletonRecords.size(); i++) {
+        const auto &record = skeletonRecords.at(i);
+        QCOMPARE(record.name(), fullRecords.at(i).name());
+        QCOMPARE(record.rect(), fullRecords.at(i).rect());
+        QCOMPARE(record.aliKeyOrder(), fullRecords.at(i).aliKeyOrder());
+        for (const auto &channelInfo : record.channelInfo())
+            QVERIFY(record.imageData().channelData(channelInfo.id()).isEmpty());
+    }
+}
+
+void tst_QPsdParser::compositeOnly_data()
+{
+    addPsdFiles();
+}
+
+void tst_QPsdParser::compositeOnly()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser full;
+    full.load(psd);
+
+    QPsdParser composite;
+    composite.load(psd, QPsdParser::CompositeOnly);
+
+    QCOMPARE(composite.fileHeader().size(), full.fileHeader().size());
+    QCOMPARE(composite.imageResources().imageResourceBlocks().size(),
+             full.imageResources().imageResourceBlocks().size());
+    QVERIFY(composite.layerAndMaskInformation().layerInfo().records().isEmpty());
+    QCOMPARE(composite.imageData().compression(), full.imageData().compression());
+    QCOMPARE(composite.imageData().imageData(), full.imageData().imageData());
+}
+
+void tst_QPsdParser::loadAsync_data()
+{
+    addPsdFiles();
+}
+
+void tst_QPsdParser::loadAsync()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser serial;
+    serial.load(psd);
+
+    auto future = QPsdParser::loadAsync(psd, QPsdParser::ParallelDecode);
+    future.waitForFinished();
+    QVERIFY(!future.isCanceled());
+    QCOMPARE(future.resultCount(), 1);
+    QVERIFY(future.progressMaximum() > 0);
+    QCOMPARE(future.progressValue(), future.progressMaximum());
+
+    const auto parser = future.result();
+    QCOMPARE(parser.fileHeader().size(), serial.fileHeader().size());
+    const auto records = parser.layerAndMaskInformation().layerInfo().records();
+    const auto serialRecords = serial.layerAndMaskInformation().layerInfo().records();
+    QCOMPARE(records.size(), serialRecords.size());
+    for (qsizetype i = 0; i < records.size(); i++) {
+        QCOMPARE(records.at(i).name(), serialRecords.at(i).name());
+        for (const auto &channelInfo : records.at(i).channelInfo()) {
+            QVERIFY(records.at(i).imageData().isChannelDecoded(channelInfo.id()));
+            QCOMPARE(records.at(i).imageData().channelData(channelInfo.id()),
+                     serialRecords.at(i).imageData().channelData(channelInfo.id()));
+        }
+    }
+    QCOMPARE(parser.imageData().imageData(), serial.imageData().imageData());
+}
+
+void tst_QPsdParser::loadAsyncCanceled()
+{
+    const QDir psdTools(QFINDTESTDATA("../../3rdparty/psd-tools/tests/psd_files/"));
+    const auto files = psdTools.entryList(QStringList() << "*.psd", QDir::Files, QDir::Size);
+    QVERIFY(!files.isEmpty());
+
+    auto future = QPsdParser::loadAsync(psdTools.filePath(files.first()));
+    future.cancel();
+    future.waitForFinished();
+    // A small file may be loaded completely before cancel() is seen
+    if (future.isCanceled())
+        QCOMPARE(future.resultCount(), 0);
+    else
+        QCOMPARE(future.resultCount(), 1);
+
+    auto missing = QPsdParser::loadAsync(QStringLiteral("does-not-exist.psd"));
+    missing.waitForFinished();
+    QCOMPARE(missing.resultCount(), 0);
+}
+
+void tst_QPsdParser::thumbnail_data()
+{
+    addPsdFiles();
+}
+
+void tst_QPsdParser::thumbnail()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser parser;
+    parser.load(psd, QPsdParser::Skeleton);
+
+    // The RGB thumbnail of Photoshop 5.0 wins over the BGR one of 4.0
+    QPsdImageResourceBlock expected;
+    for (const auto &block : parser.imageResources().imageResourceBlocks()) {
+        if ((block.id() == 1036 && expected.id() != 1036) || (block.id() == 1033 && expected.id() == 0))
+            expected = block;
+    }
+
+    const auto thumbnail = QPsdThumbnail::fromFile(psd);
+    QCOMPARE(thumbnail.isValid(), expected.id() != 0 && expected.data().size() >= 28);
+    if (!thumbnail.isValid())
+        return;
+    QCOMPARE(thumbnail.isBgr(), expected.id() == 1033);
+    QVERIFY(thumbnail.width() > 0);
+    QVERIFY(thumbnail.height() > 0);
+    QCOMPARE(thumbnail.data(), expected.data().mid(28));
+}
+
+static QByteArray crop(const QByteArray &data, int width, int height, int planes, int bytesPerSample, const QRect &rect)
+{
+    QByteArray ret;
+    for (int plane = 0; plane < planes; plane++) {
+        for (int y = rect.top(); y <= rect.bottom(); y++) {
+            const qsizetype offset = ((qsizetype(plane) * height + y) * width + rect.left()) * bytesPerSample;
+            ret.append(data.mid(offset, qsizetype(rect.width()) * bytesPerSample));
+        }
+    }
+    return ret;
+}
+
+void tst_QPsdParser::region_data()
+{
+    addPsdFiles();
+}
+
+void tst_QPsdParser::region()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser parser;
+    parser.load(psd, QPsdParser::MemoryMapped);
+
+    const auto fileHeader = parser.fileHeader();
+    if (fileHeader.depth() < 8)
+        QSKIP("Bitmap documents are not cropped on byte boundaries");
+    const int bytesPerSample = fileHeader.depth() / 8;
+
+    // Decode a window in the middle before anything else has been decoded
+    const auto centerOf = [](int width, int height) {
+        return QRect(width / 4, height / 3, qMax(width / 2, 1), qMax(height / 3, 1));
+    };
+
+    const auto composite = parser.imageData();
+    if (composite.width() > 0 && composite.height() > 0) {
+        const QRect compositeRect = centerOf(composite.width(), composite.height());
+        const auto compositeRegion = composite.region(compositeRect);
+        QCOMPARE(compositeRegion.width(), quint32(compositeRect.width()));
+        QCOMPARE(compositeRegion.height(), quint32(compositeRect.height()));
+        QCOMPARE(compositeRegion.compression(), quint16(QPsdImageData::RawData));
+        const auto compositeData = composite.imageData();
+        if (!compositeData.isEmpty()) {
+            QCOMPARE(compositeRegion.imageData(),
+                     crop(compositeData, composite.width(), composite.height(),
+                          fileHeader.channels(), bytesPerSample, compositeRect));
+        }
+
+        // Read from the file, seeking past the rows outside the rectangle
+        QPsdParser regionParser;
+        regionParser.loadCompositeRegion(psd, compositeRect);
+        const auto readRegion = regionParser.imageData();
+        QCOMPARE(readRegion.width(), compositeRegion.width());
+        QCOMPARE(readRegion.height(), compositeRegion.height());
+        QCOMPARE(readRegion.compression(), quint16(QPsdImageData::RawData));
+        QCOMPARE(readRegion.imageData(), compositeRegion.imageData());
+    }
+
+    const auto records = parser.layerAndMaskInformation().layerInfo().records();
+    for (const auto &record : records) {
+        const auto imageData = record.imageData();
+        const QRect rect = centerOf(imageData.width(), imageData.height());
+        if (rect.isEmpty())
+            continue;
+        const auto region = imageData.region(rect);
+        for (const auto &channelInfo : record.channelInfo()) {
+            const auto id = channelInfo.id();
+            if (id < QPsdChannelInfo::TransparencyMask)
+                continue;
+            const auto full = imageData.channelData(id);
+            if (full.size() != qsizetype(imageData.width()) * imageData.height() * bytesPerSample)
+                continue;
+            QCOMPARE(region.channelData(id), crop(full, imageData.width(), imageData.height(), 1, bytesPerSample, rect));
+            QCOMPARE(int(region.channelCompression(id)), int(QPsdChannelImageData::RawData));
+        }
+    }
+}
+
 QTEST_MAIN(tst_QPsdParser)
 #include "tst_qpsdparser.moc"
@@ -0,0 +1,85 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtGui/QImage>
+#include <QtPsdCore/qpsdblend.h>
+#include <QtPsdGui/private/qpsdguiglobal_p.h>
+#include <QtTest/QtTest>
+
+using namespace Qt::Literals::StringLiterals;
+
+class tst_CustomBlend : public QObject
+{
+    Q_OBJECT
+private slots:
+    void matchesReference_data();
+    void matchesReference();
+};
+
+// Premultiplied pixels with every alpha, a share of them fully opaque or
+// fully transparent
+static QImage randomImage(int width, int height, quint32 seed)
+{
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    const auto next = [&seed] {
+        seed = seed * 1664525 + 1013904223;
+        return seed >> 8;
+    };
+    for (int y = 0; y < height; ++y) {
+        auto *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const quint32 r = next();
+            const int alpha = r % 4 == 0 ? 255 : r % 5 == 0 ? 0 : int(next() & 0xff);
+            const auto channel = [&] { return int(next() & 0xff) * alpha / 255; };
+            line[x] = qRgba(channel(), channel(), channel(), alpha);
+        }
+    }
+    return image;
+}
+
+void tst_CustomBlend::matchesReference_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::addColumn<qreal>("opacity");
+
+    for (int mode = QPsdBlend::Normal; mode <= QPsdBlend::Luminosity; ++mode) {
+        const QByteArray key = QPsdBlend::toKey(QPsdBlend::Mode(mode));
+        QTest::addRow("%s", key.constData()) << mode << 1.0;
+        QTest::addRow("%s 60%%", key.constData()) << mode << 0.6;
+    }
+}
+
+void tst_CustomBlend::matchesReference()
+{
+    QFETCH(int, mode);
+    QFETCH(qreal, opacity);
+
+    // Rows that are not a multiple of the vector width, and more of them
+    // than one band
+    const int width = 131;
+    const int height = 613;
+    const QImage src = randomImage(width, height, 1);
+    const QImage dst = randomImage(width, height, 2);
+
+    QImage expected = dst;
+    QtPsdGui::customBlendReference(expected, src, QPsdBlend::Mode(mode), opacity);
+    QImage actual = dst;
+    QtPsdGui::customBlend(actual, src, QPsdBlend::Mode(mode), opacity);
+
+    // The kernels work in float, the reference in qreal
+    for (int y = 0; y < height; ++y) {
+        const auto *e = reinterpret_cast<const QRgb *>(expected.constScanLine(y));
+        const auto *a = reinterpret_cast<const QRgb *>(actual.constScanLine(y));
+        for (int x = 0; x < width; ++x) {
+            const int difference = qMax(qMax(qAbs(qRed(e[x]) - qRed(a[x])), qAbs(qGreen(e[x]) - qGreen(a[x]))),
+                                        qMax(qAbs(qBlue(e[x]) - qBlue(a[x])), qAbs(qAlpha(e[x]) - qAlpha(a[x]))));
+            if (difference > 1) {
+                QFAIL(qPrintable(u"(%1, %2): expected %3, got %4"_s.arg(x).arg(y)
+                                 .arg(e[x], 8, 16, '0'_L1).arg(a[x], 8, 16, '0'_L1)));
+            }
+        }
+    }
+}
+
+QTEST_MAIN(tst_CustomBlend)
+#include "tst_custom_blend.moc"
@@ -2,16 +2,22 @@
 // SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
 
 #include <QtGui/QImage>
+#include <QtGui/QColorSpace>
+#include <QtCore/QBuffer>
+#include <QtCore/QDataStream>
 #include <QtCore/QDirIterator>
 #include <QtCore/QFileInfo>
+#include <QtPsdCore/QPsdColorModeData>
 #include <QtPsdCore/QPsdFileHeader>
 #include <QtPsdCore/QPsdImageData>
 #include <QtPsdCore/QPsdLayerRecord>
 #include <QtPsdCore/QPsdParser>
+#include <QtPsdCore/QPsdThumbnail>
 #include <QtPsdGui/qpsdguiglobal.h>
 #include <QtTest/QtTest>
 
 #include <algorithm>
+#include <cmath>
 
 using namespace Qt::Literals::StringLiterals;
 
@@ -24,6 +30,16 @@ private slots:
     void imageData();
     void layerImageData_data();
     void layerImageData();
+    void interleavedPixels_data();
+    void interleavedPixels();
+    void labPixels_data();
+    void labPixels();
+    void cmykProfile_data();
+    void cmykProfile();
+    void wrappedPixels_data();
+    void wrappedPixels();
+    void thumbnail_data();
+    void thumbnail();
     void generateImages_data();
     void generateImages();
 
@@ -39,6 +55,7 @@ private:
     QList<SourceInfo> imageSources() const;
     QString imageOutputDir() const;
     int imageLimit() const;
+    static QByteArray thumbnailDocument(const QList<quint16> &resources);
     QString detectSource(const QString &psdPath, const QList<SourceInfo> &sources) const;
     QString sourceRelativePath(const QString &psdPath, const QString &sourceId, const QList<SourceInfo> &sources) const;
 
@@ -253,6 +270,421 @@ void tst_ImageDataToImage::layerImageData()
     }
 }
 
+void tst_ImageDataToImage::interleavedPixels_data()
+{
+    QTest::addColumn<int>("colorMode");
+    QTest::addColumn<int>("depth");
+    QTest::addColumn<int>("channels");
+    QTest::addColumn<int>("opacity");
+    QTest::addColumn<int>("width");
+
+    struct Format {
+        const char *name;
+        QPsdFileHeader::ColorMode colorMode;
+        int depth;
+        int channels;
+        int opacity;
+    };
+    const Format formats[] = {
+        { "RGB 8-bit", QPsdFileHeader::RGB, 8, 3, 255 },
+        { "RGBA 8-bit", QPsdFileHeader::RGB, 8, 4, 255 },
+        { "RGBA 8-bit, opacity", QPsdFileHeader::RGB, 8, 4, 100 },
+        { "RGB 16-bit", QPsdFileHeader::RGB, 16, 3, 255 },
+        { "RGBA 16-bit, opacity", QPsdFileHeader::RGB, 16, 4, 100 },
+        { "RGB 32-bit", QPsdFileHeader::RGB, 32, 3, 255 },
+        { "RGBA 32-bit, opacity", QPsdFileHeader::RGB, 32, 4, 100 },
+        { "CMYK 8-bit", QPsdFileHeader::CMYK, 8, 4, 255 },
+        { "CMYK 16-bit", QPsdFileHeader::CMYK, 16, 4, 255 },
+    };
+    // Four 8-bit planes are interleaved 32 pixels at a time with AVX2, then
+    // 16 at a time with SSE2 or NEON, three planes 16 at a time with SSSE3
+    // or NEON, and the rest one by one. 5 pixels only reach the scalar
+    // tail, 16 only the 16-pixel loop, 64 only the AVX2 loop on hosts that
+    // have it, and 93 = 64 + 16 + 13 all three.
+    const int widths[] = { 5, 16, 64, 93 };
+    for (const Format &format : formats) {
+        for (int width : widths) {
+            QTest::addRow("%s, %d px", format.name, width)
+                    << int(format.colorMode) << format.depth << format.channels << format.opacity << width;
+        }
+    }
+}
+
+void tst_ImageDataToImage::interleavedPixels()
+{
+    QFETCH(int, colorMode);
+    QFETCH(int, depth);
+    QFETCH(int, channels);
+    QFETCH(int, opacity);
+    QFETCH(int, width);
+
+    const int height = 3;
+    const int pixels = width * height;
+    // Every 16-bit sample has distinct high and low bytes
+    const auto sample = [](int channel, int i) -> quint16 {
+        return quint16((i * 37 + channel * 91) % 256 * 257 + channel + 1);
+    };
+    const auto toFloat = [](quint16 value) {
+        return value / 65535.0f;
+    };
+
+    QByteArray planes;
+    for (int channel = 0; channel < channels; ++channel) {
+        for (int i = 0; i < pixels; ++i) {
+            const quint16 value = sample(channel, i);
+            if (depth == 8) {
+                planes.append(char(value >> 8));
+            } else if (depth == 16) {
+                char bytes[2];
+                qToBigEndian(value, bytes);
+                planes.append(bytes, 2);
+            } else {
+                const float f = toFloat(value);
+                quint32 bits;
+                memcpy(&bits, &f, sizeof(bits));
+                char bytes[4];
+                qToBigEndian(bits, bytes);
+                planes.append(bytes, 4);
+            }
+        }
+    }
+
+    QPsdFileHeader header;
+    header.setColorMode(QPsdFileHeader::ColorMode(colorMode));
+    header.setChannels(channels);
+    header.setDepth(depth);
+    header.setWidth(width);
+    header.setHeight(height);
+    QPsdImageData imageData;
+    imageData.setHeader(header);
+    imageData.setWidth(width);
+    imageData.setHeight(height);
+    imageData.setOpacity(opacity);
+    imageData.setImageData(planes);
+
+    const QImage image = QtPsdGui::imageDataToImage(imageData, header);
+    QCOMPARE(image.size(), QSize(width, height));
+
+    for (int y = 0; y < height; ++y) {
+        const uchar *line = image.constScanLine(y);
+        for (int x = 0; x < width; ++x) {
+            const int i = y * width + x;
+            if (colorMode == QPsdFileHeader::CMYK) {
+                for (int channel = 0; channel < 4; ++channel)
+                    QCOMPARE(line[x * 4 + channel], uchar(255 - (sample(channel, i) >> 8)));
+            } else if (depth == 8) {
+                const int bytesPerPixel = channels;
+                QCOMPARE(line[x * bytesPerPixel + 0], uchar(sample(2, i) >> 8));
+                QCOMPARE(line[x * bytesPerPixel + 1], uchar(sample(1, i) >> 8));
+                QCOMPARE(line[x * bytesPerPixel + 2], uchar(sample(0, i) >> 8));
+                if (channels == 4)
+                    QCOMPARE(line[x * 4 + 3], uchar((sample(3, i) >> 8) * opacity / 255));
+            } else {
+                const auto *pixel = reinterpret_cast<const quint16 *>(line) + x * 4;
+                for (int channel = 0; channel < 4; ++channel) {
+                    quint16 expected = 0xffff;
+                    if (channel < channels) {
+                        const quint16 value = sample(channel, i);
+                        const bool alpha = channel == 3;
+                        if (depth == 16) {
+                            expected = alpha ? quint16(value * opacity / 255) : value;
+                        } else {
+                            const float scale = alpha ? static_cast<float>(opacity / 255.0) : 1.0f;
+                            expected = quint16(qBound(0.0f, toFloat(value) * scale, 1.0f) * 65535.0f);
+                        }
+                    }
+                    QCOMPARE(pixel[channel], expected);
+                }
+            }
+        }
+    }
+}
+
+void tst_ImageDataToImage::labPixels_data()
+{
+    QTest::addColumn<int>("depth");
+
+    QTest::newRow("8-bit") << 8;
+    QTest::newRow("16-bit") << 16;
+}
+
+void tst_ImageDataToImage::labPixels()
+{
+    QFETCH(int, depth);
+
+    // Every L with neutral a and b, then sRGB red in D50 Lab
+    const int width = 257;
+    const auto sample = [](int channel, int x) -> int {
+        if (x == 256) {
+            const int red[] = { 138, 209, 198 };
+            return red[channel];
+        }
+        return channel == 0 ? x : 128;
+    };
+
+    QByteArray planes;
+    for (int channel = 0; channel < 3; ++channel) {
+        for (int x = 0; x < width; ++x) {
+            const int value = sample(channel, x);
+            planes.append(char(value));
+            if (depth == 16)
+                planes.append(char(value));
+        }
+    }
+
+    QPsdFileHeader header;
+    header.setColorMode(QPsdFileHeader::Lab);
+    header.setChannels(3);
+    header.setDepth(depth);
+    header.setWidth(width);
+    header.setHeight(1);
+    QPsdImageData imageData;
+    imageData.setHeader(header);
+    imageData.setWidth(width);
+    imageData.setHeight(1);
+    imageData.setImageData(planes);
+
+    const QImage image = QtPsdGui::imageDataToImage(imageData, header);
+    QCOMPARE(image.format(), QImage::Format_RGB888);
+    QCOMPARE(image.size(), QSize(width, 1));
+
+    const uchar *line = image.constScanLine(0);
+    for (int x = 0; x < 256; ++x) {
+        const double l = x * 100.0 / 255;
+        const double f = (l + 16) / 116;
+        const double luminance = f * f * f > 216.0 / 24389 ? f * f * f : l * 27 / 24389;
+        const double encoded = luminance <= 0.0031308 ? 12.92 * luminance : 1.055 * std::pow(luminance, 1 / 2.4) - 0.055;
+        const int expected = qRound(encoded * 255);
+        for (int channel = 0; channel < 3; ++channel)
+            QVERIFY2(qAbs(line[x * 3 + channel] - expected) <= 1, qPrintable(QString::number(x)));
+    }
+    QVERIFY(line[256 * 3 + 0] >= 253);
+    QVERIFY(line[256 * 3 + 1] <= 2);
+    QVERIFY(line[256 * 3 + 2] <= 2);
+}
+
+void tst_ImageDataToImage::cmykProfile_data()
+{
+    addPsdFiles(allSources(), 0);
+}
+
+// The grid that cmykTransform() builds from a profile agrees with QColorSpace
+// converting the same colors directly. The samples are 17 levels apart and
+// so mostly fall between the grid nodes, which are 15 apart: at most 1% of
+// them may be more than 3 levels off in any channel, and none more than 8.
+void tst_ImageDataToImage::cmykProfile()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser parser;
+    parser.load(psd, QPsdParser::Skeleton);
+    if (parser.fileHeader().colorMode() != QPsdFileHeader::CMYK)
+        QSKIP("Not a CMYK document");
+    const QByteArray iccProfile = parser.iccProfile();
+    const QColorSpace colorSpace = QColorSpace::fromIccProfile(iccProfile);
+    if (!colorSpace.isValid() || colorSpace.colorModel() != QColorSpace::ColorModel::Cmyk)
+        QSKIP("No CMYK ICC profile");
+
+    const QPsdColorTransform transform = QtPsdGui::cmykTransform(iccProfile);
+    QVERIFY(transform.isValid());
+    QCOMPARE(transform.inputs(), 4);
+    QCOMPARE(transform.gridSize(), 18);
+
+    // 16 levels of each ink, K varying fastest
+    QImage cmyk(256, 256, QImage::Format_CMYK8888);
+    for (int y = 0; y < cmyk.height(); ++y) {
+        uchar *pixel = cmyk.scanLine(y);
+        for (int x = 0; x < cmyk.width(); ++x) {
+            *pixel++ = uchar(y / 16 * 17);
+            *pixel++ = uchar(y % 16 * 17);
+            *pixel++ = uchar(x / 16 * 17);
+            *pixel++ = uchar(x % 16 * 17);
+        }
+    }
+
+    QImage mapped(cmyk.size(), QImage::Format_RGB32);
+    transform.map(cmyk.constBits(), cmyk.bytesPerLine(), mapped.bits(), mapped.bytesPerLine(),
+                  cmyk.width(), cmyk.height());
+    cmyk.setColorSpace(colorSpace);
+    const QImage expected = cmyk.convertedToColorSpace(QColorSpace::SRgb, QImage::Format_RGB32);
+
+    int worst = 0;
+    qint64 differing = 0;
+    for (int y = 0; y < mapped.height(); ++y) {
+        const QRgb *e = reinterpret_cast<const QRgb *>(expected.constScanLine(y));
+        const QRgb *a = reinterpret_cast<const QRgb *>(mapped.constScanLine(y));
+        for (int x = 0; x < mapped.width(); ++x) {
+            const int difference = qMax(qMax(qAbs(qRed(e[x]) - qRed(a[x])),
+                                             qAbs(qGreen(e[x]) - qGreen(a[x]))),
+                                        qAbs(qBlue(e[x]) - qBlue(a[x])));
+            worst = qMax(worst, difference);
+            if (difference > 3)
+                ++differing;
+        }
+    }
+    const qint64 samples = qint64(mapped.width()) * mapped.height();
+    QVERIFY2(worst <= 8, qPrintable(u"Off by up to %1 levels"_s.arg(worst)));
+    QVERIFY2(differing * 100 <= samples,
+             qPrintable(u"%1 of %2 samples off by more than 3 levels"_s.arg(differing).arg(samples)));
+}
+
+void tst_ImageDataToImage::wrappedPixels_data()
+{
+    QTest::addColumn<int>("colorMode");
+    QTest::addColumn<int>("depth");
+
+    QTest::newRow("Bitmap") << int(QPsdFileHeader::Bitmap) << 1;
+    QTest::newRow("Grayscale 8-bit") << int(QPsdFileHeader::Grayscale) << 8;
+    QTest::newRow("Grayscale 16-bit") << int(QPsdFileHeader::Grayscale) << 16;
+    QTest::newRow("Indexed") << int(QPsdFileHeader::Indexed) << 8;
+}
+
+void tst_ImageDataToImage::wrappedPixels()
+{
+    QFETCH(int, colorMode);
+    QFETCH(int, depth);
+
+    // Rows that are not a multiple of 4 bytes long, or 8 pixels for Bitmap
+    const int width = 13;
+    const int height = 3;
+    const auto sample = [](int x, int y) { return quint16((x * 37 + y * 91) % 256 * 257 + x); };
+
+    QByteArray planes;
+    for (int y = 0; y < height; ++y) {
+        if (depth == 1) {
+            for (int x = 0; x < width; x += 8) {
+                uchar bits = 0;
+                for (int i = 0; i < 8 && x + i < width; ++i)
+                    bits |= (sample(x + i, y) & 0x100) ? 0x80 >> i : 0;
+                planes.append(char(bits));
+            }
+            continue;
+        }
+        for (int x = 0; x < width; ++x) {
+            planes.append(char(sample(x, y) >> 8));
+            if (depth == 16)
+                planes.append(char(sample(x, y)));
+        }
+    }
+
+    QByteArray palette(768, Qt::Uninitialized);
+    for (int i = 0; i < 256; ++i) {
+        palette[i] = char(i);
+        palette[256 + i] = char(255 - i);
+        palette[512 + i] = char(i / 2);
+    }
+    QPsdColorModeData colorModeData;
+    colorModeData.setColorData(palette);
+
+    QPsdFileHeader header;
+    header.setColorMode(QPsdFileHeader::ColorMode(colorMode));
+    header.setChannels(1);
+    header.setDepth(depth);
+    header.setWidth(width);
+    header.setHeight(height);
+    QPsdImageData imageData;
+    imageData.setHeader(header);
+    imageData.setWidth(width);
+    imageData.setHeight(height);
+    imageData.setImageData(planes);
+
+    const QImage image = QtPsdGui::imageDataToImage(imageData, header, colorModeData);
+    QCOMPARE(image.size(), QSize(width, height));
+    // 8-bit and 1-bit planes are shown where they are; 16-bit ones are
+    // swapped into an image of their own
+    if (depth != 16)
+        QCOMPARE(image.constBits(), reinterpret_cast<const uchar *>(imageData.imageData().constData()));
+
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const quint16 value = sample(x, y);
+            const int index = value >> 8;
+            switch (colorMode) {
+            case QPsdFileHeader::Bitmap:
+                QCOMPARE(image.pixel(x, y), (value & 0x100) ? qRgb(0, 0, 0) : qRgb(255, 255, 255));
+                break;
+            case QPsdFileHeader::Grayscale:
+                if (depth == 8)
+                    QCOMPARE(image.constScanLine(y)[x], uchar(index));
+                else
+                    QCOMPARE(reinterpret_cast<const quint16 *>(image.constScanLine(y))[x], value);
+                break;
+            case QPsdFileHeader::Indexed:
+                QCOMPARE(image.pixel(x, y), qRgb(index, 255 - index, index / 2));
+                break;
+            }
+        }
+    }
+}
+
+// The pixels every thumbnail of thumbnailDocument() shows
+static constexpr QRgb thumbnailPixels[] = { qRgb(255, 0, 0), qRgb(0, 128, 255), qRgb(16, 32, 64) };
+
+// A 1x1 RGB document whose image resources are raw thumbnails with the ids
+// in resources, in that order. Resource 1033 stores its pixels as BGR.
+QByteArray tst_ImageDataToImage::thumbnailDocument(const QList<quint16> &resources)
+{
+    constexpr quint32 width = std::size(thumbnailPixels);
+    constexpr quint32 widthBytes = (width * 24 + 31) / 32 * 4;
+
+    QByteArray imageResources;
+    QDataStream resourcesOut(&imageResources, QIODevice::WriteOnly);
+    for (quint16 id : resources) {
+        QByteArray row(widthBytes, '\0');
+        for (quint32 x = 0; x < width; ++x) {
+            const QRgb pixel = thumbnailPixels[x];
+            row[x * 3] = char(id == 1033 ? qBlue(pixel) : qRed(pixel));
+            row[x * 3 + 1] = char(qGreen(pixel));
+            row[x * 3 + 2] = char(id == 1033 ? qRed(pixel) : qBlue(pixel));
+        }
+        resourcesOut.writeRawData("8BIM", 4);
+        resourcesOut << id << quint16(0) << quint32(28 + row.size());
+        resourcesOut << quint32(QPsdThumbnail::RawRgb) << width << quint32(1) << widthBytes
+                     << quint32(row.size()) << quint32(row.size()) << quint16(24) << quint16(1);
+        resourcesOut.writeRawData(row.constData(), row.size());
+    }
+
+    QByteArray ret;
+    QDataStream out(&ret, QIODevice::WriteOnly);
+    out.writeRawData("8BPS", 4);
+    out << quint16(1) << quint16(0) << quint32(0) << quint16(3)
+        << quint32(1) << quint32(1) << quint16(8) << quint16(QPsdFileHeader::RGB);
+    out << quint32(0) << quint32(imageResources.size());
+    out.writeRawData(imageResources.constData(), imageResources.size());
+    return ret;
+}
+
+void tst_ImageDataToImage::thumbnail_data()
+{
+    QTest::addColumn<QList<quint16>>("resources");
+    QTest::addColumn<bool>("bgr");
+
+    QTest::newRow("RGB") << QList<quint16> { 1036 } << false;
+    QTest::newRow("BGR") << QList<quint16> { 1033 } << true;
+    QTest::newRow("RGB, BGR") << QList<quint16> { 1036, 1033 } << false;
+    QTest::newRow("BGR, RGB") << QList<quint16> { 1033, 1036 } << false;
+}
+
+// The RGB thumbnail is preferred over the BGR one, and either comes out of
+// thumbnailToImage() in RGB order
+void tst_ImageDataToImage::thumbnail()
+{
+    QFETCH(QList<quint16>, resources);
+    QFETCH(bool, bgr);
+
+    QByteArray document = thumbnailDocument(resources);
+    QBuffer buffer(&document);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    const QPsdThumbnail thumbnail = QPsdThumbnail::fromDevice(&buffer);
+    QVERIFY(thumbnail.isValid());
+    QCOMPARE(thumbnail.isBgr(), bgr);
+
+    const QImage image = QtPsdGui::thumbnailToImage(thumbnail);
+    QCOMPARE(image.size(), QSize(int(std::size(thumbnailPixels)), 1));
+    for (int x = 0; x < image.width(); ++x)
+        QCOMPARE(image.pixel(x, 0), thumbnailPixels[x]);
+}
+
 void tst_ImageDataToImage::generateImages_data()
 {
     if (!m_generateImagesEnabled) {
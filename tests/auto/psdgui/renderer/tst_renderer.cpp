@@ -0,0 +1,313 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtGui/QImage>
+#include <QtCore/QBuffer>
+#include <QtCore/QDataStream>
+#include <QtCore/QDirIterator>
+#include <QtPsdCore/QPsdParser>
+#include <QtPsdGui/QPsdAbstractLayerItem>
+#include <QtPsdGui/QPsdGuiLayerTreeItemModel>
+#include <QtPsdGui/QPsdRenderer>
+#include <QtTest/QtTest>
+
+#include <algorithm>
+
+using namespace Qt::Literals::StringLiterals;
+
+class tst_Renderer : public QObject
+{
+    Q_OBJECT
+private slots:
+    void emptyModel();
+    void clippingBase_data();
+    void clippingBase();
+    void tiling_data();
+    void tiling();
+    void matchesComposite_data();
+    void matchesComposite();
+
+private:
+    struct Features
+    {
+        // Clipping, raster or vector masks, fill opacity or adjustments
+        bool compositing = false;
+        // Layer effects, blur or fills the renderer leaves out
+        bool unsupported = false;
+    };
+    static void scan(const QPsdGuiLayerTreeItemModel &model, const QModelIndex &parent, Features *features);
+    static QByteArray clippingDocument(quint8 baseOpacity, quint8 baseFill);
+};
+
+void tst_Renderer::emptyModel()
+{
+    QPsdRenderer renderer;
+    QVERIFY(renderer.render().isNull());
+
+    QPsdGuiLayerTreeItemModel model;
+    renderer.setModel(&model);
+    QVERIFY(renderer.render().isNull());
+}
+
+// A 4x4 RGB document with an opaque red base layer and an opaque blue
+// layer clipped to it
+QByteArray tst_Renderer::clippingDocument(quint8 baseOpacity, quint8 baseFill)
+{
+    constexpr int size = 4;
+    constexpr int pixels = size * size;
+    const auto block = [](const char *key, quint32 value) {
+        QByteArray ret;
+        QDataStream out(&ret, QIODevice::WriteOnly);
+        out.writeRawData("8BIM", 4);
+        out.writeRawData(key, 4);
+        out << quint32(4) << value;
+        return ret;
+    };
+
+    QByteArray records;
+    QByteArray channels;
+    QDataStream recordsOut(&records, QIODevice::WriteOnly);
+    QDataStream channelsOut(&channels, QIODevice::WriteOnly);
+    // Bottom to top
+    const struct {
+        quint8 opacity;
+        quint8 fill;
+        quint8 clipping;
+        uchar color[3];
+    } layers[] = {
+        { baseOpacity, baseFill, 0, { 255, 0, 0 } },
+        { 255, 255, 1, { 0, 0, 255 } },
+    };
+    quint32 id = 1;
+    for (const auto &layer : layers) {
+        recordsOut << qint32(0) << qint32(0) << qint32(size) << qint32(size);
+        recordsOut << quint16(4);
+        for (qint16 channel : { -1, 0, 1, 2 })
+            recordsOut << channel << quint32(2 + pixels);
+        recordsOut.writeRawData("8BIMnorm", 8);
+        recordsOut << layer.opacity << layer.clipping << quint8(0) << quint8(0);
+        const QByteArray extra = QByteArray::fromHex("00000000" "00000000" "01610000")
+            + block("lyid", id++) + block("iOpa", quint32(layer.fill) << 24);
+        recordsOut << quint32(extra.size());
+        recordsOut.writeRawData(extra.constData(), extra.size());
+
+        channelsOut << quint16(0);
+        channelsOut.writeRawData(QByteArray(pixels, char(255)).constData(), pixels);
+        for (uchar value : layer.color) {
+            channelsOut << quint16(0);
+            channelsOut.writeRawData(QByteArray(pixels, char(value)).constData(), pixels);
+        }
+    }
+    QByteArray layerInfo;
+    QDataStream layerInfoOut(&layerInfo, QIODevice::WriteOnly);
+    layerInfoOut << qint16(std::size(layers));
+    layerInfoOut.writeRawData(records.constData(), records.size());
+    layerInfoOut.writeRawData(channels.constData(), channels.size());
+    if (layerInfo.size() % 2)
+        layerInfo.append('\0');
+
+    QByteArray ret;
+    QDataStream out(&ret, QIODevice::WriteOnly);
+    out.writeRawData("8BPS", 4);
+    out << quint16(1) << quint16(0) << quint32(0) << quint16(3)
+        << quint32(size) << quint32(size) << quint16(8) << quint16(QPsdFileHeader::RGB);
+    // Color mode data and image resources
+    out << quint32(0) << quint32(0);
+    out << quint32(4 + layerInfo.size() + 4) << quint32(layerInfo.size());
+    out.writeRawData(layerInfo.constData(), layerInfo.size());
+    // Global layer mask info
+    out << quint32(0);
+    out << quint16(0);
+    out.writeRawData(QByteArray(3 * pixels, char(0)).constData(), 3 * pixels);
+    return ret;
+}
+
+void tst_Renderer::clippingBase_data()
+{
+    QTest::addColumn<int>("baseOpacity");
+    QTest::addColumn<int>("baseFill");
+    QTest::addColumn<int>("alpha");
+
+    QTest::newRow("opaque") << 255 << 255 << 255;
+    QTest::newRow("opacity 50%") << 128 << 255 << 128;
+    QTest::newRow("fill 0%") << 255 << 0 << 255;
+    QTest::newRow("opacity 50%, fill 0%") << 128 << 0 << 128;
+}
+
+// The clipped layer covers its base and is faded with it by the opacity of
+// the base, but not by its fill opacity
+void tst_Renderer::clippingBase()
+{
+    QFETCH(int, baseOpacity);
+    QFETCH(int, baseFill);
+    QFETCH(int, alpha);
+
+    QByteArray document = clippingDocument(quint8(baseOpacity), quint8(baseFill));
+    QBuffer buffer(&document);
+    QVERIFY(buffer.open(QIODevice::ReadOnly));
+    QPsdParser parser;
+    parser.load(&buffer);
+    QPsdGuiLayerTreeItemModel model;
+    model.fromParser(parser);
+    QCOMPARE(model.size(), QSize(4, 4));
+    QCOMPARE(model.rowCount(), 2);
+    QVERIFY(model.clippingMaskIndex(model.index(0, 0)).isValid());
+
+    QPsdRenderer renderer(&model);
+    const QImage image = renderer.render();
+    QCOMPARE(image.size(), QSize(4, 4));
+    for (int y = 0; y < image.height(); ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(image.constScanLine(y));
+        for (int x = 0; x < image.width(); ++x) {
+            // Premultiplied blue
+            QVERIFY2(qRed(line[x]) <= 1 && qGreen(line[x]) <= 1
+                         && qAbs(qBlue(line[x]) - alpha) <= 1 && qAbs(qAlpha(line[x]) - alpha) <= 1,
+                     qPrintable(u"pixel %1,%2 is #%3"_s.arg(x).arg(y).arg(line[x], 8, 16, '0'_L1)));
+        }
+    }
+}
+
+void tst_Renderer::scan(const QPsdGuiLayerTreeItemModel &model, const QModelIndex &parent, Features *features)
+{
+    for (int row = 0; row < model.rowCount(parent); ++row) {
+        const QModelIndex index = model.index(row, 0, parent);
+        const QPsdAbstractLayerItem *layer = model.layerItem(index);
+        if (layer) {
+            if (model.clippingMaskIndex(index).isValid() || !layer->layerMask().isNull()
+                || layer->vectorMask().type != QPsdAbstractLayerItem::PathInfo::None
+                || layer->fillOpacity() < 1.0 || layer->type() == QPsdAbstractLayerItem::Adjustment) {
+                features->compositing = true;
+            }
+            if (!layer->effects().isEmpty() || !layer->dropShadow().isEmpty()
+                || !layer->innerShadow().isEmpty() || !layer->innerGlow().isEmpty()
+                || !layer->satin().isEmpty() || layer->layerBlur() > 0 || layer->border()
+                || layer->gradient() || layer->patternFill()) {
+                features->unsupported = true;
+            }
+        }
+        scan(model, index, features);
+    }
+}
+
+void tst_Renderer::tiling_data()
+{
+    QTest::addColumn<QString>("psd");
+
+    const QList<std::pair<QString, QString>> sources = {
+        {"ag-psd"_L1, QFINDTESTDATA("../../3rdparty/ag-psd/test/")},
+        {"psd-zoo"_L1, QFINDTESTDATA("../../3rdparty/psd-zoo/")},
+    };
+    QList<std::pair<QString, QString>> rows;
+    for (const auto &[id, root] : sources) {
+        if (root.isEmpty() || !QDir(root).exists())
+            continue;
+        QDirIterator it(root, QStringList() << "*.psd", QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext()) {
+            const QString filePath = it.next();
+            rows.append({id + "/"_L1 + QDir(root).relativeFilePath(filePath), filePath});
+        }
+    }
+    std::sort(rows.begin(), rows.end());
+
+    for (const auto &[name, filePath] : std::as_const(rows))
+        QTest::newRow(name.toUtf8().constData()) << filePath;
+}
+
+// Tiles composite the same pixels as a single pass over the whole canvas,
+// and a region is the same part of the full rendering
+void tst_Renderer::tiling()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser parser;
+    parser.load(psd);
+    QPsdGuiLayerTreeItemModel model;
+    model.fromParser(parser);
+    const QSize size = model.size();
+    if (size.isEmpty())
+        QSKIP("Empty canvas");
+
+    QPsdRenderer renderer(&model);
+    renderer.setTileSize(QSize());
+    const QImage whole = renderer.render();
+    QCOMPARE(whole.size(), size);
+    QCOMPARE(whole.format(), QImage::Format_ARGB32_Premultiplied);
+
+    renderer.setTileSize(QSize(61, 47));
+    QCOMPARE(renderer.render(), whole);
+
+    const QRect region(size.width() / 3, size.height() / 4,
+                       qMax(1, size.width() / 2), qMax(1, size.height() / 2));
+    QCOMPARE(renderer.render(region), whole.copy(region));
+}
+
+void tst_Renderer::matchesComposite_data()
+{
+    tiling_data();
+}
+
+// The rendering of documents that clip, mask, use fill opacity or adjust
+// matches the composite image Photoshop saved with them. Both are laid over
+// white and compared by the largest channel difference of each pixel: at
+// most 2% of the pixels may be more than 24 levels apart, which leaves room
+// for the composite being matted with white at translucent edges and for
+// Photoshop blending at a higher precision than the 8-bit layers.
+void tst_Renderer::matchesComposite()
+{
+    QFETCH(QString, psd);
+
+    QPsdParser parser;
+    parser.load(psd);
+    const auto header = parser.fileHeader();
+    if (header.colorMode() != QPsdFileHeader::RGB || header.depth() != 8)
+        QSKIP("Not an 8-bit RGB document");
+    QPsdGuiLayerTreeItemModel model;
+    model.fromParser(parser);
+    if (model.size().isEmpty())
+        QSKIP("Empty canvas");
+
+    Features features;
+    scan(model, QModelIndex(), &features);
+    if (!features.compositing)
+        QSKIP("Nothing but plain layers");
+    if (features.unsupported)
+        QSKIP("Layer effects, blur or fills");
+
+    const QImage merged = model.mergedImage().convertToFormat(QImage::Format_ARGB32);
+    QCOMPARE(merged.size(), model.size());
+    // Documents saved without maximized compatibility carry a blank composite
+    const QRgb first = merged.pixel(0, 0);
+    bool blank = true;
+    for (int y = 0; y < merged.height() && blank; ++y) {
+        const QRgb *line = reinterpret_cast<const QRgb *>(merged.constScanLine(y));
+        blank = std::all_of(line, line + merged.width(), [first](QRgb pixel) { return pixel == first; });
+    }
+    if (blank)
+        QSKIP("No composite image");
+
+    QPsdRenderer renderer(&model);
+    const QImage rendered = renderer.render().convertToFormat(QImage::Format_ARGB32);
+    QCOMPARE(rendered.size(), merged.size());
+
+    const auto overWhite = [](QRgb pixel, int channel) {
+        return (channel * qAlpha(pixel) + 255 * (255 - qAlpha(pixel)) + 127) / 255;
+    };
+    qint64 differing = 0;
+    for (int y = 0; y < merged.height(); ++y) {
+        const QRgb *e = reinterpret_cast<const QRgb *>(merged.constScanLine(y));
+        const QRgb *a = reinterpret_cast<const QRgb *>(rendered.constScanLine(y));
+        for (int x = 0; x < merged.width(); ++x) {
+            const int difference = qMax(qMax(qAbs(overWhite(e[x], qRed(e[x])) - overWhite(a[x], qRed(a[x]))),
+                                             qAbs(overWhite(e[x], qGreen(e[x])) - overWhite(a[x], qGreen(a[x])))),
+                                        qAbs(overWhite(e[x], qBlue(e[x])) - overWhite(a[x], qBlue(a[x]))));
+            if (difference > 24)
+                ++differing;
+        }
+    }
+    const qint64 pixels = qint64(merged.width()) * merged.height();
+    QVERIFY2(differing * 50 <= pixels,
+             qPrintable(u"%1 of %2 pixels differ from the composite"_s.arg(differing).arg(pixels)));
+}
+
+QTEST_GUILESS_MAIN(tst_Renderer)
+#include "tst_renderer.moc"
@@ -71,7 +71,7 @@ QImage tst_QPsdShapeInject::buildAndRender(const QSize &canvasSize, const QList<
         rec.setOpacity(255);
         rec.setFlags(0x00);
 
-        QHash<QByteArray, QVariant> ali;
+        QPsdFourCCMap ali;
         ali["lyid"] = spec.layerId;
         ali["luni"] = spec.name;
         ali["vscg"] = QVariant();
@@ -179,7 +179,7 @@ QImage tst_QPsdShapeInject::buildAndRenderWithFolders(const QSize &canvasSize, c
             QPsdLayerRecord closeRec;
             closeRec.setName(QByteArray("</Layer group>"));
             closeRec.setFlags(0x00);
-            QHash<QByteArray, QVariant> closeALI;
+            QPsdFourCCMap closeALI;
             QPsdSectionDividerSetting closeSetting;
             closeSetting.setType(QPsdSectionDividerSetting::BoundingSectionDivider);
             closeALI["lsdk"] = QVariant::fromValue(closeSetting);
@@ -196,7 +196,7 @@ QImage tst_QPsdShapeInject::buildAndRenderWithFolders(const QSize &canvasSize, c
             leafRec.setBlendMode(QPsdBlend::Normal);
             leafRec.setOpacity(255);
             leafRec.setFlags(0x00);
-            QHash<QByteArray, QVariant> leafALI;
+            QPsdFourCCMap leafALI;
             leafALI["lyid"] = spec.layerId;
             leafALI["luni"] = spec.name;
             leafALI["vscg"] = QVariant();
@@ -223,7 +223,7 @@ QImage tst_QPsdShapeInject::buildAndRenderWithFolders(const QSize &canvasSize, c
             folderRec.setBlendMode(QPsdBlend::Normal);
             folderRec.setOpacity(255);
             folderRec.setFlags(0x00);
-            QHash<QByteArray, QVariant> folderALI;
+            QPsdFourCCMap folderALI;
             folderALI["lyid"] = folder.layerId;
             folderALI["luni"] = folder.name;
             QPsdSectionDividerSetting folderSetting;
@@ -34,6 +34,8 @@ private slots:
     void writeFileHeader();
     void writeEmptyPsd();
     void writeMinimalPsd();
+    void packBitsRoundTrip_data();
+    void packBitsRoundTrip();
     void roundTrip_data();
     void roundTrip();
     void roundTripFull_data();
@@ -42,6 +44,10 @@ private slots:
     void aliCoverage();
     void binaryRoundTrip_data();
     void binaryRoundTrip();
+    void binaryRoundTripMapped_data();
+    void binaryRoundTripMapped();
+    void saveOverMappedSource_data();
+    void saveOverMappedSource();
     void visualRoundTrip_data();
     void visualRoundTrip();
     void photoshopSimilarity_data();
@@ -223,6 +229,41 @@ void tst_QPsdWriter::writeMinimalPsd()
     QCOMPARE(parser.imageData().imageData(), compositeData);
 }
 
+void tst_QPsdWriter::packBitsRoundTrip_data()
+{
+    QTest::addColumn<QByteArray>("rawData");
+    QTest::addColumn<int>("rowWidth");
+    QTest::addColumn<int>("height");
+
+    QTest::newRow("empty") << QByteArray() << 0 << 0;
+    QTest::newRow("single") << QByteArray(1, 'x') << 1 << 1;
+    QTest::newRow("repeat") << QByteArray(600, '\x7f') << 300 << 2;
+
+    QByteArray literal(1000, Qt::Uninitialized);
+    for (int i = 0; i < literal.size(); ++i)
+        literal[i] = char(i * 7 + i / 3);
+    QTest::newRow("literal") << literal << 250 << 4;
+
+    QByteArray mixed;
+    for (int i = 0; i < 64; ++i) {
+        mixed.append(QByteArray(i % 5 + 1, char(i)));
+        mixed.append(literal.mid(i, i % 17));
+    }
+    const int mixedWidth = 97;
+    mixed.resize(mixed.size() - mixed.size() % mixedWidth);
+    QTest::newRow("mixed") << mixed << mixedWidth << int(mixed.size() / mixedWidth);
+}
+
+void tst_QPsdWriter::packBitsRoundTrip()
+{
+    QFETCH(QByteArray, rawData);
+    QFETCH(int, rowWidth);
+    QFETCH(int, height);
+
+    const QByteArray encoded = QPsdSection::encodePackBits(rawData, rowWidth, height);
+    QCOMPARE(QPsdSection::decodePackBits(encoded, height), rawData);
+}
+
 void tst_QPsdWriter::roundTrip_data()
 {
     QTest::addColumn<QString>("psd");
@@ -398,10 +439,10 @@ void tst_QPsdWriter::aliCoverage()
     QMap<QByteArray, int> failedKeys;
 
     // Helper lambda to process an ALI hash
-    const auto processAli = [&](const QHash<QByteArray, QVariant> &ali) {
+    const auto processAli = [&](const QPsdFourCCMap &ali) {
         for (auto it = ali.cbegin(); it != ali.cend(); ++it) {
             ++totalEntries;
-            const QByteArray &key = it.key();
+            const QByteArray key = it.key().toByteArray();
             const QVariant &value = it.value();
 
             if (value.typeId() == QMetaType::QByteArray) {
@@ -837,6 +878,79 @@ void tst_QPsdWriter::binaryRoundTrip()
     QCOMPARE(writtenBytes, originalBytes);
 }
 
+void tst_QPsdWriter::binaryRoundTripMapped_data()
+{
+    binaryRoundTrip_data();
+}
+
+void tst_QPsdWriter::binaryRoundTripMapped()
+{
+    QFETCH(QString, psd);
+
+    QFile originalFile(psd);
+    QVERIFY(originalFile.open(QIODevice::ReadOnly));
+    const QByteArray originalBytes = originalFile.readAll();
+    originalFile.close();
+
+    // Raw payloads of a mapped document refer to the file instead of
+    // holding copies; they are copied file to file or from the mapping
+    QPsdParser parser;
+    parser.load(psd, QPsdParser::MemoryMapped);
+
+    QPsdWriter writer;
+    writer.setFileHeader(parser.fileHeader());
+    writer.setColorModeData(parser.colorModeData());
+    writer.setImageResources(parser.imageResources());
+    writer.setLayerAndMaskInformation(parser.layerAndMaskInformation());
+    writer.setImageData(parser.imageData());
+
+    QTemporaryFile tmpFile;
+    QVERIFY(tmpFile.open());
+    QVERIFY2(writer.write(&tmpFile), qPrintable(writer.errorString()));
+    QVERIFY(tmpFile.seek(0));
+    QCOMPARE(tmpFile.readAll(), originalBytes);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    QVERIFY2(writer.write(&buffer), qPrintable(writer.errorString()));
+    QCOMPARE(buffer.data(), originalBytes);
+}
+
+void tst_QPsdWriter::saveOverMappedSource_data()
+{
+    binaryRoundTrip_data();
+}
+
+void tst_QPsdWriter::saveOverMappedSource()
+{
+    QFETCH(QString, psd);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(u"source.psd"_s);
+    QVERIFY(QFile::copy(psd, path));
+    QFile originalFile(path);
+    QVERIFY(originalFile.open(QIODevice::ReadOnly));
+    const QByteArray originalBytes = originalFile.readAll();
+    originalFile.close();
+
+    // The payloads still refer to the mapped file while it is replaced
+    QPsdParser parser;
+    parser.load(path, QPsdParser::MemoryMapped);
+
+    QPsdWriter writer;
+    writer.setFileHeader(parser.fileHeader());
+    writer.setColorModeData(parser.colorModeData());
+    writer.setImageResources(parser.imageResources());
+    writer.setLayerAndMaskInformation(parser.layerAndMaskInformation());
+    writer.setImageData(parser.imageData());
+    QVERIFY2(writer.write(path), qPrintable(writer.errorString()));
+
+    QFile writtenFile(path);
+    QVERIFY(writtenFile.open(QIODevice::ReadOnly));
+    QCOMPARE(writtenFile.readAll(), originalBytes);
+}
+
 void tst_QPsdWriter::writeReport_data()
 {
     QTest::addColumn<QString>("psd");
@@ -0,0 +1,162 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtPsdCore/QPsdChannelImageData>
+#include <QtPsdCore/QPsdChannelInfo>
+#include <QtPsdCore/QPsdFileHeader>
+#include <QtPsdCore/QPsdImageData>
+#include <QtPsdCore/QPsdLayerAndMaskInformation>
+#include <QtPsdCore/QPsdLayerInfo>
+#include <QtPsdCore/QPsdLayerRecord>
+#include <QtPsdCore/QPsdLayerTreeItemModel>
+#include <QtPsdCore/QPsdParser>
+#include <QtPsdCore/QPsdSectionDividerSetting>
+#include <QtPsdWriter/QPsdWriter>
+#include <QtTest/QtTest>
+
+#include <QtCore/QBuffer>
+
+class tst_bench_LayerTreeItemModel : public QObject
+{
+    Q_OBJECT
+private slots:
+    void walk_data();
+    void walk();
+};
+
+// An empty layer, or the top or bottom end of a group
+static void appendRecord(QList<QPsdLayerRecord> &records, const QString &name,
+                         QPsdSectionDividerSetting::Type type = QPsdSectionDividerSetting::AnyOtherTypeOfLayer)
+{
+    QPsdLayerRecord record;
+    record.setRect(QRect(0, 0, 0, 0));
+    QList<QPsdChannelInfo> channelInfos;
+    for (auto id : {QPsdChannelInfo::TransparencyMask, QPsdChannelInfo::Red,
+                    QPsdChannelInfo::Green, QPsdChannelInfo::Blue}) {
+        QPsdChannelInfo ci;
+        ci.setId(id);
+        ci.setLength(2);
+        channelInfos.append(ci);
+    }
+    record.setChannelInfo(channelInfos);
+    record.setBlendMode(QPsdBlend::Normal);
+    record.setOpacity(255);
+    record.setName(name.toUtf8());
+
+    QPsdFourCCMap ali;
+    ali.insert("luni", name);
+    ali.insert("lyid", quint32(records.size() + 1));
+    if (type != QPsdSectionDividerSetting::AnyOtherTypeOfLayer) {
+        QPsdSectionDividerSetting sds;
+        sds.setType(type);
+        ali.insert("lsct", QVariant::fromValue(sds));
+    }
+    record.setAdditionalLayerInformation(ali);
+
+    QPsdChannelImageData emptyData;
+    emptyData.setWidth(0);
+    emptyData.setHeight(0);
+    record.setImageData(emptyData);
+    records.append(record);
+}
+
+// Appends groups of fanOut children, nested depth levels deep, bottom
+// layer first as in the file
+static void appendLayers(QList<QPsdLayerRecord> &records, int fanOut, int depth)
+{
+    for (int i = 0; i < fanOut; ++i) {
+        if (depth > 0) {
+            appendRecord(records, u"</Layer group>"_s, QPsdSectionDividerSetting::BoundingSectionDivider);
+            appendLayers(records, fanOut, depth - 1);
+            appendRecord(records, u"Group"_s, QPsdSectionDividerSetting::OpenFolder);
+        } else {
+            appendRecord(records, u"Layer"_s);
+        }
+    }
+}
+
+static QByteArray createDocument(int fanOut, int depth)
+{
+    QPsdFileHeader header;
+    header.setChannels(3);
+    header.setWidth(1);
+    header.setHeight(1);
+    header.setDepth(8);
+    header.setColorMode(QPsdFileHeader::RGB);
+
+    QList<QPsdLayerRecord> records;
+    appendLayers(records, fanOut, depth);
+    QList<QPsdChannelImageData> channelDataList;
+    for (const auto &record : records)
+        channelDataList.append(record.imageData());
+
+    QPsdLayerInfo layerInfo;
+    layerInfo.setRecords(records);
+    layerInfo.setChannelImageData(channelDataList);
+    QPsdLayerAndMaskInformation lmi;
+    lmi.setLayerInfo(layerInfo);
+
+    QPsdImageData imageData;
+    imageData.setWidth(1);
+    imageData.setHeight(1);
+    imageData.setImageData(QByteArray(3, '\0'));
+
+    QPsdWriter writer;
+    writer.setFileHeader(header);
+    writer.setLayerAndMaskInformation(lmi);
+    writer.setImageData(imageData);
+
+    QBuffer buffer;
+    buffer.open(QIODevice::WriteOnly);
+    if (!writer.write(&buffer))
+        qWarning() << writer.errorString();
+    return buffer.data();
+}
+
+void tst_bench_LayerTreeItemModel::walk_data()
+{
+    QTest::addColumn<QByteArray>("document");
+    QTest::addColumn<int>("layers");
+
+    // About 3000 layers each, the size of a large UI design file
+    QTest::newRow("flat") << createDocument(3000, 0) << 3000;
+    // 14 + 14^2 groups with 14^3 layers in the innermost ones
+    QTest::newRow("nested") << createDocument(14, 2) << 14 * 14 * 14 + 14 + 14 * 14;
+}
+
+void tst_bench_LayerTreeItemModel::walk()
+{
+    QFETCH(QByteArray, document);
+    QFETCH(int, layers);
+
+    QBuffer buffer(&document);
+    buffer.open(QIODevice::ReadOnly);
+    QPsdParser parser;
+    parser.load(&buffer);
+
+    QPsdLayerTreeItemModel model;
+    model.fromParser(parser);
+
+    // What a QTreeView with every folder expanded, or an exporter, does:
+    // visit every row and look its parent up again
+    int visited = 0;
+    std::function<void(const QModelIndex &)> walk = [&](const QModelIndex &parent) {
+        const int rowCount = model.rowCount(parent);
+        for (int row = 0; row < rowCount; ++row) {
+            const QModelIndex index = model.index(row, 0, parent);
+            if (model.parent(index) != parent)
+                qFatal("Inconsistent parent");
+            ++visited;
+            walk(index);
+        }
+    };
+
+    QBENCHMARK {
+        visited = 0;
+        walk(QModelIndex());
+    }
+    QCOMPARE(visited, layers);
+}
+
+QTEST_MAIN(tst_bench_LayerTreeItemModel)
+#include "tst_bench_layertreeitemmodel.moc"
@@ -0,0 +1,57 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtPsdCore/QPsdSection>
+#include <QtTest/QtTest>
+
+class tst_bench_PackBits : public QObject
+{
+    Q_OBJECT
+private slots:
+    void decode_data();
+    void decode();
+};
+
+void tst_bench_PackBits::decode_data()
+{
+    QTest::addColumn<QByteArray>("rawData");
+    QTest::addColumn<int>("rowWidth");
+
+    // One 4096x4096 channel for each shape of data PackBits has to deal with
+    constexpr int width = 4096;
+    constexpr int height = 4096;
+
+    QTest::newRow("flat") << QByteArray(width * height, '\x80') << width;
+
+    QByteArray noise(width * height, Qt::Uninitialized);
+    quint32 seed = 1;
+    for (auto &c : noise) {
+        seed = seed * 1664525 + 1013904223;
+        c = char(seed >> 24);
+    }
+    QTest::newRow("noise") << noise << width;
+
+    // Short runs mixed with literals, like antialiased artwork
+    QByteArray mixed(width * height, Qt::Uninitialized);
+    for (int i = 0; i < mixed.size(); ++i)
+        mixed[i] = (i / 8) % 3 ? char(i / 24) : noise.at(i);
+    QTest::newRow("mixed") << mixed << width;
+}
+
+void tst_bench_PackBits::decode()
+{
+    QFETCH(QByteArray, rawData);
+    QFETCH(int, rowWidth);
+
+    const int height = rawData.size() / rowWidth;
+    const QByteArray encoded = QPsdSection::encodePackBits(rawData, rowWidth, height);
+
+    QByteArray decoded;
+    QBENCHMARK {
+        decoded = QPsdSection::decodePackBits(encoded, height);
+    }
+    QCOMPARE(decoded.size(), rawData.size());
+}
+
+QTEST_MAIN(tst_bench_PackBits)
+#include "tst_bench_packbits.moc"
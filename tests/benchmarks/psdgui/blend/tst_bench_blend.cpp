@@ -0,0 +1,83 @@
+// Copyright (C) 2026 Signal Slot Inc.
+// SPDX-License-Identifier: LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include <QtGui/QImage>
+#include <QtPsdCore/qpsdblend.h>
+#include <QtPsdGui/private/qpsdguiglobal_p.h>
+#include <QtTest/QtTest>
+
+class tst_bench_Blend : public QObject
+{
+    Q_OBJECT
+private slots:
+    void initTestCase();
+    void customBlend_data();
+    void customBlend();
+    void customBlendReference_data();
+    void customBlendReference();
+
+private:
+    QImage m_src;
+    QImage m_dst;
+};
+
+// A 4K layer with soft edges and holes, over an opaque backdrop
+static QImage layerImage(int width, int height, bool opaque)
+{
+    QImage image(width, height, QImage::Format_ARGB32_Premultiplied);
+    quint32 seed = opaque ? 2 : 1;
+    for (int y = 0; y < height; ++y) {
+        auto *line = reinterpret_cast<QRgb *>(image.scanLine(y));
+        for (int x = 0; x < width; ++x) {
+            seed = seed * 1664525 + 1013904223;
+            const int alpha = opaque ? 255 : qBound(0, 255 - qAbs(x - width / 2) * 255 / (width / 3), 255);
+            line[x] = qPremultiply(qRgba(seed >> 24, (seed >> 16) & 0xff, (seed >> 8) & 0xff, alpha));
+        }
+    }
+    return image;
+}
+
+void tst_bench_Blend::initTestCase()
+{
+    m_src = layerImage(3840, 2160, false);
+    m_dst = layerImage(3840, 2160, true);
+}
+
+void tst_bench_Blend::customBlend_data()
+{
+    QTest::addColumn<int>("mode");
+
+    for (int mode = QPsdBlend::Normal; mode <= QPsdBlend::Luminosity; ++mode)
+        QTest::addRow("%s", QPsdBlend::toKey(QPsdBlend::Mode(mode)).constData()) << mode;
+}
+
+void tst_bench_Blend::customBlend()
+{
+    QFETCH(int, mode);
+
+    QImage dst;
+    QBENCHMARK {
+        // Every run blends onto the same backdrop
+        dst = m_dst.copy();
+        QtPsdGui::customBlend(dst, m_src, QPsdBlend::Mode(mode), 0.8);
+    }
+}
+
+void tst_bench_Blend::customBlendReference_data()
+{
+    customBlend_data();
+}
+
+void tst_bench_Blend::customBlendReference()
+{
+    QFETCH(int, mode);
+
+    QImage dst;
+    QBENCHMARK {
+        dst = m_dst.copy();
+        QtPsdGui::customBlendReference(dst, m_src, QPsdBlend::Mode(mode), 0.8);
+    }
+}
+
+QTEST_MAIN(tst_bench_Blend)
+#include "tst_bench_blend.moc"